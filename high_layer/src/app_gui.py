@@ -2,13 +2,13 @@
 import os
 import threading
 import subprocess
+import json
 import tkinter as tk
 from tkinter import filedialog, messagebox
-from collections import defaultdict
 import customtkinter as ctk
 
 from config import *
-from gantt_chart import ScrollableGanttFrame
+from gantt_chart import ScrollableGanttFrame, GanttFrameDecoder
 from validator import validate_file_content
 
 class PFSPGui(ctk.CTk):
@@ -27,7 +27,7 @@ class PFSPGui(ctk.CTk):
         self.param_vars = {}
         self.proc = None
         self.lock = threading.Lock()
-        self.slots_by_iter = defaultdict(list)
+        self.frames = GanttFrameDecoder()
         
         self._setup_ui()
         self._update_params_ui()
@@ -95,6 +95,7 @@ class PFSPGui(ctk.CTk):
         
         algo = self.method_var.get(); warning, reasons = False, []
         if "NEH" in algo and n > 800: warning = True; reasons.append(f"- Faza NEH: Duża liczba zadań ({n}).")
+        if "Branch and Bound" in algo and n > 14: warning = True; reasons.append(f"- Faza B&B: dokładne przeszukiwanie dla {n} zadań może trwać bardzo długo.")
         if "Simulated Annealing" in algo:
             try:
                 it = int(self.param_vars.get("Iteracje", self.param_vars.get("SA Iteracje", tk.StringVar(value="0"))).get())
@@ -104,38 +105,53 @@ class PFSPGui(ctk.CTk):
 
         cmd = [self.executable_path, path]
         for p in ALGO_SCHEMAS[algo]: cmd.append(self.param_vars[p[0]].get())
+        cmd += ["--telemetry=json", "--keyframe=20", "--stdin-control"]
         
         self.log_text.delete("1.0", "end"); self.cmax_var.set("Cmax: —"); self.seq_var.set("Kolejność: —")
-        with self.lock: self.slots_by_iter.clear()
+        with self.lock: self.frames.reset()
         self.gantt_container._show_placeholder(); self.status_var.set("Trwają obliczenia...")
         threading.Thread(target=self._read_output, args=(cmd,), daemon=True).start()
 
     def _read_output(self, cmd):
         try:
-            self.proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True, bufsize=1)
+            self.proc = subprocess.Popen(cmd, stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True, bufsize=1)
             for line in iter(self.proc.stdout.readline, ''):
+                if line.startswith("{"):
+                    line = self._handle_event(line)
+                    if line is None: continue
                 self.after(0, lambda l=line: (self.log_text.insert("end", l), self.log_text.see("end")))
                 if "final best sequence:" in line.lower():
                     s = line.split(":")[-1].strip(); self.after(0, lambda seq=s: self.seq_var.set(f"Kolejność: {seq}"))
-                if line.startswith("SLOT;"): self._parse_slot(line)
-                elif line.startswith("FRAME_END;"): self._render_gantt()
+                if line.startswith(("SLOT", "FRAME_END;")):
+                    with self.lock: slots = self.frames.feed_line(line)
+                    if slots: self._render_gantt(slots)
                 elif "makespan:" in line.lower():
                     v = line.split(":")[-1].strip(); self.after(0, lambda val=v: self.cmax_var.set(f"Cmax: {val}"))
             self.proc.wait(); self.after(0, lambda: self.status_var.set("Zakończono"))
         except Exception as e: self.after(0, lambda: messagebox.showerror("Błąd", str(e)))
 
-    def _parse_slot(self, line):
-        try:
-            p = {i.split('=')[0]: i.split('=')[1] for i in line.strip().split(';') if '=' in i}
-            s = {'m': int(p['machine']), 'j': int(p['job']), 's': float(p['start']), 'e': float(p['end']), 'setup': float(p['setup'])}
-            with self.lock: self.slots_by_iter[int(p.get('iter', 0))].append(s)
-        except: pass
+    def _handle_event(self, line):
+        # Zdarzenie JSON z solvera; zwraca linię do logu albo None (ramka harmonogramu)
+        try: ev = json.loads(line)
+        except ValueError: return line
+        kind = ev.get("type")
+        if kind == "frame":
+            with self.lock: slots = self.frames.feed_event(ev)
+            if slots: self._render_gantt(slots)
+            return None
+        if kind == "log": return ev["text"] + "\n"
+        if kind == "neh_progress": return f"NEH_PROGRESS;iter={ev['iter']};cmax={ev['cmax']}\n"
+        if kind == "result":
+            chain = f";chain={ev['chain']}" if "chain" in ev else ""
+            return f"RESULT;iter={ev['iter']};cmax={ev['cmax']}{chain}\n"
+        return line
 
-    def _render_gantt(self):
-        with self.lock:
-            if not self.slots_by_iter: return
-            slots = list(self.slots_by_iter[max(self.slots_by_iter.keys())])
+    def _render_gantt(self, slots):
         self.after(0, lambda: self.gantt_container.update_plot(slots))
 
     def _stop_solver(self):
-        if self.proc: self.proc.terminate(); self.status_var.set("Zatrzymano")
\ No newline at end of file
+        # Solver kończy obliczenia i wypisuje najlepszy dotychczasowy wynik (SIGTERM działa tak samo)
+        if not self.proc or self.proc.poll() is not None: return
+        try: self.proc.stdin.write("stop\n"); self.proc.stdin.flush()
+        except OSError: self.proc.terminate()
+        self.status_var.set("Zatrzymywanie...")
\ No newline at end of file
@@ -22,5 +22,30 @@ ALGO_SCHEMAS = {
         ("SA Iteracje", "int", 25000),
         ("SA T Start", "float", 80.0),
         ("SA Chłodzenie", "float", 0.995),
+    ],
+    "NEH + Iterated Greedy": [
+        ("Typ", "fixed", "neh"),
+        ("Dodatek", "fixed", "iterated_greedy"),
+        ("IG Iteracje", "int", 2000),
+        ("IG Usuwane zadania", "int", 4),
+        ("IG Temperatura", "float", 0.4),
+    ],
+    "NEH + Simulated Annealing + Local Search": [
+        ("Typ", "fixed", "neh"),
+        ("Dodatek", "fixed", "simulated_annealing"),
+        ("SA Iteracje", "int", 25000),
+        ("SA T Start", "float", 80.0),
+        ("SA Chłodzenie", "float", 0.995),
+        ("Poprawa", "fixed", "local_search"),
+        ("LS Sąsiedztwo", "str", "insertion"),
+        ("LS Strategia", "str", "first"),
+    ],
+    "Dokładny (NEH + Simulated Annealing + Branch and Bound)": [
+        ("Typ", "fixed", "neh"),
+        ("Dodatek", "fixed", "simulated_annealing"),
+        ("SA Iteracje", "int", 20000),
+        ("SA T Start", "float", 80.0),
+        ("SA Chłodzenie", "float", 0.995),
+        ("Dokładny", "fixed", "branch_and_bound"),
     ]
 }
\ No newline at end of file
@@ -7,6 +7,52 @@ from matplotlib.backends.backend_tkagg import FigureCanvasTkAgg
 from matplotlib.figure import Figure
 from config import *
 
+class GanttFrameDecoder:
+    """Składa ramki harmonogramu z solvera (pełne i różnicowe, tekst lub JSON) w listę slotów dla update_plot.
+    Sloty trzymane są jako rows[maszyna][pozycja]; ramka różnicowa podmienia tylko zmienione pozycje."""
+    def __init__(self):
+        self.rows = None
+        self._key, self._changes = [], []
+
+    def reset(self):
+        self.rows = None; self._key, self._changes = [], []
+
+    @staticmethod
+    def _slot(m, j, s, e, setup):
+        return {'m': int(m), 'j': int(j), 's': float(s), 'e': float(e), 'setup': float(setup)}
+
+    def _apply_key(self, slots):
+        self.rows = {}
+        for s in slots: self.rows.setdefault(s['m'], []).append(s)
+
+    def _apply_changes(self, changes):
+        if self.rows is None: return False  # brak ramki kluczowej - czekamy na następną
+        for m, pos, s in changes: self.rows[m][pos] = s
+        return True
+
+    def slots(self):
+        return [s for m in sorted(self.rows) for s in self.rows[m]] if self.rows else []
+
+    def feed_event(self, ev):
+        """Zdarzenie {"type":"frame",...}; zwraca aktualne sloty albo None."""
+        if ev.get("key", True): self._apply_key([self._slot(*s) for s in ev["slots"]])
+        elif not self._apply_changes([(c[0], c[1], self._slot(c[0], *c[2:])) for c in ev["changes"]]): return None
+        return self.slots()
+
+    def feed_line(self, line):
+        """Linia SLOT;/SLOT_DELTA;/FRAME_END;; zwraca sloty po zakończeniu ramki, inaczej None."""
+        if not line.startswith(("SLOT;", "SLOT_DELTA;", "FRAME_END;")): return None
+        p = {i.split('=')[0]: i.split('=')[1] for i in line.strip().split(';') if '=' in i}
+        if line.startswith("SLOT;"):
+            self._key.append(self._slot(p['machine'], p['job'], p['start'], p['end'], p['setup']))
+        elif line.startswith("SLOT_DELTA;"):
+            self._changes.append((int(p['machine']), int(p['pos']), self._slot(p['machine'], p['job'], p['start'], p['end'], p['setup'])))
+        else:
+            ok = self._apply_changes(self._changes) if p.get('delta') == '1' else (self._apply_key(self._key) or True)
+            self._key, self._changes = [], []
+            return self.slots() if ok else None
+        return None
+
 class ScrollableGanttFrame(ctk.CTkFrame):
     def __init__(self, parent, **kwargs):
         super().__init__(parent, **kwargs)
@@ -1,9 +1,27 @@
 # validator.py
 import os
+import sys
+
+# Moduł natywny (low_layer: make python) - instancja wczytywana parserem solvera, bez analizy w Pythonie
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../../low_layer/bin"))
+try:
+    import pfsp
+except ImportError:
+    pfsp = None
 
 def validate_file_content(path):
     """Rygorystyczne sprawdzanie poprawności formatu pliku."""
     if not os.path.isfile(path): return False, "Błąd ścieżki.", 0, 0
+    if pfsp is not None:
+        try:
+            instance = pfsp.Instance(path)
+            if instance.jobs > 0 and instance.machines > 0:
+                return True, "", instance.jobs, instance.machines
+        except ValueError:
+            pass  # szczegółowy komunikat z analizy poniżej
+    return _validate_text(path)
+
+def _validate_text(path):
     try:
         n, m = 0, 0
         has_proc_time = False
@@ -1,6 +1,13 @@
 #pragma once
 #include <string>
 #include "Controller.hpp"
+#include "RunOptions.hpp"
+#include "BatchRunner.hpp"
+#include "SolverServer.hpp"
+#include "PortfolioRunner.hpp"
+#include "DistributedWorker.hpp"
+#include "../core/Telemetry.hpp"
+#include "../core/Profiler.hpp"
 #include <iostream>
 
 class Application
@@ -15,27 +22,167 @@ public:
 
     int run()
     {
-        std::cout << "Data file: " << instancePath << std::endl;
-        std::cout << "Algorithms: ";
-        for (size_t i = 0; i < algorithms.size(); ++i)
+        RunOptions options;
+        try
+        {
+            options = extractOptions(algorithms);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+
+        if (options.profile)
+            Profiler::get().enable(!options.profileTrace.empty());
+        int status = runMode(options);
+        if (options.profile)
+            reportProfile(options);
+        return status;
+    }
+
+private:
+    int runMode(const RunOptions &options)
+    {
+        if (!options.worker.empty())
+            return runWorker(options);
+        if (!options.batch.empty())
+            return runBatch(options);
+        if (!options.serve.empty())
+            return runServer(options);
+
+        if (instancePath.empty())
         {
-            if (i)
-                std::cout << ",";
-            std::cout << algorithms[i];
+            std::cerr << "Error: missing data file" << std::endl;
+            return 1;
+        }
+
+        if (!options.convert.empty())
+            return runConvert(options);
+
+        // Cały postęp solvera idzie przez wątek telemetrii
+        TelemetryScope telemetry(options.telemetry == "json" ? Telemetry::Format::Json : Telemetry::Format::Text,
+                                 options.frameInterval, options.keyframeInterval);
+
+        // Ctrl+C / SIGTERM / "stop" kończą obliczenia z dotychczas najlepszym wynikiem
+        Cancellation::installSignalHandlers();
+        if (options.stdinControl)
+            Cancellation::listenOnStdin();
+
+        LogLine() << "Data file: " << instancePath;
+        {
+            LogLine line;
+            line << "Algorithms: ";
+            for (size_t i = 0; i < algorithms.size(); ++i)
+            {
+                if (i)
+                    line << ",";
+                line << algorithms[i];
+            }
         }
-        std::cout << std::endl;
 
         try
         {
-            Controller controller(instancePath, algorithms);
-            controller.execute();
+            // Tokeny algorytmów w trybie portfolio to potoki (jak w trybie wsadowym)
+            if (options.portfolio)
+            {
+                PortfolioRunner portfolio(options, instancePath, algorithms);
+                return portfolio.run();
+            }
+            Controller controller(instancePath, algorithms, options);
+            if (!controller.execute())
+                return 1;
         }
         catch (const std::exception &e)
         {
+            Telemetry::get().flush();
             std::cerr << "Error: " << e.what() << std::endl;
             return 1;
         }
 
         return 0;
     }
+
+    // Raport na stderr (stdout należy do strumienia telemetrii / wyników wsadowych)
+    void reportProfile(const RunOptions &options)
+    {
+        Profiler::get().report(std::cerr);
+        if (!Profiler::compiledIn)
+            std::cerr << "Warning: --profile ignored (built with PROFILE=0)" << std::endl;
+        else if (!options.profileTrace.empty())
+        {
+            if (Profiler::get().writeTrace(options.profileTrace))
+                std::cerr << "Profile trace written to: " << options.profileTrace << std::endl;
+            else
+                std::cerr << "Error: cannot write file " << options.profileTrace << std::endl;
+        }
+    }
+
+    // Tekst -> format binarny (mapowany później bez parsowania)
+    int runConvert(const RunOptions &options)
+    {
+        const std::string &outputPath = options.convert;
+        Instance instance(instancePath);
+        instance.setStorageOptions(SetupLayout::PrevJobMajor, options.setupEncoding, false);
+        if (!instance.loadFromFile() || !instance.saveBinary(outputPath))
+            return 1;
+        std::cout << "Binary instance written to: " << outputPath << " (setup "
+                  << instance.getSetupMatrix().bytes() / 1024 << " KiB)" << std::endl;
+        return 0;
+    }
+
+    // Zlecenia JSON na stdin albo gnieździe Unix; zdarzenia solverów idą do klientów, nie na stdout
+    int runServer(const RunOptions &options)
+    {
+        if (!algorithms.empty())
+        {
+            std::cerr << "Error: algorithms are given per request in server mode" << std::endl;
+            return 1;
+        }
+        try
+        {
+            SolverServer server(options);
+            return server.run(options.serve);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    // Zadania od koordynatora (--coordinator w trybie --batch albo --portfolio)
+    int runWorker(const RunOptions &options)
+    {
+        if (!algorithms.empty())
+        {
+            std::cerr << "Error: pipelines are sent by the coordinator in worker mode" << std::endl;
+            return 1;
+        }
+        try
+        {
+            DistributedWorker worker(options);
+            return worker.run(options.worker);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    // Pozostałe tokeny traktowane są jako potoki, np. neh+simulated_annealing:25000:80:0.995
+    int runBatch(const RunOptions &options)
+    {
+        try
+        {
+            BatchRunner runner(options, algorithms);
+            return runner.run();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
 };
@@ -0,0 +1,431 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <stdexcept>
+#include "../core/Instance.hpp"
+#include "../core/ThreadPool.hpp"
+#include "DistributedCoordinator.hpp"
+#include "Pipeline.hpp"
+#include "RunOptions.hpp"
+
+// Tryb wsadowy: (instancja x potok x ziarno) na puli wątków, jedna tabela wyników.
+// Każda instancja jest wczytywana raz (przy pierwszym zadaniu) i zwalniana po ostatnim.
+// Zadania startują od najdroższych (LPT), żeby duże instancje nie zostawały na koniec.
+// Z --coordinator / --spawn-workers zadania liczą procesy workerów; tabela wyników jest ta sama.
+class BatchRunner
+{
+private:
+    struct InstanceSlot
+    {
+        std::string path;
+        int jobs = 0;
+        int machines = 0;
+        std::mutex mtx;
+        bool loaded = false;
+        std::shared_ptr<const Instance> instance;
+        std::atomic<int> remaining{0};
+    };
+
+    struct Task
+    {
+        int slot;
+        int pipeline;
+        int seed;
+        double cost;
+    };
+
+    struct Row
+    {
+        std::string instance;
+        int jobs = 0;
+        int machines = 0;
+        std::string pipeline;
+        int seed = 0;
+        std::string status = "ok";
+        PipelineResult result;
+    };
+
+    RunOptions options;
+    std::vector<Pipeline> pipelines;
+
+public:
+    BatchRunner(const RunOptions &runOptions, const std::vector<std::string> &pipelineSpecs) : options(runOptions)
+    {
+        for (const auto &spec : pipelineSpecs)
+            pipelines.push_back(parsePipeline(spec));
+        if (pipelines.empty())
+            pipelines.push_back(parsePipeline("neh"));
+    }
+
+    int run()
+    {
+        auto files = resolveInputs(options.batch);
+        if (files.empty())
+            throw std::runtime_error("no instance files match " + options.batch);
+
+        std::vector<std::unique_ptr<InstanceSlot>> slots;
+        for (const auto &f : files)
+        {
+            slots.push_back(std::make_unique<InstanceSlot>());
+            slots.back()->path = f;
+            peekDimensions(f, slots.back()->jobs, slots.back()->machines);
+        }
+
+        std::vector<Task> tasks;
+        for (int s = 0; s < (int)slots.size(); ++s)
+            for (int p = 0; p < (int)pipelines.size(); ++p)
+            {
+                int seedCount = pipelines[p].randomized() ? options.seeds : 1;
+                for (int k = 0; k < seedCount; ++k)
+                    tasks.push_back({s, p, options.seed + k, estimateCost(*slots[s], pipelines[p])});
+                slots[s]->remaining += seedCount;
+            }
+
+        std::vector<Row> rows(tasks.size());
+        std::vector<int> order(tasks.size());
+        for (int i = 0; i < (int)order.size(); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b)
+                         { return tasks[a].cost > tasks[b].cost; });
+
+        bool distributed = DistributedCoordinator::requested(options);
+        std::cout << "Batch: " << files.size() << " instances, " << pipelines.size() << " pipelines, "
+                  << tasks.size() << " tasks, " << (distributed ? "distributed" : "threads=" + std::to_string(options.threads))
+                  << std::endl;
+
+        std::mutex outMtx;
+        std::atomic<int> done{0};
+        auto finished = [&](const Row &row)
+        {
+            std::lock_guard<std::mutex> lock(outMtx);
+            std::cout << "BATCH_TASK;done=" << ++done << "/" << tasks.size() << ";instance=" << row.instance
+                      << ";pipeline=" << row.pipeline << ";seed=" << row.seed << ";cmax=" << (long long)row.result.makespan
+                      << ";ms=" << (long long)(row.result.seconds * 1000) << std::endl;
+        };
+        for (std::size_t idx = 0; idx < tasks.size(); ++idx)
+        {
+            const Task &task = tasks[idx];
+            const InstanceSlot &slot = *slots[task.slot];
+            Row &row = rows[idx];
+            row.instance = slot.path;
+            row.pipeline = pipelines[task.pipeline].spec;
+            row.seed = task.seed;
+            row.jobs = slot.jobs;
+            row.machines = slot.machines;
+        }
+
+        auto wallStart = std::chrono::steady_clock::now();
+        if (distributed)
+            runDistributed(slots, tasks, order, rows, finished);
+        else
+        {
+            ThreadPool pool(options.threads);
+            for (int idx : order)
+                pool.submit([&, idx]
+                            {
+                                const Task &task = tasks[idx];
+                                InstanceSlot &slot = *slots[task.slot];
+                                Row &row = rows[idx];
+                                auto instance = acquire(slot, options);
+                                if (instance)
+                                {
+                                    row.jobs = instance->getJobs();
+                                    row.machines = instance->getMachines();
+                                    SolveBudget budget = taskBudget();
+                                    budget.start();
+                                    row.result = runPipeline(*instance, pipelines[task.pipeline], task.seed, budget, false, Schedule(),
+                                                             pipelineOptions(options));
+                                }
+                                else
+                                    row.status = "load_error";
+                                release(slot);
+                                finished(row); });
+            pool.wait();
+        }
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+        // Kolejność wierszy niezależna od kolejności wykonania
+        if (options.output.empty())
+            writeCsv(std::cout, rows);
+        else
+        {
+            std::ofstream out(options.output);
+            if (!out.is_open())
+                throw std::runtime_error("cannot write " + options.output);
+            if (endsWith(options.output, ".json"))
+                writeJson(out, rows);
+            else
+                writeCsv(out, rows);
+            std::cout << "Results written to: " << options.output << std::endl;
+        }
+        std::cout << "Batch execution time: " << (long long)(wall * 1000) << " ms" << std::endl;
+
+        for (const auto &row : rows)
+            if (row.status != "ok")
+                return 1;
+        return 0;
+    }
+
+private:
+    // Zadania w tej samej kolejności (LPT) do workerów; każda instancja wysyłana w formacie binarnym
+    // i zwalniana u workerów po ostatnim swoim zadaniu. Zadanie utraconego workera liczone jest ponownie
+    void runDistributed(std::vector<std::unique_ptr<InstanceSlot>> &slots, const std::vector<Task> &tasks,
+                        const std::vector<int> &order, std::vector<Row> &rows, const std::function<void(const Row &)> &finished)
+    {
+        DistributedCoordinator coordinator(options);
+        // Upakowane przezbrojenia nie mają postaci binarnej - wysyłany jest najwęższy typ
+        SetupEncoding encoding = (options.setupEncoding == SetupEncoding::Packed) ? SetupEncoding::Narrowest : options.setupEncoding;
+        std::vector<int> keys(slots.size());
+        for (std::size_t s = 0; s < slots.size(); ++s)
+        {
+            std::string path = slots[s]->path;
+            keys[s] = coordinator.addInstance(path, [path, encoding]() -> std::shared_ptr<const std::string>
+                                              {
+                                                  Instance instance(path);
+                                                  instance.setStorageOptions(SetupLayout::PrevJobMajor, encoding, false);
+                                                  if (!instance.loadFromFile(false))
+                                                      return nullptr;
+                                                  return DistributedCoordinator::encode(instance); });
+        }
+
+        for (int idx : order)
+        {
+            const Task &task = tasks[idx];
+            RemoteTask remote;
+            remote.instance = keys[task.slot];
+            remote.pipeline = pipelines[task.pipeline].spec;
+            remote.seed = task.seed;
+            remote.budget = taskBudget();
+            remote.timeFromDispatch = true;
+            remote.tuning = pipelineOptions(options);
+            remote.done = [&, idx, slot = task.slot](const RemoteResult &r)
+            {
+                Row &row = rows[idx];
+                // Przerwane zadanie z najlepszym dotąd rozwiązaniem daje pełny wiersz, jak lokalnie
+                if (!r.result.sequence.empty())
+                {
+                    row.jobs = r.jobs;
+                    row.machines = r.machines;
+                    row.result = r.result;
+                }
+                row.status = r.status;
+                if (--slots[slot]->remaining == 0)
+                    coordinator.releaseInstance(keys[slot]);
+                finished(row);
+            };
+            coordinator.submit(std::move(remote));
+        }
+        coordinator.wait();
+        coordinator.report(std::cerr);
+    }
+
+    // --time-limit / --target / --stagnation dotyczą każdego zadania osobno (czas od jego startu)
+    SolveBudget taskBudget() const
+    {
+        SolveBudget budget;
+        budget.timeLimit = options.timeLimit;
+        budget.targetMakespan = options.target;
+        budget.stagnationLimit = options.stagnation;
+        return budget;
+    }
+
+    static std::shared_ptr<const Instance> acquire(InstanceSlot &slot, const RunOptions &options)
+    {
+        std::lock_guard<std::mutex> lock(slot.mtx);
+        if (!slot.loaded)
+        {
+            auto instance = std::make_shared<Instance>(slot.path);
+            instance->setStorageOptions(SetupLayout::PrevJobMajor, options.setupEncoding, options.hugePages);
+            if (instance->loadFromFile(false))
+                slot.instance = instance;
+            slot.loaded = true;
+        }
+        return slot.instance;
+    }
+
+    static void release(InstanceSlot &slot)
+    {
+        if (--slot.remaining == 0)
+        {
+            std::lock_guard<std::mutex> lock(slot.mtx);
+            slot.instance.reset();
+        }
+    }
+
+    // Przybliżony koszt: NEH ~ n^2*m, SA ~ iteracje * n*m (ocena przyrostowa), LS ~ n^3*m, B&B ~ 2^n
+    static double estimateCost(const InstanceSlot &slot, const Pipeline &pipeline)
+    {
+        double n = std::max(1, slot.jobs);
+        double m = std::max(1, slot.machines);
+        double cost = 0.0;
+        for (const auto &stage : pipeline.stages)
+        {
+            if (stage.algorithm == "neh")
+                cost += n * n * m;
+            else if (stage.algorithm == "local_search")
+                cost += n * n * n * m; // ~n ruchów po przeglądzie O(n^2*m)
+            else if (stage.algorithm == "branch_and_bound")
+                cost += std::pow(2.0, std::min(n, 60.0)) * n * m; // wykładniczo; limit węzłów nieznany z góry
+            else
+                cost += stageParam(stage, 0, 50000) * n * m;
+        }
+        return cost;
+    }
+
+    // Odczyt samego nagłówka (jobs/machines) bez wczytywania macierzy; plik binarny (--convert) po magii
+    static void peekDimensions(const std::string &path, int &jobs, int &machines)
+    {
+        std::ifstream file(path, std::ios::binary);
+        BinaryInstanceHeader header{};
+        if (file.read(header.magic, sizeof(header)) && binary_format::hasMagic(header.magic, sizeof(header.magic)))
+        {
+            jobs = (int)header.jobs;
+            machines = (int)header.machines;
+            return;
+        }
+        file.clear();
+        file.seekg(0);
+        std::string line;
+        while (std::getline(file, line) && line.find("proc_time") == std::string::npos)
+        {
+            std::stringstream ss(line);
+            std::string key, dummy;
+            if (line.find("jobs") != std::string::npos)
+                ss >> key >> dummy >> jobs;
+            else if (line.find("machines") != std::string::npos)
+                ss >> key >> dummy >> machines;
+        }
+    }
+
+    static bool endsWith(const std::string &text, const std::string &suffix)
+    {
+        return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    // Maska z '*' i '?' dopasowywana do nazwy pliku
+    static bool matchesMask(const std::string &name, const std::string &mask)
+    {
+        size_t n = 0, p = 0, star = std::string::npos, mark = 0;
+        while (n < name.size())
+        {
+            if (p < mask.size() && (mask[p] == '?' || mask[p] == name[n]))
+                ++n, ++p;
+            else if (p < mask.size() && mask[p] == '*')
+                star = p++, mark = n;
+            else if (star != std::string::npos)
+                p = star + 1, n = ++mark;
+            else
+                return false;
+        }
+        while (p < mask.size() && mask[p] == '*')
+            ++p;
+        return p == mask.size();
+    }
+
+    static std::vector<std::string> resolveInputs(const std::string &pattern)
+    {
+        namespace fs = std::filesystem;
+        std::vector<std::string> files;
+        fs::path dir = pattern;
+        std::string mask = "*.txt";
+
+        if (!fs::is_directory(dir))
+        {
+            if (pattern.find_first_of("*?") == std::string::npos)
+                return {pattern};
+            dir = fs::path(pattern).parent_path();
+            mask = fs::path(pattern).filename().string();
+            if (dir.empty())
+                dir = ".";
+        }
+
+        if (fs::is_directory(dir))
+            for (const auto &entry : fs::directory_iterator(dir))
+                if (entry.is_regular_file() && matchesMask(entry.path().filename().string(), mask))
+                    files.push_back(entry.path().string());
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    static std::string sequenceText(const std::vector<int> &seq)
+    {
+        std::string text;
+        for (size_t i = 0; i < seq.size(); ++i)
+        {
+            if (i)
+                text += ' ';
+            text += std::to_string(seq[i]);
+        }
+        return text;
+    }
+
+    static std::string csvField(const std::string &value)
+    {
+        if (value.find_first_of(",\"\n") == std::string::npos)
+            return value;
+        std::string quoted = "\"";
+        for (char c : value)
+            quoted += (c == '"') ? std::string("\"\"") : std::string(1, c);
+        return quoted + "\"";
+    }
+
+    static std::string jsonString(const std::string &value)
+    {
+        std::string out = "\"";
+        for (char c : value)
+        {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            out += c;
+        }
+        return out + "\"";
+    }
+
+    // Czas w ms z 3 miejscami po przecinku; formatowanie na osobnym strumieniu, żeby nie zostało na wyjściu
+    static std::string milliseconds(double seconds)
+    {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(3) << seconds * 1000;
+        return text.str();
+    }
+
+    static void writeCsv(std::ostream &out, const std::vector<Row> &rows)
+    {
+        out << "instance,jobs,machines,pipeline,seed,status,makespan,runtime_ms,iterations,sequence\n";
+        for (const auto &r : rows)
+            out << csvField(r.instance) << ',' << r.jobs << ',' << r.machines << ',' << csvField(r.pipeline) << ','
+                << r.seed << ',' << r.status << ',' << (long long)r.result.makespan << ',' << milliseconds(r.result.seconds)
+                << ',' << r.result.iterations << ','
+                << sequenceText(r.result.sequence) << '\n';
+    }
+
+    static void writeJson(std::ostream &out, const std::vector<Row> &rows)
+    {
+        out << "[\n";
+        for (size_t i = 0; i < rows.size(); ++i)
+        {
+            const Row &r = rows[i];
+            out << "  {\"instance\": " << jsonString(r.instance) << ", \"jobs\": " << r.jobs
+                << ", \"machines\": " << r.machines << ", \"pipeline\": " << jsonString(r.pipeline)
+                << ", \"seed\": " << r.seed << ", \"status\": " << jsonString(r.status)
+                << ", \"makespan\": " << (long long)r.result.makespan << ", \"runtime_ms\": " << milliseconds(r.result.seconds)
+                << ", \"iterations\": " << r.result.iterations
+                << ", \"sequence\": [";
+            for (size_t k = 0; k < r.result.sequence.size(); ++k)
+                out << (k ? ", " : "") << r.result.sequence[k];
+            out << "]}" << (i + 1 < rows.size() ? "," : "") << "\n";
+        }
+        out << "]\n";
+    }
+};
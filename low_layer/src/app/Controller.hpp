@@ -4,11 +4,19 @@
 #include "../core/Schedule.hpp"
 #include "../core/SimulatedAnnealing.hpp"
 #include "../core/NEHWithProgress.hpp"
+#include "../core/ParallelAnnealing.hpp"
+#include "../core/IteratedGreedy.hpp"
+#include "../core/LocalSearch.hpp"
+#include "../core/LowerBound.hpp"
+#include "../core/BranchAndBound.hpp"
+#include "../core/Profiler.hpp"
+#include "RunOptions.hpp"
 #include <iostream>
 #include <chrono>
 #include <algorithm>
 #include <vector>
 #include <cctype>
+#include <memory>
 
 class Controller
 {
@@ -16,16 +24,37 @@ private:
     Instance instance;
     Schedule schedule;
     std::vector<std::string> tokensFromArgs;
+    RunOptions options;
+    SolveBudget budget;
 
 public:
-    Controller(const std::string &instancePath, const std::vector<std::string> &algorithmArgs)
-        : instance(instancePath), tokensFromArgs(algorithmArgs)
+    Controller(const std::string &instancePath, const std::vector<std::string> &algorithmArgs,
+               const RunOptions &runOptions = RunOptions())
+        : instance(instancePath), tokensFromArgs(algorithmArgs), options(runOptions)
     {
+        instance.setStorageOptions(SetupLayout::PrevJobMajor, options.setupEncoding, options.hugePages);
     }
 
-    void execute()
+    // false = instancja nie została wczytana (błąd już wypisany); obliczenia się nie zaczynają
+    bool execute()
     {
-        instance.loadFromFile();
+        if (!instance.loadFromFile())
+            return false;
+
+        // Limit czasu liczony od wczytania instancji, wspólny dla wszystkich faz
+        budget.timeLimit = options.timeLimit;
+        budget.targetMakespan = options.target;
+        budget.stagnationLimit = options.stagnation;
+        budget.start();
+
+        // Dolne ograniczenie: luka w wyniku końcowym, a makespan równy ograniczeniu kończy solvery (optimum)
+        long long lowerBound = 0;
+        {
+            Profiler::Scope profile(Profiler::Phase::LowerBound);
+            lowerBound = LowerBound(instance).compute();
+        }
+        budget.lowerBound = lowerBound;
+        LogLine() << "Lower bound: " << lowerBound;
 
         // Lambda do sprawdzania obecności flagi
         auto hasToken = [&](const std::string &t) -> bool
@@ -34,75 +63,163 @@ public:
         };
 
         Schedule currentBest;
+        bool provenOptimal = false;
 
         // Faza NEH
         if (hasToken("neh"))
         {
-            std::cout << "\n=== Phase: NEH ===" << std::endl;
+            LogLine() << "\n=== Phase: NEH ===";
             currentBest = runNEHWithProgress();
-            std::cout << "\n=== Phase: NEH end===" << std::endl;
+            LogLine() << "\n=== Phase: NEH end===";
+        }
+
+        // Faza Iterated Greedy (parametry: iteracje, liczba usuwanych zadań, współczynnik temperatury)
+        auto igIt = std::find(tokensFromArgs.begin(), tokensFromArgs.end(), "iterated_greedy");
+        if (igIt != tokensFromArgs.end() && Cancellation::requested())
+            LogLine() << "Cancelled - skipping Iterated Greedy";
+        else if (igIt != tokensFromArgs.end())
+        {
+            LogLine() << "\n=== Phase: Iterated Greedy ===";
+
+            int iters = 2000;
+            int destroy = 4;
+            double temp = 0.4;
+
+            std::vector<double> params = numericParams(igIt);
+            if (params.size() > 0) iters = (int)params[0];
+            if (params.size() > 1) destroy = (int)params[1];
+            if (params.size() > 2) temp = params[2];
+
+            LogLine() << "Parameters: Iterations=" << iters << ", Destroy=" << destroy << ", Temp=" << temp;
+            currentBest = runIteratedGreedy(currentBest, iters, destroy, temp);
         }
 
         // Faza Simulated Annealing
         auto saIt = std::find(tokensFromArgs.begin(), tokensFromArgs.end(), "simulated_annealing");
-        if (saIt != tokensFromArgs.end())
+        if (saIt != tokensFromArgs.end() && Cancellation::requested())
+            LogLine() << "Cancelled - skipping Simulated Annealing";
+        else if (saIt != tokensFromArgs.end())
         {
-            std::cout << "\n=== Phase: Simulated Annealing ===" << std::endl;
+            LogLine() << "\n=== Phase: Simulated Annealing ===";
             
             // Domyślne parametry
             int iters = 50000;
             double temp = 100.0;
             double cooling = 0.9975;
 
-            // Parsowanie parametrów z argumentów (jeśli istnieją po słowie kluczowym)
-            try {
-                auto next = std::next(saIt);
-                if (next != tokensFromArgs.end()) {
-                    iters = std::stoi(*next); // Pierwszy parametr: Iteracje
-                    if (++next != tokensFromArgs.end()) {
-                        temp = std::stod(*next); // Drugi parametr: Temperatura
-                        if (++next != tokensFromArgs.end()) {
-                            cooling = std::stod(*next); // Trzeci parametr: Chłodzenie
-                        }
-                    }
-                }
-            } catch (const std::exception& e) {
-                std::cout << "Warning: Could not parse SA parameters, using defaults. Error: " << e.what() << std::endl;
-            }
+            // Parametry: iteracje, temperatura, chłodzenie
+            std::vector<double> params = numericParams(saIt);
+            if (params.size() > 0) iters = (int)params[0];
+            if (params.size() > 1) temp = params[1];
+            if (params.size() > 2) cooling = params[2];
 
-            std::cout << "Parameters: Iterations=" << iters << ", Temp=" << temp << ", Cooling=" << cooling << std::endl;
+            LogLine() << "Parameters: Iterations=" << iters << ", Temp=" << temp << ", Cooling=" << cooling;
 
             if (currentBest.getJobSequence().empty()) {
-                std::cout << "No initial solution from NEH, starting with random." << std::endl;
+                LogLine() << "No initial solution from NEH, starting with random.";
             } else {
-                std::cout << "Starting from NEH solution with makespan: "
-                          << instance.computeMakespan(currentBest.getJobSequence()) << std::endl;
+                LogLine() << "Starting from NEH solution with makespan: "
+                          << instance.computeMakespan(currentBest.getJobSequence());
             }
 
             // Uruchomienie SA z pobranymi parametrami
-            currentBest = runSimulatedAnnealing(currentBest, iters, temp, cooling);
+            if (options.threads > 1)
+                currentBest = runParallelAnnealing(currentBest, iters, temp, cooling);
+            else
+                currentBest = runSimulatedAnnealing(currentBest, iters, temp, cooling);
+        }
+
+        // Faza przeszukiwania lokalnego (parametry: insertion|swap|both, first|best) - po NEH/SA
+        auto lsIt = std::find(tokensFromArgs.begin(), tokensFromArgs.end(), "local_search");
+        if (lsIt != tokensFromArgs.end() && Cancellation::requested())
+            LogLine() << "Cancelled - skipping Local Search";
+        else if (lsIt != tokensFromArgs.end())
+        {
+            LogLine() << "\n=== Phase: Local Search ===";
+
+            LocalSearch::Neighborhood neighborhood = LocalSearch::Neighborhood::Insertion;
+            LocalSearch::Strategy strategy = LocalSearch::Strategy::FirstImprovement;
+            // Słowa kluczowe w dowolnej kolejności bezpośrednio po nazwie
+            for (auto next = std::next(lsIt); next != tokensFromArgs.end(); ++next)
+                if (!LocalSearch::parseNeighborhood(*next, neighborhood) && !LocalSearch::parseStrategy(*next, strategy))
+                    break;
+
+            currentBest = runLocalSearch(currentBest, neighborhood, strategy);
+        }
+
+        // Faza branch-and-bound (parametr: limit węzłów) - rozwiązanie z poprzednich faz jako górne ograniczenie
+        auto bbIt = std::find(tokensFromArgs.begin(), tokensFromArgs.end(), "branch_and_bound");
+        if (bbIt != tokensFromArgs.end() && Cancellation::requested())
+            LogLine() << "Cancelled - skipping Branch and Bound";
+        else if (bbIt != tokensFromArgs.end())
+        {
+            LogLine() << "\n=== Phase: Branch and Bound ===";
+
+            long long nodeLimit = 0;
+            auto next = std::next(bbIt);
+            if (next != tokensFromArgs.end())
+            {
+                try {
+                    size_t used = 0;
+                    long long value = std::stoll(*next, &used);
+                    if (used == next->size())
+                        nodeLimit = value;
+                } catch (const std::exception &) {
+                }
+            }
+            if (instance.getJobs() > 14 && nodeLimit == 0 && options.timeLimit <= 0)
+                LogLine() << "Warning: " << instance.getJobs() << " jobs - exact search may not finish; consider --time-limit";
+
+            currentBest = runBranchAndBound(currentBest, nodeLimit, provenOptimal);
         }
 
         // Wyświetlenie wyniku końcowego
         if (!currentBest.getJobSequence().empty())
         {
-            std::cout << "\n=== FINAL RESULT ===" << std::endl;
-            std::cout << "Final best sequence: ";
-            currentBest.print();
+            LogLine() << "\n=== FINAL RESULT ===";
+            LogLine() << "Final best sequence: " << currentBest.toString();
             double finalMakespan = instance.computeMakespan(currentBest.getJobSequence());
-            std::cout << "Final best makespan: " << finalMakespan << std::endl;
+            LogLine() << "Final best makespan: " << finalMakespan;
+            LogLine() << "Gap to lower bound: "
+                      << (lowerBound > 0 ? 100.0 * (finalMakespan - lowerBound) / lowerBound : 0.0) << "%"
+                      << (provenOptimal || finalMakespan <= lowerBound ? " (optimal)" : "");
         }
+        return true;
     }
 
 private:
+    // Parametry liczbowe bezpośrednio po nazwie algorytmu (pierwszy nieliczbowy token, np. kolejny algorytm, kończy listę)
+    std::vector<double> numericParams(std::vector<std::string>::const_iterator name) const
+    {
+        std::vector<double> params;
+        for (auto next = std::next(name); next != tokensFromArgs.end(); ++next)
+        {
+            try {
+                size_t used = 0;
+                double value = std::stod(*next, &used);
+                if (used != next->size())
+                    break;
+                params.push_back(value);
+            } catch (const std::exception &) {
+                break;
+            }
+        }
+        return params;
+    }
+
     // Zmodyfikowana metoda przyjmująca parametry
     Schedule runSimulatedAnnealing(const Schedule &initialSolution, int iters, double temp, double cooling)
     {
-        std::cout << "Running Simulated Annealing..." << std::endl;
+        LogLine() << "Running Simulated Annealing...";
         auto start = std::chrono::high_resolution_clock::now();
 
-        SimulatedAnnealing simAnneal(instance, 1);
+        SimulatedAnnealing simAnneal(instance, options.seed);
         simAnneal.setParameters(iters, temp, cooling); // Przekazanie parametrów do algorytmu
+        simAnneal.setBudget(budget);
+        simAnneal.setMoveBatch(options.moveBatch);
+        simAnneal.setSchedule(options.annealing);
+        std::unique_ptr<SolutionCache> cache = makeSolutionCache();
+        simAnneal.setSolutionCache(cache.get());
 
         Schedule result = simAnneal.solve(initialSolution);
 
@@ -110,19 +227,149 @@ private:
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
 
         double makespan = instance.computeMakespan(result.getJobSequence());
-        std::cout << "Simulated Annealing final makespan: " << makespan << std::endl;
-        std::cout << "Simulated Annealing execution time: " << duration.count() << " ms" << std::endl;
+        LogLine() << "Simulated Annealing final makespan: " << makespan;
+        LogLine() << "Simulated Annealing execution time: " << duration.count() << " ms";
 
         return result;
     }
 
+    Schedule runIteratedGreedy(const Schedule &initialSolution, int iters, int destroy, double temp)
+    {
+        LogLine() << "Running Iterated Greedy...";
+        Profiler::Scope profile(Profiler::Phase::IteratedGreedy);
+        auto start = std::chrono::high_resolution_clock::now();
+
+        IteratedGreedy greedy(instance, options.seed);
+        greedy.setParameters(iters, destroy, temp);
+        greedy.setBudget(budget);
+
+        Schedule result = greedy.solve(initialSolution);
+
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+
+        LogLine() << "Iterated Greedy final makespan: " << instance.computeMakespan(result.getJobSequence());
+        LogLine() << "Iterated Greedy iterations: " << greedy.getIteration();
+        LogLine() << "Iterated Greedy execution time: " << duration.count() << " ms";
+
+        return result;
+    }
+
+    Schedule runLocalSearch(const Schedule &initialSolution, LocalSearch::Neighborhood neighborhood,
+                            LocalSearch::Strategy strategy)
+    {
+        static const char *neighborhoods[] = {"insertion", "swap", "both"};
+        LogLine() << "Running Local Search: neighborhood=" << neighborhoods[(int)neighborhood] << ", strategy="
+                  << (strategy == LocalSearch::Strategy::FirstImprovement ? "first" : "best")
+                  << ", threads=" << options.threads;
+
+        Profiler::Scope profile(Profiler::Phase::LocalSearch);
+        LocalSearch search(instance, options.threads);
+        search.setNeighborhood(neighborhood);
+        search.setStrategy(strategy);
+        search.setBudget(budget);
+
+        Schedule result = search.solve(initialSolution);
+
+        const auto &stats = search.getStats();
+        LogLine() << "Local Search final makespan: " << instance.computeMakespan(result.getJobSequence());
+        profile.addEvaluations(stats.evaluated);
+        LogLine() << "Local Search moves evaluated: " << stats.evaluated << " ("
+                  << (long long)stats.movesPerSecond() << " moves/s)";
+        LogLine() << "Local Search execution time: " << (long long)(stats.seconds * 1000) << " ms";
+
+        return result;
+    }
+
+    Schedule runBranchAndBound(const Schedule &initialSolution, long long nodeLimit, bool &proven)
+    {
+        LogLine() << "Running Branch and Bound: threads=" << options.threads
+                  << ", node limit=" << (nodeLimit > 0 ? std::to_string(nodeLimit) : "none");
+
+        Profiler::Scope profile(Profiler::Phase::BranchAndBound);
+        BranchAndBound exact(instance, options.threads);
+        exact.setNodeLimit(nodeLimit);
+        exact.setBudget(budget);
+
+        Schedule result = exact.solve(initialSolution);
+
+        const auto &stats = exact.getStats();
+        proven = stats.proven;
+        LogLine() << "Branch and Bound final makespan: " << instance.computeMakespan(result.getJobSequence())
+                  << (stats.proven ? " (optimal)" : " (not proven)");
+        profile.addEvaluations(stats.nodes);
+        LogLine() << "Branch and Bound nodes: " << stats.nodes;
+        LogLine() << "Branch and Bound execution time: " << (long long)(stats.seconds * 1000) << " ms";
+
+        return result;
+    }
+
+    // N łańcuchów (po jednym na wątek); łańcuch 0 to dokładnie pojedyncze SA z tym samym ziarnem
+    Schedule runParallelAnnealing(const Schedule &initialSolution, int iters, double temp, double cooling)
+    {
+        LogLine() << "Running parallel Simulated Annealing: threads=" << options.threads
+                  << ", migration=" << options.migrationInterval << ", seed=" << options.seed;
+
+        ParallelAnnealing islands(instance, options.threads);
+        islands.setChains(ParallelAnnealing::makeChains(options.threads, options.seed, iters, temp, cooling));
+        islands.setMigrationInterval(options.migrationInterval);
+        islands.setBudget(budget);
+        islands.setMoveBatch(options.moveBatch);
+        islands.setSchedule(options.annealing);
+        std::unique_ptr<SolutionCache> cache = makeSolutionCache();
+        islands.setSolutionCache(cache.get());
+
+        Schedule result = islands.solve(initialSolution);
+
+        double chainSeconds = 0.0;
+        const auto &reports = islands.getReports();
+        for (size_t i = 0; i < reports.size(); ++i)
+        {
+            LogLine() << "Chain " << i << " (seed=" << reports[i].seed << "): best makespan " << reports[i].bestMakespan
+                      << ", time " << (long long)(reports[i].seconds * 1000) << " ms";
+            chainSeconds += reports[i].seconds;
+        }
+
+        double makespan = instance.computeMakespan(result.getJobSequence());
+        double wall = islands.getWallSeconds();
+        LogLine() << "Single chain (chain 0) makespan: " << reports[0].bestMakespan
+                  << ", parallel best: " << makespan
+                  << " (" << (reports[0].bestMakespan - makespan) << " better)";
+        LogLine() << "Parallel speedup: " << (wall > 0 ? chainSeconds / wall : 0.0)
+                  << "x (chain time " << (long long)(chainSeconds * 1000) << " ms / wall " << (long long)(wall * 1000) << " ms)";
+        if (cache)
+        {
+            const auto &counters = islands.getCacheCounters();
+            LogLine() << "Solution cache (shared by " << reports.size() << " chains): " << counters.lookups << " lookups, "
+                      << counters.hits << " hits (" << counters.hitRate() << "%)";
+        }
+        LogLine() << "Simulated Annealing final makespan: " << makespan;
+        LogLine() << "Simulated Annealing execution time: " << (long long)(wall * 1000) << " ms";
+
+        result.emitFinalSlots(instance);
+        return result;
+    }
+
+    // --sa-cache=N: cache odwiedzonych rozwiązań na czas jednej fazy SA; nullptr = wyłączony
+    std::unique_ptr<SolutionCache> makeSolutionCache() const
+    {
+        if (options.saCache <= 0)
+            return nullptr;
+        return std::make_unique<SolutionCache>((std::size_t)options.saCache);
+    }
+
     Schedule runNEHWithProgress()
     {
         auto start = std::chrono::high_resolution_clock::now();
         NEHWithProgress neh(instance);
+        neh.setBudget(budget);
         Schedule result = neh.solve();
+        if (neh.wasStopped())
+            LogLine() << "NEH stopped early - remaining jobs appended in LPT order";
         auto end = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        LogLine() << "NEH makespan: " << instance.computeMakespan(result.getJobSequence());
+        LogLine() << "NEH execution time: " << duration.count() << " ms";
         return result;
     }
 };
\ No newline at end of file
@@ -0,0 +1,597 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../core/Instance.hpp"
+#include "../core/SolveBudget.hpp"
+#include "Pipeline.hpp"
+#include "RunOptions.hpp"
+#include "WorkerLink.hpp"
+
+// Wynik zadania zwrócony przez workera
+struct RemoteResult
+{
+    std::string status = "ok"; // ok / cancelled / load_error / error / worker_error
+    std::string message;
+    int jobs = 0;
+    int machines = 0;
+    int worker = -1;
+    PipelineResult result;
+};
+
+// Zadanie dla workera: potok na zarejestrowanej instancji (jak zadanie trybu wsadowego albo przebieg członka portfolio)
+struct RemoteTask
+{
+    int instance = -1;
+    std::string pipeline;
+    int seed = 1;
+    SolveBudget budget;         // limit czasu liczony od budget.startTime - worker dostaje czas pozostały przy wysłaniu
+    bool timeFromDispatch = false; // limit czasu w całości od startu na workerze (zadania wsadowe czekające w kolejce)
+    PipelineOptions tuning;
+    bool fromIncumbent = false; // start od najlepszego rozwiązania instancji (setIncumbent) zamiast pustego
+    // Poprawy w trakcie (sequence = nullptr, gdy solver jej nie podał); pusty = bez zdarzeń postępu
+    std::function<void(long long iteration, long long makespan, const std::vector<int> *sequence)> improved;
+    std::function<void(const RemoteResult &)> done;
+};
+
+// Koordynator trybu rozproszonego. Workery (pfsp_sdst --worker=ADRES, lokalne albo na innych hostach)
+// łączą się z nim, a on rozdziela zadania po ich wolnych slotach, w kolejności zgłoszenia.
+// Instancja trafia do workera raz, w formacie binarnym, przed pierwszym jego zadaniem na niej.
+// Najlepsze rozwiązanie instancji (setIncumbent) rozsyłane jest co --broadcast ms workerom, które
+// mają starszą wersję, i zawsze przed zadaniem startującym od niego.
+// Zerwane połączenie (awaria procesu lub hosta) zwraca zadania workera na początek kolejki.
+// Wywołania zwrotne zadań działają poza blokadą, w wątku odbioru workera (albo wołającego submit/cancel).
+class DistributedCoordinator
+{
+public:
+    struct Stats
+    {
+        int workers = 0;
+        int lost = 0;
+        long long tasks = 0;    // wysłane (z ponownymi)
+        long long requeued = 0;
+        long long instanceBytes = 0;
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Worker
+    {
+        int id = 0;
+        std::shared_ptr<MessageChannel> channel;
+        std::string name; // host:pid z powitania
+        int slots = 0;    // 0 do powitania
+        bool alive = true;
+        std::map<long long, RemoteTask> running;
+        std::set<int> instances;
+        std::map<int, long long> incumbents; // znana wersja najlepszego rozwiązania instancji
+        std::thread reader;
+    };
+
+    struct InstanceEntry
+    {
+        std::string name;
+        std::function<std::shared_ptr<const std::string>()> load;
+        std::shared_ptr<const std::string> bytes; // wczytywana przy pierwszym wysłaniu
+        bool failed = false;
+        long long incumbentVersion = 0;
+        long long incumbentCmax = LLONG_MAX;
+        std::vector<int> incumbent;
+    };
+
+    using Completion = std::pair<RemoteTask, RemoteResult>;
+
+    RunOptions options;
+    std::string endpoint;
+    bool unixSocket = false;
+    int listenFd = -1;
+    std::vector<pid_t> children;
+    bool spawned = false;
+
+    std::mutex mtx;
+    std::condition_variable changed;
+    std::deque<std::pair<long long, RemoteTask>> queue;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::map<int, InstanceEntry> instances;
+    long long nextTask = 0;
+    int nextInstance = 0;
+    long long outstanding = 0; // w kolejce, u workerów i w trakcie wywołania done
+    bool closing = false;
+    Stats stats;
+
+    std::thread acceptor;
+    std::thread ticker;
+
+public:
+    // Nasłuch na --coordinator (domyślnie gniazdo Unix w /tmp) i --spawn-workers procesów lokalnych
+    explicit DistributedCoordinator(const RunOptions &runOptions) : options(runOptions), endpoint(runOptions.coordinator)
+    {
+        if (endpoint.empty())
+            endpoint = "/tmp/pfsp-coordinator-" + std::to_string(::getpid()) + ".sock";
+        unixSocket = worker_link::parseEndpoint(endpoint).unixSocket;
+        listenFd = worker_link::listenOn(endpoint);
+        std::cerr << "Coordinator: listening on " << endpoint << std::endl;
+
+        // Procesy startują przed wątkami koordynatora; połączenia czekają w kolejce gniazda
+        for (int i = 0; i < options.spawnWorkers; ++i)
+            spawnWorker();
+        spawned = !children.empty();
+        acceptor = std::thread([this]
+                               { acceptLoop(); });
+        ticker = std::thread([this]
+                             { tickLoop(); });
+    }
+
+    DistributedCoordinator(const DistributedCoordinator &) = delete;
+
+    // Workery dostają "shutdown" (przerywają bieżące zadania), procesy lokalne są zbierane
+    ~DistributedCoordinator()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            closing = true;
+            for (auto &w : workers)
+                if (w->alive)
+                    w->channel->send(LinkMessage("shutdown").str());
+        }
+        changed.notify_all();
+        ::shutdown(listenFd, SHUT_RDWR);
+        acceptor.join();
+        ticker.join();
+        for (auto &w : workers)
+        {
+            w->channel->close();
+            w->reader.join();
+        }
+        for (pid_t pid : children)
+            ::waitpid(pid, nullptr, 0);
+        ::close(listenFd);
+        if (unixSocket)
+            ::unlink(endpoint.c_str());
+    }
+
+    // Instancja wczytywana leniwie przy pierwszym wysłaniu; load zwraca format binarny albo nullptr
+    int addInstance(const std::string &name, std::function<std::shared_ptr<const std::string>()> load)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        int key = nextInstance++;
+        instances[key].name = name;
+        instances[key].load = std::move(load);
+        return key;
+    }
+
+    // Po ostatnim zadaniu instancji: zwolnienie danych tu i u workerów
+    void releaseInstance(int key)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        instances.erase(key);
+        for (auto &w : workers)
+            if (w->alive && w->instances.erase(key))
+            {
+                w->incumbents.erase(key);
+                w->channel->send(LinkMessage("drop").field("instance", key).str());
+            }
+    }
+
+    long long submit(RemoteTask task)
+    {
+        long long id;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            id = nextTask++;
+            queue.emplace_back(id, std::move(task));
+            ++outstanding;
+        }
+        pump();
+        return id;
+    }
+
+    // Zadanie w kolejce kończy się od razu statusem cancelled, wysłane - najlepszym wynikiem do tej pory
+    void cancel(long long id)
+    {
+        std::vector<Completion> completions;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            auto queued = std::find_if(queue.begin(), queue.end(), [&](const auto &entry)
+                                       { return entry.first == id; });
+            if (queued != queue.end())
+            {
+                RemoteResult result;
+                result.status = "cancelled";
+                completions.emplace_back(std::move(queued->second), result);
+                queue.erase(queued);
+            }
+            else
+                for (auto &w : workers)
+                    if (w->alive && w->running.count(id))
+                        w->channel->send(LinkMessage("cancel").field("task", id).str());
+        }
+        complete(completions);
+    }
+
+    // Nowe najlepsze rozwiązanie instancji (tylko lepsze od dotychczasowego)
+    void setIncumbent(int key, long long makespan, const std::vector<int> &sequence)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = instances.find(key);
+        if (it == instances.end() || makespan >= it->second.incumbentCmax)
+            return;
+        it->second.incumbentCmax = makespan;
+        it->second.incumbent = sequence;
+        ++it->second.incumbentVersion;
+    }
+
+    // --coordinator albo --spawn-workers: tryb wsadowy / portfolio liczone przez workery
+    static bool requested(const RunOptions &options) { return !options.coordinator.empty() || options.spawnWorkers > 0; }
+
+    // Czeka na zakończenie wszystkich zgłoszonych zadań (łącznie z wywołaniami done)
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        changed.wait(lock, [this]
+                     { return outstanding == 0; });
+    }
+
+    Stats getStats()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return stats;
+    }
+
+    void report(std::ostream &out)
+    {
+        Stats s = getStats();
+        out << "Coordinator: " << s.workers << " worker(s), " << s.tasks << " task(s) sent, " << s.requeued
+            << " requeued after " << s.lost << " lost worker(s), " << s.instanceBytes / 1024 << " KiB of instance data" << std::endl;
+    }
+
+    // Instancja w formacie binarnym do wysłania; nullptr, gdy nie da się jej zapisać (np. --setup-storage=packed)
+    static std::shared_ptr<const std::string> encode(const Instance &instance)
+    {
+        std::ostringstream out;
+        if (!instance.writeBinary(out))
+            return nullptr;
+        return std::make_shared<const std::string>(out.str());
+    }
+
+private:
+    void spawnWorker()
+    {
+        char self[4096];
+        ssize_t length = ::readlink("/proc/self/exe", self, sizeof(self) - 1);
+        if (length <= 0)
+            throw std::runtime_error("cannot locate own executable to start workers");
+        self[length] = '\0';
+        std::string workerArg = "--worker=" + endpoint;
+        std::string threadsArg = "--threads=" + std::to_string(options.threads);
+        char *argv[] = {self, workerArg.data(), threadsArg.data(), nullptr};
+
+        pid_t pid = ::fork();
+        if (pid == 0)
+        {
+            // stdout koordynatora należy do tabeli wyników / telemetrii; Ctrl+C w terminalu przerywa
+            // obliczenia przez koordynatora (wyniki zostają), a nie zabija workerów razem z nim
+            ::dup2(STDERR_FILENO, STDOUT_FILENO);
+            ::signal(SIGINT, SIG_IGN);
+            ::execv(self, argv);
+            ::_exit(127);
+        }
+        if (pid < 0)
+            throw std::runtime_error(std::string("cannot start worker: ") + std::strerror(errno));
+        children.push_back(pid);
+    }
+
+    void acceptLoop()
+    {
+        for (;;)
+        {
+            int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0)
+            {
+                if (errno == EINTR || errno == ECONNABORTED)
+                    continue;
+                return; // shutdown() gniazda nasłuchującego
+            }
+            if (!unixSocket)
+                worker_link::tuneTcp(fd);
+            std::lock_guard<std::mutex> lock(mtx);
+            if (closing)
+            {
+                ::close(fd);
+                return;
+            }
+            workers.push_back(std::make_unique<Worker>());
+            Worker *worker = workers.back().get();
+            worker->id = (int)workers.size() - 1;
+            worker->channel = std::make_shared<MessageChannel>(fd);
+            worker->reader = std::thread([this, worker]
+                                         { readLoop(*worker); });
+        }
+    }
+
+    void readLoop(Worker &worker)
+    {
+        FlatJson message;
+        std::vector<char> payload;
+        try
+        {
+            while (worker.channel->receive(message, payload))
+            {
+                std::string type = message.text("type");
+                if (type == "hello")
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(mtx);
+                        worker.slots = std::max(1, (int)message.integer("slots", 1));
+                        worker.name = message.text("name");
+                        ++stats.workers;
+                        std::cerr << "Coordinator: worker " << worker.id << " (" << worker.name << ") connected, slots="
+                                  << worker.slots << std::endl;
+                    }
+                    pump();
+                }
+                else if (type == "improved")
+                {
+                    std::function<void(long long, long long, const std::vector<int> *)> improved;
+                    {
+                        std::lock_guard<std::mutex> lock(mtx);
+                        auto it = worker.running.find(message.integer("task", -1));
+                        if (it != worker.running.end())
+                            improved = it->second.improved;
+                    }
+                    if (improved)
+                    {
+                        std::vector<int> sequence = worker_link::splitInts(message.text("sequence"));
+                        improved(message.integer("iteration", 0), message.integer("cmax", 0), sequence.empty() ? nullptr : &sequence);
+                    }
+                }
+                else if (type == "done")
+                {
+                    std::vector<Completion> completions;
+                    {
+                        std::lock_guard<std::mutex> lock(mtx);
+                        auto it = worker.running.find(message.integer("task", -1));
+                        if (it != worker.running.end())
+                        {
+                            completions.emplace_back(std::move(it->second), parseResult(message, worker.id));
+                            worker.running.erase(it);
+                        }
+                    }
+                    complete(completions);
+                    pump();
+                }
+            }
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Coordinator: protocol error from worker " << worker.id << ": " << e.what() << std::endl;
+        }
+        lost(worker);
+    }
+
+    // Zadania utraconego workera wracają na początek kolejki w pierwotnej kolejności
+    void lost(Worker &worker)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            worker.alive = false;
+            if (!closing)
+            {
+                ++stats.lost;
+                stats.requeued += (long long)worker.running.size();
+                std::cerr << "Coordinator: lost worker " << worker.id << " (" << worker.name << "), requeued "
+                          << worker.running.size() << " task(s)" << std::endl;
+                for (auto it = worker.running.rbegin(); it != worker.running.rend(); ++it)
+                    queue.emplace_front(it->first, std::move(it->second));
+            }
+            worker.running.clear();
+        }
+        pump();
+        changed.notify_all();
+    }
+
+    void pump()
+    {
+        std::vector<Completion> completions;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            dispatch(completions);
+        }
+        complete(completions);
+    }
+
+    void complete(std::vector<Completion> &completions)
+    {
+        for (auto &c : completions)
+        {
+            if (c.first.done)
+                c.first.done(c.second);
+            std::lock_guard<std::mutex> lock(mtx);
+            --outstanding;
+            changed.notify_all();
+        }
+    }
+
+    // Wymaga blokady mtx. Zadania instancji, której nie da się wczytać, kończą się od razu (load_error)
+    void dispatch(std::vector<Completion> &completions)
+    {
+        while (!queue.empty() && !closing)
+        {
+            RemoteTask &task = queue.front().second;
+            InstanceEntry &entry = instances.at(task.instance);
+            if (!entry.bytes && !entry.failed)
+            {
+                entry.bytes = entry.load();
+                entry.failed = !entry.bytes;
+            }
+            if (entry.failed)
+            {
+                RemoteResult result;
+                result.status = "load_error";
+                completions.emplace_back(std::move(task), result);
+                queue.pop_front();
+                continue;
+            }
+
+            Worker *target = pickWorker(task.instance);
+            if (!target)
+                return;
+            long long id = queue.front().first;
+            send(*target, id, task, task.instance, entry);
+            target->running.emplace(id, std::move(task));
+            queue.pop_front();
+        }
+    }
+
+    // Wolny slot; najpierw workery, które już mają instancję, potem najmniej zajęte
+    Worker *pickWorker(int key)
+    {
+        Worker *best = nullptr;
+        for (auto &w : workers)
+        {
+            if (!w->alive || w->slots == 0 || (int)w->running.size() >= w->slots)
+                continue;
+            if (!best)
+            {
+                best = w.get();
+                continue;
+            }
+            bool has = w->instances.count(key) > 0, bestHas = best->instances.count(key) > 0;
+            int freeSlots = w->slots - (int)w->running.size(), bestFree = best->slots - (int)best->running.size();
+            if (has != bestHas ? has : freeSlots > bestFree)
+                best = w.get();
+        }
+        return best;
+    }
+
+    // Wymaga blokady mtx. Błąd wysłania wykryje wątek odbioru (koniec połączenia -> ponowna kolejka)
+    void send(Worker &worker, long long id, const RemoteTask &task, int key, const InstanceEntry &entry)
+    {
+        if (worker.instances.insert(key).second)
+        {
+            worker.channel->send(LinkMessage("instance").field("instance", key).text("name", entry.name)
+                                     .field("bytes", entry.bytes->size()).str(),
+                                 *entry.bytes);
+            stats.instanceBytes += (long long)entry.bytes->size();
+        }
+        if (task.fromIncumbent)
+            syncIncumbent(worker, key, entry);
+
+        double remaining = 0.0;
+        if (task.budget.hasTimeLimit() && task.timeFromDispatch)
+            remaining = task.budget.timeLimit;
+        else if (task.budget.hasTimeLimit())
+            remaining = std::max(1e-3, task.budget.timeLimit - std::chrono::duration<double>(Clock::now() - task.budget.startTime).count());
+        worker.channel->send(LinkMessage("task").field("task", id).field("instance", key).text("pipeline", task.pipeline)
+                                 .field("seed", task.seed).field("time_limit", remaining)
+                                 .field("target", task.budget.targetMakespan).field("stagnation", task.budget.stagnationLimit)
+                                 .field("lower_bound", task.budget.lowerBound).field("sa_batch", task.tuning.moveBatch)
+                                 .field("sa_cache", task.tuning.solutionCache)
+                                 .text("sa_schedule", AnnealingSchedule::coolingName(task.tuning.annealing.cooling))
+                                 .flag("sa_calibrate", task.tuning.annealing.calibrate)
+                                 .field("sa_reheat", task.tuning.annealing.reheatInterval).flag("from_incumbent", task.fromIncumbent)
+                                 .flag("progress", (bool)task.improved).str());
+        ++stats.tasks;
+    }
+
+    // Wymaga blokady mtx
+    void syncIncumbent(Worker &worker, int key, const InstanceEntry &entry)
+    {
+        long long &known = worker.incumbents[key];
+        if (entry.incumbentVersion <= known || entry.incumbent.empty())
+            return;
+        worker.channel->send(LinkMessage("incumbent").field("instance", key).field("cmax", entry.incumbentCmax)
+                                 .text("sequence", worker_link::joinInts(entry.incumbent)).str());
+        known = entry.incumbentVersion;
+    }
+
+    // Okresowo: rozesłanie najlepszych rozwiązań i kontrola procesów lokalnych.
+    // Gdy wszystkie uruchomione workery zakończyły się, zadania z kolejki kończą się statusem worker_error
+    void tickLoop()
+    {
+        auto interval = std::chrono::milliseconds(std::max(10, options.broadcastInterval));
+        auto waitingSince = Clock::now();
+        bool warned = false;
+        std::unique_lock<std::mutex> lock(mtx);
+        while (!closing)
+        {
+            changed.wait_for(lock, interval);
+            if (closing)
+                break;
+            for (auto &w : workers)
+                if (w->alive && w->slots > 0)
+                    for (int key : w->instances)
+                        syncIncumbent(*w, key, instances.at(key));
+
+            children.erase(std::remove_if(children.begin(), children.end(), [](pid_t pid)
+                                          { return ::waitpid(pid, nullptr, WNOHANG) == pid; }),
+                           children.end());
+            bool anyAlive = std::any_of(workers.begin(), workers.end(), [](const auto &w)
+                                        { return w->alive; });
+            if (anyAlive || queue.empty())
+            {
+                waitingSince = Clock::now();
+                warned = false;
+                continue;
+            }
+            if (spawned && children.empty())
+            {
+                std::vector<Completion> completions;
+                for (auto &entry : queue)
+                {
+                    RemoteResult result;
+                    result.status = "worker_error";
+                    result.message = "no workers left";
+                    completions.emplace_back(std::move(entry.second), result);
+                }
+                queue.clear();
+                std::cerr << "Coordinator: all workers exited, " << completions.size() << " task(s) not run" << std::endl;
+                lock.unlock();
+                complete(completions);
+                lock.lock();
+            }
+            else if (!warned && Clock::now() - waitingSince > std::chrono::seconds(5))
+            {
+                std::cerr << "Coordinator: waiting for workers on " << endpoint << " (" << queue.size() << " task(s) queued)" << std::endl;
+                warned = true;
+            }
+        }
+    }
+
+    static RemoteResult parseResult(const FlatJson &message, int worker)
+    {
+        RemoteResult r;
+        r.worker = worker;
+        r.status = message.text("status", "ok");
+        r.message = message.text("message");
+        r.jobs = (int)message.integer("jobs", 0);
+        r.machines = (int)message.integer("machines", 0);
+        r.result.makespan = message.number("cmax", 0.0);
+        r.result.seconds = message.number("seconds", 0.0);
+        r.result.iterations = message.integer("iterations", 0);
+        r.result.stopReason = message.text("stop_reason");
+        r.result.sequence = worker_link::splitInts(message.text("sequence"));
+        return r;
+    }
+};
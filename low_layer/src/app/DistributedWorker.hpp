@@ -0,0 +1,223 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "../core/Instance.hpp"
+#include "../core/SolveBudget.hpp"
+#include "../core/Telemetry.hpp"
+#include "../core/ThreadPool.hpp"
+#include "Pipeline.hpp"
+#include "RunOptions.hpp"
+#include "WorkerLink.hpp"
+
+// Worker trybu rozproszonego (pfsp_sdst --worker=ADRES [--threads=N]): łączy się z koordynatorem
+// (ponawiając przez 30 s), zgłasza --threads slotów i liczy zadania na puli wątków, każde
+// jednowątkowo jak w trybie wsadowym. Instancje przychodzą w formacie binarnym i zostają w pamięci
+// do komunikatu "drop". Koniec połączenia albo "shutdown" przerywa bieżące zadania i kończy proces.
+class DistributedWorker
+{
+private:
+    // Poprawy zadania wysyłane do koordynatora (wspólny najlepszy wynik portfolio); reszta zdarzeń pomijana
+    class ProgressSink : public TelemetrySink
+    {
+    private:
+        MessageChannel &channel;
+        long long task;
+
+    public:
+        ProgressSink(MessageChannel &link, long long id) : channel(link), task(id) { configureFrames(false, 0, 0); }
+        void write(const std::string &) override {}
+        void improved(long long iter, double cmax, const std::vector<int> *sequence) override
+        {
+            LinkMessage message("improved");
+            message.field("task", task).field("iteration", iter).field("cmax", (long long)cmax);
+            if (sequence)
+                message.text("sequence", worker_link::joinInts(*sequence));
+            channel.send(message.str());
+        }
+    };
+
+    struct Task
+    {
+        long long id = -1;
+        int instance = -1;
+        std::string pipeline;
+        int seed = 1;
+        SolveBudget budget;
+        PipelineOptions tuning;
+        bool fromIncumbent = false;
+        bool progress = false;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+    };
+
+    RunOptions options;
+    std::shared_ptr<MessageChannel> channel;
+    std::mutex mtx;
+    std::map<int, std::shared_ptr<const Instance>> instances; // nullptr = nieudane wczytanie
+    std::map<int, std::vector<int>> incumbents;
+    std::map<long long, std::shared_ptr<std::atomic<bool>>> running; // przyjęte i nieukończone
+    long long completed = 0;
+
+public:
+    explicit DistributedWorker(const RunOptions &runOptions) : options(runOptions) {}
+
+    int run(const std::string &endpoint)
+    {
+        int fd = -1;
+        for (int attempt = 0; attempt < 300 && (fd = worker_link::connectTo(endpoint)) < 0; ++attempt)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (fd < 0)
+        {
+            std::cerr << "Error: cannot connect to coordinator at " << endpoint << std::endl;
+            return 1;
+        }
+        channel = std::make_shared<MessageChannel>(fd);
+        char host[256] = {};
+        ::gethostname(host, sizeof(host) - 1);
+        channel->send(LinkMessage("hello").field("slots", options.threads)
+                          .text("name", std::string(host) + ":" + std::to_string(::getpid())).str());
+        std::cerr << "Worker: connected to " << endpoint << ", threads=" << options.threads << std::endl;
+
+        ThreadPool pool(options.threads);
+        FlatJson message;
+        std::vector<char> payload;
+        try
+        {
+            while (channel->receive(message, payload) && handle(pool, message, payload))
+                ;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            for (auto &entry : running)
+                entry.second->store(true);
+        }
+        pool.wait();
+        std::cerr << "Worker: " << completed << " task(s) done, disconnected" << std::endl;
+        return 0;
+    }
+
+private:
+    // false = koniec pracy ("shutdown")
+    bool handle(ThreadPool &pool, const FlatJson &message, std::vector<char> &payload)
+    {
+        std::string type = message.text("type");
+        int key = (int)message.integer("instance", -1);
+        if (type == "instance")
+        {
+            auto instance = std::make_shared<Instance>(message.text("name", "remote"));
+            if (!instance->loadFromBuffer(std::move(payload)))
+                instance.reset(); // zadania na niej kończą się statusem load_error
+            std::lock_guard<std::mutex> lock(mtx);
+            instances[key] = instance;
+        }
+        else if (type == "drop")
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            instances.erase(key);
+            incumbents.erase(key);
+        }
+        else if (type == "incumbent")
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            incumbents[key] = worker_link::splitInts(message.text("sequence"));
+        }
+        else if (type == "task")
+        {
+            Task task;
+            task.id = message.integer("task", -1);
+            task.instance = key;
+            task.pipeline = message.text("pipeline", "neh");
+            task.seed = (int)message.integer("seed", 1);
+            task.budget.timeLimit = message.number("time_limit", 0.0);
+            task.budget.targetMakespan = message.integer("target", 0);
+            task.budget.stagnationLimit = message.integer("stagnation", 0);
+            task.budget.lowerBound = message.integer("lower_bound", 0);
+            task.tuning.moveBatch = std::max(1, (int)message.integer("sa_batch", 1));
+            task.tuning.solutionCache = std::max(0, (int)message.integer("sa_cache", 0));
+            AnnealingSchedule::parseCooling(message.text("sa_schedule", "geometric"), task.tuning.annealing.cooling);
+            task.tuning.annealing.calibrate = message.flag("sa_calibrate", false);
+            task.tuning.annealing.reheatInterval = std::max(0, (int)message.integer("sa_reheat", 0));
+            task.fromIncumbent = message.flag("from_incumbent", false);
+            task.progress = message.flag("progress", false);
+            task.cancelled = std::make_shared<std::atomic<bool>>(false);
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                running[task.id] = task.cancelled;
+            }
+            pool.submit([this, task]() mutable
+                        { execute(task); });
+        }
+        else if (type == "cancel")
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            auto it = running.find(message.integer("task", -1));
+            if (it != running.end())
+                it->second->store(true);
+        }
+        else if (type == "shutdown")
+            return false;
+        return true;
+    }
+
+    void execute(Task &task)
+    {
+        std::string reply;
+        try
+        {
+            std::shared_ptr<const Instance> instance;
+            Schedule start;
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                auto it = instances.find(task.instance);
+                if (it != instances.end())
+                    instance = it->second;
+                auto best = incumbents.find(task.instance);
+                if (task.fromIncumbent && best != incumbents.end())
+                    start = Schedule(best->second);
+            }
+            if (!instance)
+                reply = LinkMessage("done").field("task", task.id).text("status", "load_error").str();
+            else
+            {
+                Pipeline pipeline = parsePipeline(task.pipeline);
+                if (task.fromIncumbent && start.getJobSequence().empty())
+                    throw std::runtime_error("no incumbent to restart from");
+                task.budget.start();
+                ProgressSink sink(*channel, task.id);
+                PipelineResult result;
+                {
+                    TelemetryRoute route(sink);
+                    CancellationScope scope(*task.cancelled);
+                    result = runPipeline(*instance, pipeline, task.seed, task.budget, task.progress, start, task.tuning);
+                }
+                reply = LinkMessage("done").field("task", task.id).text("status", task.cancelled->load() ? "cancelled" : "ok")
+                            .field("jobs", instance->getJobs()).field("machines", instance->getMachines())
+                            .field("cmax", (long long)result.makespan).field("seconds", result.seconds)
+                            .field("iterations", result.iterations).text("stop_reason", result.stopReason)
+                            .text("sequence", worker_link::joinInts(result.sequence)).str();
+            }
+        }
+        catch (const std::exception &e)
+        {
+            reply = LinkMessage("done").field("task", task.id).text("status", "error").text("message", e.what()).str();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            running.erase(task.id);
+            ++completed;
+        }
+        channel->send(reply);
+    }
+};
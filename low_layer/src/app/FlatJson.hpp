@@ -0,0 +1,188 @@
+#pragma once
+#include <map>
+#include <string>
+#include <stdexcept>
+
+// Płaski obiekt JSON z jednej linii protokołu serwera: {"klucz": "tekst" | liczba | true | false | null, ...}.
+// Zagnieżdżone obiekty i tablice nie są obsługiwane (zgłaszany błąd). Wartości przechowywane
+// są jako tekst; zły format lub typ zgłasza std::invalid_argument.
+class FlatJson
+{
+private:
+    std::map<std::string, std::string> values;
+
+public:
+    static FlatJson parse(const std::string &text)
+    {
+        FlatJson json;
+        std::size_t pos = 0;
+        skipSpace(text, pos);
+        expect(text, pos, '{');
+        skipSpace(text, pos);
+        if (pos < text.size() && text[pos] == '}')
+            ++pos;
+        else
+            for (;;)
+            {
+                skipSpace(text, pos);
+                std::string key = readString(text, pos);
+                skipSpace(text, pos);
+                expect(text, pos, ':');
+                skipSpace(text, pos);
+                json.values[key] = readValue(text, pos);
+                skipSpace(text, pos);
+                if (pos < text.size() && text[pos] == ',')
+                {
+                    ++pos;
+                    continue;
+                }
+                expect(text, pos, '}');
+                break;
+            }
+        skipSpace(text, pos);
+        if (pos != text.size())
+            throw std::invalid_argument("trailing characters after JSON object");
+        return json;
+    }
+
+    bool has(const std::string &key) const { return values.count(key) > 0; }
+
+    std::string text(const std::string &key, const std::string &fallback = "") const
+    {
+        auto it = values.find(key);
+        return it == values.end() ? fallback : it->second;
+    }
+
+    double number(const std::string &key, double fallback) const
+    {
+        auto it = values.find(key);
+        if (it == values.end())
+            return fallback;
+        try
+        {
+            std::size_t used = 0;
+            double value = std::stod(it->second, &used);
+            if (used == it->second.size())
+                return value;
+        }
+        catch (const std::exception &)
+        {
+        }
+        throw std::invalid_argument("field " + key + " must be a number");
+    }
+
+    long long integer(const std::string &key, long long fallback) const
+    {
+        double value = number(key, (double)fallback);
+        if (value != (double)(long long)value)
+            throw std::invalid_argument("field " + key + " must be an integer");
+        return (long long)value;
+    }
+
+    bool flag(const std::string &key, bool fallback) const
+    {
+        auto it = values.find(key);
+        if (it == values.end())
+            return fallback;
+        if (it->second == "true")
+            return true;
+        if (it->second == "false")
+            return false;
+        throw std::invalid_argument("field " + key + " must be true or false");
+    }
+
+private:
+    static void skipSpace(const std::string &text, std::size_t &pos)
+    {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r' || text[pos] == '\n'))
+            ++pos;
+    }
+
+    static void expect(const std::string &text, std::size_t &pos, char c)
+    {
+        if (pos >= text.size() || text[pos] != c)
+            throw std::invalid_argument(std::string("expected '") + c + "' at offset " + std::to_string(pos));
+        ++pos;
+    }
+
+    static std::string readString(const std::string &text, std::size_t &pos)
+    {
+        expect(text, pos, '"');
+        std::string out;
+        while (pos < text.size() && text[pos] != '"')
+        {
+            char c = text[pos++];
+            if (c != '\\')
+            {
+                out += c;
+                continue;
+            }
+            if (pos >= text.size())
+                break;
+            char e = text[pos++];
+            switch (e)
+            {
+            case 'n':
+                out += '\n';
+                break;
+            case 't':
+                out += '\t';
+                break;
+            case 'r':
+                out += '\r';
+                break;
+            case 'b':
+                out += '\b';
+                break;
+            case 'f':
+                out += '\f';
+                break;
+            case 'u':
+            {
+                if (pos + 4 > text.size())
+                    throw std::invalid_argument("truncated \\u escape");
+                unsigned code = (unsigned)std::stoul(text.substr(pos, 4), nullptr, 16);
+                pos += 4;
+                // UTF-8 (bez par surogatów - ścieżki i identyfikatory)
+                if (code < 0x80)
+                    out += (char)code;
+                else if (code < 0x800)
+                {
+                    out += (char)(0xC0 | (code >> 6));
+                    out += (char)(0x80 | (code & 0x3F));
+                }
+                else
+                {
+                    out += (char)(0xE0 | (code >> 12));
+                    out += (char)(0x80 | ((code >> 6) & 0x3F));
+                    out += (char)(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default: // \" \\ \/
+                out += e;
+            }
+        }
+        expect(text, pos, '"');
+        return out;
+    }
+
+    static std::string readValue(const std::string &text, std::size_t &pos)
+    {
+        if (pos >= text.size())
+            throw std::invalid_argument("missing value");
+        char c = text[pos];
+        if (c == '"')
+            return readString(text, pos);
+        if (c == '{' || c == '[')
+            throw std::invalid_argument("nested objects and arrays are not supported");
+        std::size_t begin = pos;
+        while (pos < text.size() && text[pos] != ',' && text[pos] != '}' && text[pos] != ' ' && text[pos] != '\t' &&
+               text[pos] != '\r' && text[pos] != '\n')
+            ++pos;
+        std::string token = text.substr(begin, pos - begin);
+        if (token.empty())
+            throw std::invalid_argument("missing value at offset " + std::to_string(begin));
+        return token;
+    }
+};
@@ -0,0 +1,173 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include "../core/Instance.hpp"
+#include "../core/MappedFile.hpp"
+
+// Wczytane instancje serwera (LRU po ścieżce). Wpis jest aktualny, dopóki plik ma ten sam czas
+// modyfikacji i rozmiar; zmieniony plik jest wczytywany ponownie. Hash treści (FNV-1a) pozwala
+// klientowi sprawdzić, którą wersję pliku rozwiązano. Jednoczesne żądania tej samej ścieżki
+// czekają na jedno wczytanie (shared_future); instancje są niezmienne i współdzielone przez
+// shared_ptr, więc usunięcie z cache nie przerywa trwających obliczeń.
+class InstanceCache
+{
+public:
+    struct Loaded
+    {
+        std::shared_ptr<const Instance> instance;
+        std::uint64_t hash = 0;
+        bool cached = false; // trafienie (bez wczytywania)
+    };
+
+    struct Stats
+    {
+        long long hits = 0;
+        long long misses = 0;
+        long long reloads = 0; // plik zmieniony od wczytania
+        long long evictions = 0;
+        int entries = 0;
+    };
+
+private:
+    struct Entry
+    {
+        std::shared_future<Loaded> value;
+        std::filesystem::file_time_type mtime;
+        std::uintmax_t size = 0;
+        long long generation = 0; // odróżnia ponowne wczytanie tej samej ścieżki
+        std::list<std::string>::iterator position;
+    };
+
+    std::size_t capacity;
+    SetupEncoding encoding;
+    bool hugePages;
+    std::mutex mtx;
+    std::map<std::string, Entry> entries;
+    std::list<std::string> recent; // od najświeższej
+    Stats stats;
+    long long generations = 0;
+
+public:
+    InstanceCache(int maxEntries, SetupEncoding setupEncoding = SetupEncoding::Narrowest, bool useHugePages = false)
+        : capacity((std::size_t)std::max(1, maxEntries)), encoding(setupEncoding), hugePages(useHugePages) {}
+
+    // Instancja z cache albo wczytana; błąd wczytania zgłasza std::runtime_error
+    Loaded acquire(const std::string &path)
+    {
+        std::error_code ec;
+        auto mtime = std::filesystem::last_write_time(path, ec);
+        std::uintmax_t size = ec ? 0 : std::filesystem::file_size(path, ec);
+        if (ec)
+            throw std::runtime_error("cannot open file " + path);
+
+        std::promise<Loaded> promise;
+        std::shared_future<Loaded> value;
+        long long generation = 0; // > 0 = ten wątek wczytuje
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            auto it = entries.find(path);
+            if (it != entries.end() && it->second.mtime == mtime && it->second.size == size)
+            {
+                ++stats.hits;
+                recent.splice(recent.begin(), recent, it->second.position);
+                value = it->second.value;
+            }
+            else
+            {
+                if (it != entries.end())
+                {
+                    ++stats.reloads;
+                    recent.erase(it->second.position);
+                    entries.erase(it);
+                }
+                ++stats.misses;
+                recent.push_front(path);
+                Entry &entry = entries[path];
+                entry.value = promise.get_future().share();
+                entry.mtime = mtime;
+                entry.size = size;
+                entry.position = recent.begin();
+                entry.generation = generation = ++generations;
+                evictOverflow();
+            }
+        }
+        if (generation > 0)
+            return loadInto(path, promise, generation);
+
+        Loaded loaded = value.get(); // ewentualnie czeka na wczytanie w innym wątku
+        loaded.cached = true;
+        return loaded;
+    }
+
+    Stats getStats()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        Stats out = stats;
+        out.entries = (int)entries.size();
+        return out;
+    }
+
+    // Hash treści pliku (FNV-1a 64)
+    static std::uint64_t contentHash(const char *data, std::size_t size)
+    {
+        std::uint64_t h = 1469598103934665603ULL;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            h ^= (unsigned char)data[i];
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+private:
+    // Pod mtx: najdawniej używane wpisy ponad pojemność (bieżący jest na początku listy)
+    void evictOverflow()
+    {
+        while (entries.size() > capacity)
+        {
+            entries.erase(recent.back());
+            recent.pop_back();
+            ++stats.evictions;
+        }
+    }
+
+    // Bez mtx: wczytanie i przekazanie wyniku czekającym; nieudany wpis jest usuwany
+    Loaded loadInto(const std::string &path, std::promise<Loaded> &promise, long long generation)
+    {
+        Loaded loaded;
+        try
+        {
+            MappedFile file;
+            if (!file.open(path))
+                throw std::runtime_error("cannot open file " + path);
+            loaded.hash = contentHash(file.data(), file.size());
+
+            auto instance = std::make_shared<Instance>(path);
+            instance->setStorageOptions(SetupLayout::PrevJobMajor, encoding, hugePages);
+            if (!instance->loadFromFile(false))
+                throw std::runtime_error("cannot load instance " + path);
+            loaded.instance = instance;
+            promise.set_value(loaded);
+        }
+        catch (...)
+        {
+            promise.set_exception(std::current_exception());
+            std::lock_guard<std::mutex> lock(mtx);
+            auto it = entries.find(path);
+            if (it != entries.end() && it->second.generation == generation)
+            {
+                recent.erase(it->second.position);
+                entries.erase(it);
+            }
+            throw;
+        }
+        return loaded;
+    }
+};
@@ -0,0 +1,207 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include "../core/Instance.hpp"
+#include "../core/Schedule.hpp"
+#include "../core/NEHWithProgress.hpp"
+#include "../core/SimulatedAnnealing.hpp"
+#include "../core/IteratedGreedy.hpp"
+#include "../core/LocalSearch.hpp"
+#include "../core/BranchAndBound.hpp"
+#include "RunOptions.hpp"
+
+// Etap potoku: nazwa algorytmu i jego parametry pozycyjne
+struct PipelineStage
+{
+    std::string algorithm;
+    std::vector<std::string> params;
+};
+
+// Potok zapisany jako "neh+simulated_annealing:50000:100:0.9975"
+// (etapy rozdzielone '+', parametry etapu ':')
+struct Pipeline
+{
+    std::string spec;
+    std::vector<PipelineStage> stages;
+
+    // Czy wynik zależy od ziarna (NEH, przeszukiwanie lokalne i B&B są deterministyczne)
+    bool randomized() const
+    {
+        for (const auto &stage : stages)
+            if (stage.algorithm != "neh" && stage.algorithm != "local_search" && stage.algorithm != "branch_and_bound")
+                return true;
+        return false;
+    }
+};
+
+// Ustawienia etapów spoza specyfikacji potoku (opcje --sa-*), wspólne dla zadań jednego przebiegu
+struct PipelineOptions
+{
+    int moveBatch = 1;     // --sa-batch
+    int solutionCache = 0; // --sa-cache: wpisy cache odwiedzonych rozwiązań (osobny na etap SA zadania)
+    AnnealingSchedule annealing; // --sa-schedule, --sa-calibrate, --sa-reheat
+};
+
+inline PipelineOptions pipelineOptions(const RunOptions &options)
+{
+    PipelineOptions tuning;
+    tuning.moveBatch = options.moveBatch;
+    tuning.solutionCache = options.saCache;
+    tuning.annealing = options.annealing;
+    return tuning;
+}
+
+struct PipelineResult
+{
+    std::vector<int> sequence;
+    double makespan = 0.0;
+    double seconds = 0.0;
+    long long iterations = 0;
+    std::string stopReason; // ostatni etap zatrzymany przez budżet/przerwanie (pusty = bez przerwania)
+};
+
+inline std::vector<std::string> splitString(const std::string &text, char sep)
+{
+    std::vector<std::string> parts;
+    std::string::size_type begin = 0;
+    for (;;)
+    {
+        std::string::size_type end = text.find(sep, begin);
+        parts.push_back(text.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+        if (end == std::string::npos)
+            break;
+        begin = end + 1;
+    }
+    return parts;
+}
+
+// local_search[:insertion|swap|both[:first|best]] - domyślnie wstawianie, pierwsza poprawa
+inline std::pair<LocalSearch::Neighborhood, LocalSearch::Strategy> localSearchParams(const PipelineStage &stage)
+{
+    LocalSearch::Neighborhood neighborhood = LocalSearch::Neighborhood::Insertion;
+    LocalSearch::Strategy strategy = LocalSearch::Strategy::FirstImprovement;
+    if (stage.params.size() > 0 && !stage.params[0].empty() && !LocalSearch::parseNeighborhood(stage.params[0], neighborhood))
+        throw std::invalid_argument("invalid neighborhood '" + stage.params[0] + "' for local_search");
+    if (stage.params.size() > 1 && !stage.params[1].empty() && !LocalSearch::parseStrategy(stage.params[1], strategy))
+        throw std::invalid_argument("invalid strategy '" + stage.params[1] + "' for local_search");
+    return {neighborhood, strategy};
+}
+
+inline Pipeline parsePipeline(const std::string &spec)
+{
+    Pipeline pipeline;
+    pipeline.spec = spec;
+    for (const auto &stageText : splitString(spec, '+'))
+    {
+        auto parts = splitString(stageText, ':');
+        PipelineStage stage;
+        stage.algorithm = parts[0];
+        stage.params.assign(parts.begin() + 1, parts.end());
+        if (stage.algorithm != "neh" && stage.algorithm != "simulated_annealing" && stage.algorithm != "iterated_greedy" &&
+            stage.algorithm != "local_search" && stage.algorithm != "branch_and_bound")
+            throw std::invalid_argument("unknown algorithm '" + stage.algorithm + "' in pipeline " + spec);
+        if (stage.algorithm == "local_search")
+            localSearchParams(stage);
+        pipeline.stages.push_back(stage);
+    }
+    return pipeline;
+}
+
+// Parametr pozycyjny etapu albo wartość domyślna
+inline double stageParam(const PipelineStage &stage, size_t index, double fallback)
+{
+    if (index >= stage.params.size() || stage.params[index].empty())
+        return fallback;
+    try
+    {
+        return std::stod(stage.params[index]);
+    }
+    catch (const std::exception &)
+    {
+        throw std::invalid_argument("invalid parameter '" + stage.params[index] + "' for " + stage.algorithm);
+    }
+}
+
+// Uruchamia potok; bez verbose nie wypisuje postępu (bezpieczne dla wielu wątków naraz).
+// Budżet (limit czasu od budget.start(), cel, stagnacja) dotyczy całego potoku.
+// initial - rozwiązanie startowe pierwszego etapu poprawiającego (NEH i tak buduje własne)
+inline PipelineResult runPipeline(const Instance &instance, const Pipeline &pipeline, int seed,
+                                  const SolveBudget &budget = SolveBudget(), bool verbose = false,
+                                  const Schedule &initial = Schedule(), const PipelineOptions &tuning = PipelineOptions())
+{
+    auto start = std::chrono::steady_clock::now();
+    PipelineResult result;
+    Schedule current = initial;
+
+    for (const auto &stage : pipeline.stages)
+    {
+        if (stage.algorithm == "neh")
+        {
+            NEHWithProgress neh(instance);
+            neh.setVerbose(verbose);
+            neh.setBudget(budget);
+            current = neh.solve();
+            result.iterations += std::max(0, instance.getJobs() - 1);
+            if (neh.wasStopped())
+                result.stopReason = "neh stopped early";
+        }
+        else if (stage.algorithm == "simulated_annealing")
+        {
+            SimulatedAnnealing sa(instance, seed);
+            sa.setParameters((int)stageParam(stage, 0, 50000), stageParam(stage, 1, 100.0), stageParam(stage, 2, 0.9975));
+            sa.setMoveBatch(tuning.moveBatch);
+            sa.setSchedule(tuning.annealing);
+            std::unique_ptr<SolutionCache> cache;
+            if (tuning.solutionCache > 0)
+                cache = std::make_unique<SolutionCache>((std::size_t)tuning.solutionCache);
+            sa.setSolutionCache(cache.get());
+            sa.setVerbose(verbose);
+            sa.setBudget(budget);
+            current = sa.solve(current);
+            result.iterations += sa.getIteration();
+            result.stopReason = sa.getStopReason();
+        }
+        else if (stage.algorithm == "iterated_greedy")
+        {
+            IteratedGreedy greedy(instance, seed);
+            greedy.setParameters((int)stageParam(stage, 0, 2000), (int)stageParam(stage, 1, 4), stageParam(stage, 2, 0.4));
+            greedy.setVerbose(verbose);
+            greedy.setBudget(budget);
+            current = greedy.solve(current);
+            result.iterations += greedy.getIteration();
+            result.stopReason = greedy.getStopReason();
+        }
+        else if (stage.algorithm == "local_search")
+        {
+            // Jeden wątek na zadanie - równoległość trybu wsadowego jest na poziomie zadań
+            auto params = localSearchParams(stage);
+            LocalSearch search(instance, 1);
+            search.setNeighborhood(params.first);
+            search.setStrategy(params.second);
+            search.setVerbose(verbose);
+            search.setBudget(budget);
+            current = search.solve(current);
+            result.iterations += search.getStats().evaluated;
+            result.stopReason = search.getStopReason();
+        }
+        else if (stage.algorithm == "branch_and_bound")
+        {
+            BranchAndBound exact(instance, 1);
+            exact.setNodeLimit((long long)stageParam(stage, 0, 0));
+            exact.setVerbose(verbose);
+            exact.setBudget(budget);
+            current = exact.solve(current);
+            result.iterations += exact.getStats().nodes;
+            result.stopReason = exact.getStopReason();
+        }
+    }
+
+    result.sequence = current.getJobSequence();
+    result.makespan = instance.computeMakespan(result.sequence);
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
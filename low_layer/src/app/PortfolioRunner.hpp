@@ -0,0 +1,382 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <climits>
+#include <exception>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include "../core/Instance.hpp"
+#include "../core/LowerBound.hpp"
+#include "../core/Telemetry.hpp"
+#include "DistributedCoordinator.hpp"
+#include "Pipeline.hpp"
+#include "RunOptions.hpp"
+
+// Portfolio: kilka potoków liczonych jednocześnie na jednej instancji, każdy członek w osobnym wątku.
+// Poprawy członków (zdarzenia RESULT przechwycone przez odbiorcę telemetrii wątku) trafiają do
+// wspólnego najlepszego makespanu; sekwencja dołączana jest po zakończeniu przebiegu członka.
+// Przy limicie czasu członek, który skończył albo utknął (--stagnation), startuje ponownie od
+// wspólnego najlepszego rozwiązania (potok bez początkowego NEH), aż do końca budżetu.
+// Cel / dolne ograniczenie osiągnięte przez jednego członka przerywa pozostałych.
+// Z --coordinator / --spawn-workers przebiegi członków liczą workery: wątek członka czeka na wynik,
+// poprawy workera trafiają do wspólnego wyniku, a restart startuje od rozesłanego najlepszego rozwiązania.
+class PortfolioRunner
+{
+public:
+    struct Improvement
+    {
+        int member;
+        long long iteration; // iteracja etapu członka
+        long long makespan;
+        double seconds;      // od startu portfolio
+    };
+
+    struct MemberReport
+    {
+        std::string spec;
+        long long best = LLONG_MAX;
+        int improvements = 0; // poprawy wspólnego wyniku
+        int restarts = 0;
+        long long iterations = 0;
+        double seconds = 0.0;
+        std::string stopReason;
+    };
+
+private:
+    // Zdarzenia wątku członka: poprawy (z sekwencją - start restartów innych członków) do wspólnego wyniku,
+    // reszta (logi, ramki) pomijana
+    class MemberSink : public TelemetrySink
+    {
+    private:
+        PortfolioRunner &owner;
+        int member;
+
+    public:
+        MemberSink(PortfolioRunner &runner, int index) : owner(runner), member(index) { configureFrames(false, 0, 0); }
+        void write(const std::string &) override {}
+        void improved(long long iter, double cmax, const std::vector<int> *sequence) override
+        {
+            owner.offer(member, iter, (long long)cmax, sequence);
+        }
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    RunOptions options;
+    std::string instancePath;
+    std::vector<Pipeline> members;
+
+    const Instance *instance = nullptr;
+    DistributedCoordinator *coordinator = nullptr;
+    int remoteInstance = -1;
+    SolveBudget budget;
+    Clock::time_point started;
+    std::atomic<long long> incumbent{LLONG_MAX}; // odczyt bez blokady; zmiany pod mtx
+    std::atomic<bool> stopToken{false};
+
+    std::mutex mtx;
+    std::condition_variable changed;
+    std::vector<int> bestSeq;
+    long long bestSeqCmax = LLONG_MAX;
+    std::vector<Improvement> improvements;
+    std::vector<MemberReport> reports;
+    int running = 0;
+    std::string stopReason;
+    std::exception_ptr firstError;
+
+public:
+    // Bez potoków - domyślny zestaw: NEH + SA o dwóch szybkościach chłodzenia, SA od losowego startu, NEH + IG
+    PortfolioRunner(const RunOptions &runOptions, const std::string &path, const std::vector<std::string> &pipelineSpecs)
+        : options(runOptions), instancePath(path)
+    {
+        std::vector<std::string> specs = pipelineSpecs;
+        if (specs.empty())
+            specs = {"neh+simulated_annealing:50000:100:0.9975", "neh+simulated_annealing:50000:100:0.9995",
+                     "simulated_annealing", "neh+iterated_greedy"};
+        for (const auto &spec : specs)
+            members.push_back(parsePipeline(spec));
+    }
+
+    int run()
+    {
+        Instance inst(instancePath);
+        inst.setStorageOptions(SetupLayout::PrevJobMajor, options.setupEncoding, options.hugePages);
+        if (!inst.loadFromFile())
+            return 1;
+        instance = &inst;
+
+        budget.timeLimit = options.timeLimit;
+        budget.targetMakespan = options.target;
+        budget.start();
+        long long lowerBound = LowerBound(inst).compute();
+        budget.lowerBound = lowerBound;
+        LogLine() << "Lower bound: " << lowerBound;
+
+        std::unique_ptr<DistributedCoordinator> distributed;
+        if (DistributedCoordinator::requested(options))
+        {
+            auto bytes = DistributedCoordinator::encode(inst);
+            if (!bytes)
+                throw std::runtime_error("instance cannot be sent to workers (use --setup-storage=narrow or wide)");
+            distributed = std::make_unique<DistributedCoordinator>(options);
+            coordinator = distributed.get();
+            remoteInstance = coordinator->addInstance(instancePath, [bytes]
+                                                      { return bytes; });
+        }
+
+        int count = (int)members.size();
+        LogLine() << "\n=== Portfolio: " << count << " members ===";
+        for (int i = 0; i < count; ++i)
+            LogLine() << "Member " << i << ": " << members[i].spec;
+        if (!budget.hasTimeLimit())
+            LogLine() << "No --time-limit - each member runs its pipeline once (no restarts)";
+        if (coordinator)
+            LogLine() << "Members run on distributed workers";
+
+        reports.assign(count, MemberReport());
+        for (int i = 0; i < count; ++i)
+            reports[i].spec = members[i].spec;
+        started = Clock::now();
+        running = count;
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < count; ++i)
+            threads.emplace_back([this, i]
+                                 { runMember(i); });
+
+        // Wątek główny przekazuje poprawy do strumienia (RESULT z numerem członka jako chain)
+        std::size_t emitted = 0;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            for (;;)
+            {
+                changed.wait(lock, [&]
+                             { return improvements.size() > emitted || running == 0; });
+                while (emitted < improvements.size())
+                {
+                    Improvement imp = improvements[emitted++];
+                    lock.unlock();
+                    Telemetry::get().result(imp.iteration, (double)imp.makespan, imp.member);
+                    LogLine() << "PORTFOLIO improvement: " << imp.makespan << " by member " << imp.member << " ("
+                              << members[imp.member].spec << ") at " << (long long)(imp.seconds * 1000) << " ms";
+                    lock.lock();
+                }
+                if (running == 0)
+                    break;
+            }
+        }
+        for (auto &t : threads)
+            t.join();
+        if (coordinator)
+            coordinator->report(std::cerr);
+        if (firstError)
+            std::rethrow_exception(firstError);
+
+        report(lowerBound);
+        return 0;
+    }
+
+private:
+    void runMember(int index)
+    {
+        MemberSink sink(*this, index);
+        TelemetryRoute route(sink);
+        CancellationScope scope(stopToken);
+        auto memberStart = Clock::now();
+
+        try
+        {
+            SolveBudget memberBudget = budget;
+            memberBudget.stagnationLimit = options.stagnation; // stagnacja = członek utknął
+            Pipeline pipeline = members[index];
+            Pipeline restart = withoutConstruction(members[index]);
+            std::vector<int> lastStart;
+            Schedule start;
+
+            for (int run = 0;; ++run)
+            {
+                int seed = options.seed + index + run * (int)members.size();
+                PipelineResult result;
+                if (!execute(index, pipeline, seed, memberBudget, start, result))
+                    break;
+                offer(index, result.iterations, (long long)result.makespan, &result.sequence);
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    MemberReport &r = reports[index];
+                    r.iterations += result.iterations;
+                    r.best = std::min(r.best, (long long)result.makespan);
+                    r.stopReason = result.stopReason;
+                }
+
+                if (!budget.hasTimeLimit() || budget.timeUp() || Cancellation::requested() || restart.stages.empty())
+                    break;
+
+                std::vector<int> seq;
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    seq = bestSeq;
+                    ++reports[index].restarts;
+                }
+                // Deterministyczny potok od tego samego rozwiązania dałby ten sam wynik
+                if (!restart.randomized() && seq == lastStart)
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    --reports[index].restarts;
+                    break;
+                }
+                lastStart = seq;
+                start = Schedule(seq);
+                pipeline = restart;
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!firstError)
+                firstError = std::current_exception();
+            stopToken.store(true);
+        }
+
+        std::lock_guard<std::mutex> lock(mtx);
+        reports[index].seconds = std::chrono::duration<double>(Clock::now() - memberStart).count();
+        --running;
+        changed.notify_all();
+    }
+
+    // Przebieg członka lokalnie albo u workera; false = zadanie anulowane, zanim trafiło do workera
+    bool execute(int index, const Pipeline &pipeline, int seed, const SolveBudget &memberBudget, const Schedule &start,
+                 PipelineResult &result)
+    {
+        if (!coordinator)
+        {
+            result = runPipeline(*instance, pipeline, seed, memberBudget, true, start, pipelineOptions(options));
+            return true;
+        }
+
+        RemoteTask task;
+        task.instance = remoteInstance;
+        task.pipeline = stagesSpec(pipeline);
+        task.seed = seed;
+        task.budget = memberBudget;
+        task.tuning = pipelineOptions(options);
+        task.fromIncumbent = !start.getJobSequence().empty();
+        task.improved = [this, index](long long iteration, long long makespan, const std::vector<int> *sequence)
+        { offer(index, iteration, makespan, sequence); };
+        std::promise<RemoteResult> promise;
+        auto future = promise.get_future();
+        task.done = [&promise](const RemoteResult &r)
+        { promise.set_value(r); };
+
+        long long id = coordinator->submit(std::move(task));
+        bool cancelSent = false;
+        while (future.wait_for(std::chrono::milliseconds(20)) != std::future_status::ready)
+            if (!cancelSent && Cancellation::requested())
+            {
+                coordinator->cancel(id);
+                cancelSent = true;
+            }
+        RemoteResult remote = future.get();
+        if (remote.status == "cancelled" && remote.result.sequence.empty())
+            return false;
+        if (remote.status != "ok" && remote.status != "cancelled")
+            throw std::runtime_error("member " + std::to_string(index) + " failed on worker: " + remote.status +
+                                     (remote.message.empty() ? "" : " (" + remote.message + ")"));
+        result = remote.result;
+        return true;
+    }
+
+    // Zgłoszenie wyniku członka; seq != nullptr - także sekwencja (start dla restartów)
+    void offer(int member, long long iteration, long long makespan, const std::vector<int> *seq)
+    {
+        if (!seq && makespan >= incumbent.load(std::memory_order_relaxed))
+            return;
+        std::lock_guard<std::mutex> lock(mtx);
+        if (makespan < incumbent.load(std::memory_order_relaxed))
+        {
+            incumbent.store(makespan, std::memory_order_relaxed);
+            double seconds = std::chrono::duration<double>(Clock::now() - started).count();
+            improvements.push_back({member, iteration, makespan, seconds});
+            ++reports[member].improvements;
+            if (budget.targetReached((double)makespan) && !stopToken.load())
+            {
+                stopReason = budget.targetReason((double)makespan);
+                stopToken.store(true);
+            }
+            changed.notify_all();
+        }
+        if (seq && makespan < bestSeqCmax)
+        {
+            bestSeq = *seq;
+            bestSeqCmax = makespan;
+            if (coordinator)
+                coordinator->setIncumbent(remoteInstance, makespan, bestSeq);
+        }
+    }
+
+    // Restart od wspólnego rozwiązania: początkowe etapy NEH (konstrukcja) są pomijane
+    static Pipeline withoutConstruction(const Pipeline &pipeline)
+    {
+        Pipeline out;
+        out.spec = pipeline.spec;
+        std::size_t first = 0;
+        while (first < pipeline.stages.size() && pipeline.stages[first].algorithm == "neh")
+            ++first;
+        out.stages.assign(pipeline.stages.begin() + first, pipeline.stages.end());
+        return out;
+    }
+
+    // Zapis etapów potoku (spec restartu różni się od spec członka)
+    static std::string stagesSpec(const Pipeline &pipeline)
+    {
+        std::string spec;
+        for (const auto &stage : pipeline.stages)
+        {
+            if (!spec.empty())
+                spec += '+';
+            spec += stage.algorithm;
+            for (const auto &param : stage.params)
+                spec += ':' + param;
+        }
+        return spec;
+    }
+
+    void report(long long lowerBound)
+    {
+        double wall = std::chrono::duration<double>(Clock::now() - started).count();
+        if (!stopReason.empty())
+            LogLine() << "Portfolio stopped: " << stopReason;
+        else if (Cancellation::requested())
+            LogLine() << "Portfolio stopped: cancelled";
+
+        LogLine() << "\n=== Portfolio members ===";
+        for (std::size_t i = 0; i < reports.size(); ++i)
+        {
+            const MemberReport &r = reports[i];
+            LogLine line;
+            line << "Member " << i << " (" << r.spec << "): best " << r.best << ", improvements " << r.improvements
+                 << ", restarts " << r.restarts << ", iterations " << r.iterations << ", time " << (long long)(r.seconds * 1000) << " ms";
+            if (!r.stopReason.empty())
+                line << ", stop: " << r.stopReason;
+        }
+
+        if (bestSeq.empty())
+            return;
+        int winner = improvements.empty() ? 0 : improvements.back().member;
+        LogLine() << "Best found by member " << winner << " (" << reports[winner].spec << ")";
+        LogLine() << "Portfolio wall time: " << (long long)(wall * 1000) << " ms";
+
+        LogLine() << "\n=== FINAL RESULT ===";
+        LogLine() << "Final best sequence: " << Schedule(bestSeq).toString();
+        double finalMakespan = instance->computeMakespan(bestSeq);
+        LogLine() << "Final best makespan: " << finalMakespan;
+        LogLine() << "Gap to lower bound: " << (lowerBound > 0 ? 100.0 * (finalMakespan - lowerBound) / lowerBound : 0.0) << "%"
+                  << (finalMakespan <= lowerBound ? " (optimal)" : "");
+        Schedule(bestSeq).emitFinalSlots(*instance);
+    }
+};
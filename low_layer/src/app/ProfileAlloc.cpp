@@ -0,0 +1,45 @@
+#include "../core/Profiler.hpp"
+#include <cstdlib>
+#include <new>
+
+#if PFSP_PROFILE
+// Globalne operator new/delete pfsp_sdst: liczą alokacje wątku dla --profile (zakresy Profiler::Scope
+// odejmują stan licznika z początku zakresu). Koszt bez profilowania: inkrementacja zmiennej wątku.
+namespace
+{
+    const bool hooked = (Profiler::allocationsHooked().store(true), true);
+
+    void *countedAlloc(std::size_t size)
+    {
+        ++Profiler::threadAllocations();
+        if (void *p = std::malloc(size ? size : 1))
+            return p;
+        throw std::bad_alloc();
+    }
+
+    void *countedAlignedAlloc(std::size_t size, std::align_val_t align)
+    {
+        ++Profiler::threadAllocations();
+        std::size_t alignment = (std::size_t)align;
+        if (alignment < sizeof(void *))
+            alignment = sizeof(void *);
+        void *p = nullptr;
+        if (::posix_memalign(&p, alignment, size ? size : 1) != 0)
+            throw std::bad_alloc();
+        return p;
+    }
+}
+
+void *operator new(std::size_t size) { return countedAlloc(size); }
+void *operator new[](std::size_t size) { return countedAlloc(size); }
+void *operator new(std::size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void *operator new[](std::size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+#endif
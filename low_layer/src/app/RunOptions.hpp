@@ -0,0 +1,231 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include "../core/FlatMatrix.hpp"
+#include "../core/AnnealingSchedule.hpp"
+
+// Opcje przekazywane jako --klucz=wartość, niezależnie od listy algorytmów
+struct RunOptions
+{
+    int threads = 1;           // > 1 = równoległe SA (wyspy) i przegląd sąsiedztwa w local_search
+    int migrationInterval = 0; // co ile iteracji wymiana najlepszych rozwiązań między wyspami
+    int seed = 1;              // ziarno bazowe SA
+    int moveBatch = 1;         // > 1 = ruch SA "najlepszy z K" oceniany wektorowo (BatchMakespan)
+    int saCache = 0;           // > 0 = cache odwiedzonych rozwiązań SA o tylu wpisach (wspólny dla wysp)
+    AnnealingSchedule annealing; // --sa-schedule=geometric|lundy-mees, --sa-calibrate, --sa-reheat=N
+
+    // Tryb wsadowy
+    std::string batch;         // katalog, maska (np. ../data/40_*.txt) lub pojedynczy plik
+    int seeds = 1;             // ziarna seed .. seed+seeds-1 dla potoków losowych
+    std::string output;        // plik wyników (.csv lub .json); pusty = CSV na stdout
+
+    std::string convert;       // zapis instancji w formacie binarnym zamiast rozwiązywania
+    bool portfolio = false;    // potoki z listy algorytmów liczone jednocześnie ze wspólnym najlepszym wynikiem
+
+    // Przechowywanie przezbrojeń (duże instancje)
+    SetupEncoding setupEncoding = SetupEncoding::Narrowest; // --setup-storage=narrow|wide|packed
+    bool hugePages = false;                                 // duże macierze na dużych stronach (mmap + MADV_HUGEPAGE)
+
+    // Tryb serwera
+    std::string serve;         // "stdin" (--serve) albo ścieżka gniazda Unix (--serve=ścieżka); pusty = zwykły przebieg
+    int cacheSize = 8;         // liczba instancji trzymanych w pamięci przez serwer
+
+    // Tryb rozproszony (DistributedCoordinator.hpp): --batch / --portfolio liczone przez procesy workerów
+    std::string coordinator;   // adres nasłuchu: ścieżka gniazda Unix albo HOST:PORT
+    int spawnWorkers = 0;      // > 0 = tylu lokalnych workerów uruchamianych przez koordynatora (po --threads slotów)
+    int broadcastInterval = 200; // [ms] odstęp rozsyłania najlepszego rozwiązania do workerów
+    std::string worker;        // proces workera: adres koordynatora
+
+    // Strumień postępu
+    std::string telemetry = "text"; // text (linie NEH_PROGRESS;/RESULT;/SLOT;) albo json (JSON na linię)
+    int frameInterval = 50;         // minimalny odstęp [ms] między pośrednimi ramkami harmonogramu; 0 = każda
+    int keyframeInterval = 0;       // > 0 = ramki różnicowe, pełna ramka co tyle ramek; 0 = zawsze pełne
+
+    // Budżet obliczeń (0 = bez limitu)
+    double timeLimit = 0.0;    // [s] na cały przebieg (NEH + SA)
+    int target = 0;            // zatrzymanie po osiągnięciu takiego makespanu
+    int stagnation = 0;        // zatrzymanie SA po tylu iteracjach bez poprawy
+    bool stdinControl = false; // komenda "stop" na stdin kończy obliczenia z najlepszym wynikiem
+
+    // Profilowanie (Profiler.hpp): raport faz na stderr po zakończeniu
+    bool profile = false;      // --profile
+    std::string profileTrace;  // --profile-trace=plik.json: zdarzenia Chrome trace (włącza --profile)
+};
+
+// Usuwa z args wszystkie tokeny --klucz=wartość i zwraca odczytane opcje.
+// Pozostałe tokeny (algorytmy i ich parametry) zostają w args.
+inline RunOptions extractOptions(std::vector<std::string> &args)
+{
+    RunOptions options;
+    std::vector<std::string> rest;
+
+    for (const auto &arg : args)
+    {
+        if (arg.rfind("--", 0) != 0)
+        {
+            rest.push_back(arg);
+            continue;
+        }
+
+        std::string::size_type eq = arg.find('=');
+        std::string key = arg.substr(2, eq == std::string::npos ? std::string::npos : eq - 2);
+        std::string value = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+
+        int *target = nullptr;
+        std::string *text = nullptr;
+        double *real = nullptr;
+        if (key == "stdin-control")
+        {
+            options.stdinControl = true;
+            continue;
+        }
+        if (key == "portfolio")
+        {
+            options.portfolio = true;
+            continue;
+        }
+        if (key == "profile")
+        {
+            options.profile = true;
+            continue;
+        }
+        if (key == "sa-calibrate")
+        {
+            options.annealing.calibrate = true;
+            continue;
+        }
+        if (key == "sa-schedule")
+        {
+            if (!AnnealingSchedule::parseCooling(value, options.annealing.cooling))
+                throw std::invalid_argument("--sa-schedule must be geometric or lundy-mees");
+            continue;
+        }
+        if (key == "huge-pages")
+        {
+            options.hugePages = true;
+            continue;
+        }
+        if (key == "setup-storage")
+        {
+            if (value == "narrow")
+                options.setupEncoding = SetupEncoding::Narrowest;
+            else if (value == "wide")
+                options.setupEncoding = SetupEncoding::Wide;
+            else if (value == "packed")
+                options.setupEncoding = SetupEncoding::Packed;
+            else
+                throw std::invalid_argument("--setup-storage must be narrow, wide or packed");
+            continue;
+        }
+        if (key == "serve" && value.empty())
+        {
+            options.serve = "stdin";
+            continue;
+        }
+        if (key == "threads")
+            target = &options.threads;
+        else if (key == "migrate")
+            target = &options.migrationInterval;
+        else if (key == "seed")
+            target = &options.seed;
+        else if (key == "sa-batch")
+            target = &options.moveBatch;
+        else if (key == "sa-cache")
+            target = &options.saCache;
+        else if (key == "sa-reheat")
+            target = &options.annealing.reheatInterval;
+        else if (key == "seeds")
+            target = &options.seeds;
+        else if (key == "batch")
+            text = &options.batch;
+        else if (key == "out")
+            text = &options.output;
+        else if (key == "convert")
+            text = &options.convert;
+        else if (key == "profile-trace")
+            text = &options.profileTrace;
+        else if (key == "serve")
+            text = &options.serve;
+        else if (key == "cache")
+            target = &options.cacheSize;
+        else if (key == "coordinator")
+            text = &options.coordinator;
+        else if (key == "spawn-workers")
+            target = &options.spawnWorkers;
+        else if (key == "broadcast")
+            target = &options.broadcastInterval;
+        else if (key == "worker")
+            text = &options.worker;
+        else if (key == "telemetry")
+            text = &options.telemetry;
+        else if (key == "frame-interval")
+            target = &options.frameInterval;
+        else if (key == "keyframe")
+            target = &options.keyframeInterval;
+        else if (key == "time-limit")
+            real = &options.timeLimit;
+        else if (key == "target")
+            target = &options.target;
+        else if (key == "stagnation")
+            target = &options.stagnation;
+        else
+            throw std::invalid_argument("unknown option " + arg);
+
+        if (text)
+        {
+            if (value.empty())
+                throw std::invalid_argument("missing value for " + arg);
+            *text = value;
+            continue;
+        }
+
+        try
+        {
+            size_t used = 0;
+            if (real)
+                *real = std::stod(value, &used);
+            else
+                *target = std::stoi(value, &used);
+            if (used != value.size())
+                throw std::invalid_argument(arg);
+        }
+        catch (const std::invalid_argument &)
+        {
+            throw std::invalid_argument("invalid option " + arg);
+        }
+        catch (const std::out_of_range &)
+        {
+            throw std::invalid_argument("option value out of range: " + arg);
+        }
+    }
+
+    if (options.threads < 1)
+        throw std::invalid_argument("--threads must be >= 1");
+    if (options.moveBatch < 1)
+        throw std::invalid_argument("--sa-batch must be >= 1");
+    if (options.saCache < 0)
+        throw std::invalid_argument("--sa-cache must be >= 0");
+    if (options.annealing.reheatInterval < 0)
+        throw std::invalid_argument("--sa-reheat must be >= 0");
+    if (options.cacheSize < 1)
+        throw std::invalid_argument("--cache must be >= 1");
+    if (options.spawnWorkers < 0 || options.broadcastInterval < 1)
+        throw std::invalid_argument("--spawn-workers must be >= 0 and --broadcast >= 1");
+    if (options.seeds < 1)
+        throw std::invalid_argument("--seeds must be >= 1");
+    if (options.telemetry != "text" && options.telemetry != "json")
+        throw std::invalid_argument("--telemetry must be text or json");
+    if (options.frameInterval < 0)
+        throw std::invalid_argument("--frame-interval must be >= 0");
+    if (options.keyframeInterval < 0)
+        throw std::invalid_argument("--keyframe must be >= 0");
+    if (options.timeLimit < 0 || options.target < 0 || options.stagnation < 0)
+        throw std::invalid_argument("--time-limit, --target and --stagnation must be >= 0");
+
+    if (!options.profileTrace.empty())
+        options.profile = true;
+
+    args = rest;
+    return options;
+}
@@ -0,0 +1,539 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "../core/LowerBound.hpp"
+#include "../core/ReschedulingSession.hpp"
+#include "../core/SolveBudget.hpp"
+#include "../core/Telemetry.hpp"
+#include "../core/ThreadPool.hpp"
+#include "FlatJson.hpp"
+#include "InstanceCache.hpp"
+#include "Pipeline.hpp"
+#include "RunOptions.hpp"
+
+// Proces serwera: wiele zleceń bez ponownego uruchamiania i wczytywania instancji.
+// Protokół: jeden obiekt JSON na linię (stdin/stdout albo gniazdo Unix, po połączeniu na klienta).
+//   {"cmd":"load","path":P}                                   -> loaded (jobs, machines, setup_storage, setup_bytes, cached, hash, ms)
+//   {"cmd":"solve","id":I,"path":P,"pipeline":"neh+simulated_annealing","seed":1,
+//    "time_limit":S,"target":C,"stagnation":K,"frames":false,"frame_interval":MS,"sa_batch":K,"sa_cache":E,
+//    "sa_schedule":"geometric|lundy-mees","sa_calibrate":false,"sa_reheat":N}
+//                                                             (sa_* domyślnie z opcji --sa-* serwera)
+//                                                             -> accepted, zdarzenia postępu z "id", done
+//   {"cmd":"cancel","target":I}                               -> cancelling (przerwane zlecenie kończy się done)
+//   {"cmd":"stats"} / {"cmd":"shutdown"}
+// Sesje przeplanowania (ReschedulingSession; listy liczb jako tekst rozdzielany spacjami):
+//   {"cmd":"session_open","session":S,"path":P,"iterations":50,"destroy":4,"temperature":0.4,"time_limit":0,"seed":1}
+//   {"cmd":"session_add","session":S,"proc":"p1 .. pm","setup_in":"m*n","setup_out":"m*n"}
+//                                                             (kolejność zadań jak job_ids z ostatniej odpowiedzi)
+//   {"cmd":"session_remove","session":S,"job":J} / {"cmd":"session_reoptimize","session":S}
+//                                                             -> updated (metryki zmiany, job_ids, sequence)
+//   {"cmd":"session_close","session":S}                       -> closed
+// Błędy: {"type":"error","id":I,"message":...}. Zlecenia działają na puli --threads wątków,
+// każde jednowątkowo; zdarzenia zlecenia trafiają tylko do jego klienta (TelemetryRoute).
+class SolverServer
+{
+private:
+    // Strona klienta: zapis całych linii pod mutexem (zdarzenia z wielu zleceń naraz)
+    class Connection
+    {
+    private:
+        int fd;
+        bool socket;
+        std::mutex mtx;
+        bool broken = false;
+
+    public:
+        Connection(int descriptor, bool isSocket) : fd(descriptor), socket(isSocket) {}
+        Connection(const Connection &) = delete;
+        // Gniazdo zamykane dopiero, gdy skończą się też zlecenia klienta
+        ~Connection()
+        {
+            if (socket)
+                ::close(fd);
+        }
+
+        int descriptor() const { return fd; }
+
+        void send(const std::string &line)
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            std::size_t done = 0;
+            while (!broken && done < line.size())
+            {
+                // MSG_NOSIGNAL: rozłączony klient nie kończy procesu sygnałem SIGPIPE
+                ssize_t n = socket ? ::send(fd, line.data() + done, line.size() - done, MSG_NOSIGNAL)
+                                   : ::write(fd, line.data() + done, line.size() - done);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                    broken = true;
+                else
+                    done += (std::size_t)n;
+            }
+        }
+    };
+
+    // Zdarzenia zlecenia z dopisanym "id"
+    class RequestSink : public TelemetrySink
+    {
+    private:
+        std::shared_ptr<Connection> connection;
+        std::string tag;
+
+    public:
+        RequestSink(std::shared_ptr<Connection> conn, const std::string &id)
+            : connection(std::move(conn)), tag("{\"id\":\"" + Telemetry::escape(id) + "\",") {}
+
+        void write(const std::string &line) override
+        {
+            if (line.size() > 1 && line[0] == '{')
+                connection->send(tag + line.substr(1));
+        }
+    };
+
+    // Sesja z własną blokadą - zmiany jednej sesji szeregowane, różne sesje niezależne
+    struct SessionEntry
+    {
+        std::mutex mtx;
+        std::unique_ptr<ReschedulingSession> session;
+    };
+
+    struct Request
+    {
+        std::string id;
+        std::atomic<bool> cancelled{false};
+    };
+
+    RunOptions options;
+    InstanceCache cache;
+    ThreadPool pool;
+    std::mutex requestsMtx;
+    std::map<std::string, std::shared_ptr<Request>> active; // przyjęte i nieukończone
+    std::atomic<long long> nextId{0};
+    std::atomic<long long> solved{0};
+    std::atomic<long long> cancelled{0};
+    std::atomic<long long> failed{0};
+    std::atomic<bool> stopping{false};
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+
+    std::mutex sessionsMtx;
+    std::map<std::string, std::shared_ptr<SessionEntry>> sessions;
+
+    int listenFd = -1;
+    std::mutex connectionsMtx;
+    std::vector<std::shared_ptr<Connection>> connections;
+
+public:
+    explicit SolverServer(const RunOptions &runOptions)
+        : options(runOptions), cache(runOptions.cacheSize, runOptions.setupEncoding, runOptions.hugePages), pool(runOptions.threads) {}
+
+    // "stdin" = protokół na stdin/stdout, inaczej ścieżka gniazda Unix
+    int run(const std::string &endpoint)
+    {
+        int status = (endpoint == "stdin") ? serveStdin() : serveSocket(endpoint);
+        pool.wait();
+        return status;
+    }
+
+private:
+    int serveStdin()
+    {
+        auto client = std::make_shared<Connection>(STDOUT_FILENO, false);
+        std::cerr << "Server: reading requests from stdin, threads=" << options.threads << std::endl;
+        std::string line;
+        while (!stopping && std::getline(std::cin, line))
+            handle(client, line);
+        return 0;
+    }
+
+    int serveSocket(const std::string &path)
+    {
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path))
+        {
+            std::cerr << "Error: socket path too long: " << path << std::endl;
+            return 1;
+        }
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+        listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        ::unlink(path.c_str()); // pozostałość po poprzednim procesie
+        if (listenFd < 0 || ::bind(listenFd, (sockaddr *)&addr, sizeof(addr)) != 0 || ::listen(listenFd, 16) != 0)
+        {
+            std::cerr << "Error: cannot listen on " << path << ": " << std::strerror(errno) << std::endl;
+            if (listenFd >= 0)
+                ::close(listenFd);
+            return 1;
+        }
+        std::cerr << "Server: listening on " << path << ", threads=" << options.threads << std::endl;
+
+        std::vector<std::thread> readers;
+        while (!stopping)
+        {
+            int fd = ::accept(listenFd, nullptr, nullptr);
+            if (fd < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                break; // shutdown() gniazda nasłuchującego
+            }
+            auto client = std::make_shared<Connection>(fd, true);
+            {
+                std::lock_guard<std::mutex> lock(connectionsMtx);
+                connections.push_back(client);
+            }
+            readers.emplace_back([this, client]
+                                 { readConnection(client); });
+        }
+
+        // Odblokowanie czytelników pozostałych połączeń
+        {
+            std::lock_guard<std::mutex> lock(connectionsMtx);
+            for (auto &c : connections)
+                ::shutdown(c->descriptor(), SHUT_RD);
+        }
+        for (auto &t : readers)
+            t.join();
+        pool.wait();
+        ::close(listenFd);
+        ::unlink(path.c_str());
+        return 0;
+    }
+
+    void readConnection(const std::shared_ptr<Connection> &client)
+    {
+        std::string buffer;
+        char chunk[4096];
+        for (;;)
+        {
+            ssize_t n = ::recv(client->descriptor(), chunk, sizeof(chunk), 0);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                break;
+            buffer.append(chunk, (std::size_t)n);
+            std::size_t newline;
+            while ((newline = buffer.find('\n')) != std::string::npos)
+            {
+                std::string line = buffer.substr(0, newline);
+                buffer.erase(0, newline + 1);
+                handle(client, line);
+            }
+        }
+        std::lock_guard<std::mutex> lock(connectionsMtx);
+        connections.erase(std::remove(connections.begin(), connections.end(), client), connections.end());
+    }
+
+    void handle(const std::shared_ptr<Connection> &client, const std::string &line)
+    {
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            return;
+        std::string id;
+        try
+        {
+            FlatJson request = FlatJson::parse(line);
+            id = request.text("id");
+            std::string cmd = request.text("cmd");
+            if (cmd == "load")
+                load(client, request, id);
+            else if (cmd == "solve")
+                solve(client, request, id);
+            else if (cmd == "cancel")
+                cancel(client, request, id);
+            else if (cmd.rfind("session_", 0) == 0)
+                handleSession(client, request, cmd, id);
+            else if (cmd == "stats")
+                sendStats(client, id);
+            else if (cmd == "shutdown")
+                shutdown(client, id);
+            else
+                throw std::invalid_argument("unknown cmd '" + cmd + "'");
+        }
+        catch (const std::exception &e)
+        {
+            client->send(reply("error", id) + ",\"message\":\"" + Telemetry::escape(e.what()) + "\"}\n");
+        }
+    }
+
+    // Początek odpowiedzi (bez zamykającego nawiasu)
+    static std::string reply(const char *type, const std::string &id)
+    {
+        std::string out = std::string("{\"type\":\"") + type + "\"";
+        if (!id.empty())
+            out += ",\"id\":\"" + Telemetry::escape(id) + "\"";
+        return out;
+    }
+
+    static std::string requirePath(const FlatJson &request)
+    {
+        std::string path = request.text("path");
+        if (path.empty())
+            throw std::invalid_argument("missing path");
+        return path;
+    }
+
+    void load(const std::shared_ptr<Connection> &client, const FlatJson &request, const std::string &id)
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto loaded = cache.acquire(requirePath(request));
+        std::ostringstream out;
+        out << reply("loaded", id) << ",\"jobs\":" << loaded.instance->getJobs() << ",\"machines\":"
+            << loaded.instance->getMachines() << ",\"setup_storage\":\""
+            << SetupMatrix::widthName(loaded.instance->getSetupMatrix().getWidth()) << "\",\"setup_bytes\":"
+            << loaded.instance->getSetupMatrix().bytes() << ",\"cached\":" << (loaded.cached ? "true" : "false") << ",\"hash\":\""
+            << std::hex << loaded.hash << std::dec << "\",\"ms\":" << elapsedMs(start) << "}\n";
+        client->send(out.str());
+    }
+
+    void solve(const std::shared_ptr<Connection> &client, const FlatJson &request, std::string id)
+    {
+        if (stopping)
+            throw std::runtime_error("server is shutting down");
+        std::string path = requirePath(request);
+        Pipeline pipeline = parsePipeline(request.text("pipeline", "neh"));
+        int seed = (int)request.integer("seed", options.seed);
+        SolveBudget budget;
+        budget.timeLimit = request.number("time_limit", options.timeLimit);
+        budget.targetMakespan = request.integer("target", options.target);
+        budget.stagnationLimit = request.integer("stagnation", options.stagnation);
+        bool frames = request.flag("frames", false);
+        int frameInterval = (int)request.integer("frame_interval", options.frameInterval);
+        if (budget.timeLimit < 0 || budget.targetMakespan < 0 || budget.stagnationLimit < 0 || frameInterval < 0)
+            throw std::invalid_argument("time_limit, target, stagnation and frame_interval must be >= 0");
+        PipelineOptions tuning = pipelineOptions(options);
+        tuning.moveBatch = (int)request.integer("sa_batch", tuning.moveBatch);
+        tuning.solutionCache = (int)request.integer("sa_cache", tuning.solutionCache);
+        if (tuning.moveBatch < 1 || tuning.solutionCache < 0)
+            throw std::invalid_argument("sa_batch must be >= 1 and sa_cache >= 0");
+        std::string cooling = request.text("sa_schedule", AnnealingSchedule::coolingName(tuning.annealing.cooling));
+        if (!AnnealingSchedule::parseCooling(cooling, tuning.annealing.cooling))
+            throw std::invalid_argument("sa_schedule must be geometric or lundy-mees");
+        tuning.annealing.calibrate = request.flag("sa_calibrate", tuning.annealing.calibrate);
+        tuning.annealing.reheatInterval = (int)request.integer("sa_reheat", tuning.annealing.reheatInterval);
+        if (tuning.annealing.reheatInterval < 0)
+            throw std::invalid_argument("sa_reheat must be >= 0");
+
+        if (id.empty())
+            id = "req-" + std::to_string(++nextId);
+        auto job = std::make_shared<Request>();
+        job->id = id;
+        {
+            std::lock_guard<std::mutex> lock(requestsMtx);
+            if (!active.emplace(id, job).second)
+                throw std::invalid_argument("request id already in progress");
+        }
+        client->send(reply("accepted", id) + "}\n");
+
+        pool.submit([this, client, job, path, pipeline, seed, budget, tuning, frames, frameInterval]() mutable
+                    {
+                        auto start = std::chrono::steady_clock::now();
+                        std::ostringstream out;
+                        try
+                        {
+                            auto loaded = cache.acquire(path);
+                            const Instance &instance = *loaded.instance;
+                            budget.lowerBound = LowerBound(instance).compute();
+                            budget.start(); // czas liczony od startu, nie od przyjęcia zlecenia
+
+                            RequestSink sink(client, job->id);
+                            sink.configureFrames(frames, frameInterval, options.keyframeInterval);
+                            PipelineResult result;
+                            {
+                                TelemetryRoute route(sink);
+                                CancellationScope scope(job->cancelled);
+                                result = runPipeline(instance, pipeline, seed, budget, true, Schedule(), tuning);
+                            }
+
+                            bool wasCancelled = job->cancelled.load();
+                            (wasCancelled ? cancelled : solved)++;
+                            out << reply("done", job->id) << ",\"status\":\"" << (wasCancelled ? "cancelled" : "ok")
+                                << "\",\"cmax\":" << result.makespan << ",\"lower_bound\":" << budget.lowerBound
+                                << ",\"iterations\":" << result.iterations << ",\"ms\":" << elapsedMs(start);
+                            if (!result.stopReason.empty())
+                                out << ",\"stop_reason\":\"" << Telemetry::escape(result.stopReason) << "\"";
+                            out << ",\"sequence\":[";
+                            for (std::size_t i = 0; i < result.sequence.size(); ++i)
+                                out << (i ? "," : "") << result.sequence[i];
+                            out << "]}\n";
+                        }
+                        catch (const std::exception &e)
+                        {
+                            ++failed;
+                            out.str("");
+                            out << reply("error", job->id) << ",\"message\":\"" << Telemetry::escape(e.what()) << "\"}\n";
+                        }
+                        {
+                            std::lock_guard<std::mutex> lock(requestsMtx);
+                            active.erase(job->id);
+                        }
+                        client->send(out.str()); });
+    }
+
+    void cancel(const std::shared_ptr<Connection> &client, const FlatJson &request, const std::string &id)
+    {
+        std::string target = request.text("target", id);
+        bool found = false;
+        {
+            std::lock_guard<std::mutex> lock(requestsMtx);
+            auto it = active.find(target);
+            if (it != active.end())
+            {
+                it->second->cancelled.store(true);
+                found = true;
+            }
+        }
+        client->send(reply("cancelling", id) + ",\"target\":\"" + Telemetry::escape(target) +
+                     "\",\"found\":" + (found ? "true" : "false") + "}\n");
+    }
+
+    // Zmiany sesji wykonywane od razu w wątku połączenia (milisekundy, bez kolejki puli)
+    void handleSession(const std::shared_ptr<Connection> &client, const FlatJson &request, const std::string &cmd,
+                       const std::string &id)
+    {
+        std::string name = request.text("session");
+        if (name.empty())
+            throw std::invalid_argument("missing session");
+
+        if (cmd == "session_open")
+        {
+            ReschedulingSession::Settings settings;
+            settings.iterations = (int)request.integer("iterations", settings.iterations);
+            settings.destroy = (int)request.integer("destroy", settings.destroy);
+            settings.temperature = request.number("temperature", settings.temperature);
+            settings.timeLimit = request.number("time_limit", settings.timeLimit);
+            settings.seed = (int)request.integer("seed", options.seed);
+            if (settings.iterations < 0 || settings.temperature < 0 || settings.timeLimit < 0)
+                throw std::invalid_argument("iterations, temperature and time_limit must be >= 0");
+            if (settings.destroy < 1)
+                throw std::invalid_argument("destroy must be >= 1");
+            auto loaded = cache.acquire(requirePath(request));
+            auto entry = std::make_shared<SessionEntry>();
+            entry->session = std::make_unique<ReschedulingSession>(*loaded.instance, settings);
+            {
+                std::lock_guard<std::mutex> lock(sessionsMtx);
+                sessions[name] = entry; // ponowne otwarcie zastępuje sesję
+            }
+            std::lock_guard<std::mutex> lock(entry->mtx);
+            client->send(sessionReply(*entry->session, name, id));
+            return;
+        }
+        if (cmd == "session_close")
+        {
+            bool found;
+            {
+                std::lock_guard<std::mutex> lock(sessionsMtx);
+                found = sessions.erase(name) > 0;
+            }
+            client->send(reply("closed", id) + ",\"session\":\"" + Telemetry::escape(name) + "\",\"found\":" +
+                         (found ? "true" : "false") + "}\n");
+            return;
+        }
+
+        std::shared_ptr<SessionEntry> entry;
+        {
+            std::lock_guard<std::mutex> lock(sessionsMtx);
+            auto it = sessions.find(name);
+            if (it == sessions.end())
+                throw std::invalid_argument("unknown session '" + name + "'");
+            entry = it->second;
+        }
+        std::lock_guard<std::mutex> lock(entry->mtx);
+        ReschedulingSession &session = *entry->session;
+        if (cmd == "session_add")
+            session.addJob(parseIntList(request.text("proc")), parseIntList(request.text("setup_in")),
+                           parseIntList(request.text("setup_out")));
+        else if (cmd == "session_remove")
+        {
+            if (!request.has("job"))
+                throw std::invalid_argument("missing job");
+            if (!session.removeJob((int)request.integer("job", -1)))
+                throw std::invalid_argument("unknown job " + request.text("job"));
+        }
+        else if (cmd == "session_reoptimize")
+            session.reoptimize();
+        else
+            throw std::invalid_argument("unknown cmd '" + cmd + "'");
+        client->send(sessionReply(session, name, id));
+    }
+
+    static std::string sessionReply(const ReschedulingSession &session, const std::string &name, const std::string &id)
+    {
+        const auto &u = session.lastUpdate();
+        std::ostringstream out;
+        out << reply("updated", id) << ",\"session\":\"" << Telemetry::escape(name) << "\",\"kind\":\"" << u.kind << "\"";
+        if (u.job >= 0)
+            out << ",\"job\":" << u.job;
+        out << ",\"jobs\":" << u.jobs << ",\"repaired_cmax\":" << u.repairedMakespan << ",\"cmax\":" << u.makespan
+            << ",\"iterations\":" << u.iterations << ",\"rebuild_ms\":" << u.rebuildMs << ",\"repair_ms\":" << u.repairMs
+            << ",\"optimize_ms\":" << u.optimizeMs << ",\"total_ms\":" << u.totalMs << ",\"job_ids\":[";
+        const auto &ids = session.getJobIds();
+        for (std::size_t i = 0; i < ids.size(); ++i)
+            out << (i ? "," : "") << ids[i];
+        out << "],\"sequence\":[";
+        auto sequence = session.getSequence();
+        for (std::size_t i = 0; i < sequence.size(); ++i)
+            out << (i ? "," : "") << sequence[i];
+        out << "]}\n";
+        return out.str();
+    }
+
+    // "5 7 3" -> {5, 7, 3}
+    static std::vector<int> parseIntList(const std::string &text)
+    {
+        std::vector<int> values;
+        std::istringstream in(text);
+        int value;
+        while (in >> value)
+            values.push_back(value);
+        if (!in.eof())
+            throw std::invalid_argument("expected a list of integers separated by spaces");
+        return values;
+    }
+
+    void sendStats(const std::shared_ptr<Connection> &client, const std::string &id)
+    {
+        auto stats = cache.getStats();
+        std::size_t running;
+        {
+            std::lock_guard<std::mutex> lock(requestsMtx);
+            running = active.size();
+        }
+        std::ostringstream out;
+        out << reply("stats", id) << ",\"threads\":" << options.threads << ",\"active\":" << running
+            << ",\"solved\":" << solved.load() << ",\"cancelled\":" << cancelled.load() << ",\"failed\":" << failed.load()
+            << ",\"cache_entries\":" << stats.entries << ",\"cache_hits\":" << stats.hits << ",\"cache_misses\":"
+            << stats.misses << ",\"cache_reloads\":" << stats.reloads << ",\"cache_evictions\":" << stats.evictions
+            << ",\"uptime_ms\":" << elapsedMs(started) << "}\n";
+        client->send(out.str());
+    }
+
+    // Nowe zlecenia są odrzucane, przyjęte kończą się normalnie
+    void shutdown(const std::shared_ptr<Connection> &client, const std::string &id)
+    {
+        stopping = true;
+        client->send(reply("shutdown", id) + "}\n");
+        if (listenFd >= 0)
+            ::shutdown(listenFd, SHUT_RDWR);
+    }
+
+    static long long elapsedMs(std::chrono::steady_clock::time_point since)
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - since).count();
+    }
+};
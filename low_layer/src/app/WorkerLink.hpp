@@ -0,0 +1,286 @@
+#pragma once
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "../core/Telemetry.hpp"
+#include "FlatJson.hpp"
+
+// Łącze koordynator <-> worker (tryb rozproszony).
+// Adres: ścieżka gniazda Unix (zawiera '/') albo HOST:PORT dla TCP (przy nasłuchu pusty HOST lub '*'
+// oznacza wszystkie interfejsy). Wiadomość to linia płaskiego JSON (FlatJson); pole "bytes":N
+// zapowiada N bajtów danych zaraz po '\n' (instancja binarna). Wysyłanie z wielu wątków, odbiór z jednego.
+namespace worker_link
+{
+    struct Endpoint
+    {
+        bool unixSocket = false;
+        std::string path;
+        std::string host;
+        std::string port;
+    };
+
+    inline Endpoint parseEndpoint(const std::string &text)
+    {
+        Endpoint endpoint;
+        if (text.find('/') != std::string::npos)
+        {
+            endpoint.unixSocket = true;
+            endpoint.path = text;
+            return endpoint;
+        }
+        std::string::size_type colon = text.rfind(':');
+        if (colon == std::string::npos || colon + 1 == text.size())
+            throw std::invalid_argument("endpoint must be a socket path or HOST:PORT, got '" + text + "'");
+        endpoint.host = text.substr(0, colon);
+        endpoint.port = text.substr(colon + 1);
+        if (endpoint.host == "*")
+            endpoint.host.clear();
+        return endpoint;
+    }
+
+    // Małe wiadomości (postęp, wyniki) bez opóźnienia Nagle'a; keepalive wykrywa zniknięcie hosta
+    inline void tuneTcp(int fd)
+    {
+        int on = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        ::setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on));
+    }
+
+    // Gniazdo nasłuchujące (bez dziedziczenia przez procesy potomne); błąd zgłaszany wyjątkiem
+    inline int listenOn(const std::string &text)
+    {
+        Endpoint endpoint = parseEndpoint(text);
+        int fd = -1;
+        if (endpoint.unixSocket)
+        {
+            sockaddr_un addr{};
+            if (endpoint.path.size() >= sizeof(addr.sun_path))
+                throw std::runtime_error("socket path too long: " + endpoint.path);
+            addr.sun_family = AF_UNIX;
+            std::strncpy(addr.sun_path, endpoint.path.c_str(), sizeof(addr.sun_path) - 1);
+            fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            ::unlink(endpoint.path.c_str()); // pozostałość po poprzednim procesie
+            if (fd >= 0 && ::bind(fd, (sockaddr *)&addr, sizeof(addr)) == 0 && ::listen(fd, 64) == 0)
+                return fd;
+        }
+        else
+        {
+            addrinfo hints{}, *found = nullptr;
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            hints.ai_flags = AI_PASSIVE;
+            if (::getaddrinfo(endpoint.host.empty() ? nullptr : endpoint.host.c_str(), endpoint.port.c_str(), &hints, &found) != 0)
+                throw std::runtime_error("cannot resolve " + text);
+            for (addrinfo *a = found; a; a = a->ai_next)
+            {
+                fd = ::socket(a->ai_family, a->ai_socktype | SOCK_CLOEXEC, a->ai_protocol);
+                if (fd < 0)
+                    continue;
+                int on = 1;
+                ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+                if (::bind(fd, a->ai_addr, a->ai_addrlen) == 0 && ::listen(fd, 64) == 0)
+                    break;
+                ::close(fd);
+                fd = -1;
+            }
+            ::freeaddrinfo(found);
+            if (fd >= 0)
+                return fd;
+        }
+        std::string reason = std::strerror(errno);
+        if (fd >= 0)
+            ::close(fd);
+        throw std::runtime_error("cannot listen on " + text + ": " + reason);
+    }
+
+    // Połączenie z koordynatorem; -1 = nieudane (wywołujący ponawia)
+    inline int connectTo(const std::string &text)
+    {
+        Endpoint endpoint = parseEndpoint(text);
+        if (endpoint.unixSocket)
+        {
+            sockaddr_un addr{};
+            if (endpoint.path.size() >= sizeof(addr.sun_path))
+                return -1;
+            addr.sun_family = AF_UNIX;
+            std::strncpy(addr.sun_path, endpoint.path.c_str(), sizeof(addr.sun_path) - 1);
+            int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd >= 0 && ::connect(fd, (sockaddr *)&addr, sizeof(addr)) == 0)
+                return fd;
+            if (fd >= 0)
+                ::close(fd);
+            return -1;
+        }
+
+        addrinfo hints{}, *found = nullptr;
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        if (::getaddrinfo(endpoint.host.empty() ? "localhost" : endpoint.host.c_str(), endpoint.port.c_str(), &hints, &found) != 0)
+            return -1;
+        int fd = -1;
+        for (addrinfo *a = found; a && fd < 0; a = a->ai_next)
+        {
+            fd = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+            if (fd >= 0 && ::connect(fd, a->ai_addr, a->ai_addrlen) != 0)
+            {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+        ::freeaddrinfo(found);
+        if (fd >= 0)
+            tuneTcp(fd);
+        return fd;
+    }
+
+    // "3 1 2" <-> {3, 1, 2} (sekwencje w polach tekstowych, jak listy w protokole serwera)
+    inline std::string joinInts(const std::vector<int> &values)
+    {
+        std::string text;
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            if (i)
+                text += ' ';
+            text += std::to_string(values[i]);
+        }
+        return text;
+    }
+
+    inline std::vector<int> splitInts(const std::string &text)
+    {
+        std::vector<int> values;
+        std::istringstream in(text);
+        int value;
+        while (in >> value)
+            values.push_back(value);
+        return values;
+    }
+}
+
+// Wiadomość składana pole po polu: LinkMessage("task").field("seed", 3).text("pipeline", spec).str()
+class LinkMessage
+{
+private:
+    std::ostringstream out;
+
+public:
+    // Liczby zmiennoprzecinkowe (czasy w sekundach) z dokładnością do mikrosekund
+    explicit LinkMessage(const char *type)
+    {
+        out.precision(12);
+        out << "{\"type\":\"" << type << "\"";
+    }
+
+    template <typename T>
+    LinkMessage &field(const char *key, const T &value)
+    {
+        out << ",\"" << key << "\":" << value;
+        return *this;
+    }
+
+    LinkMessage &flag(const char *key, bool value)
+    {
+        out << ",\"" << key << "\":" << (value ? "true" : "false");
+        return *this;
+    }
+
+    LinkMessage &text(const char *key, const std::string &value)
+    {
+        out << ",\"" << key << "\":\"" << Telemetry::escape(value) << "\"";
+        return *this;
+    }
+
+    std::string str() const { return out.str() + "}"; }
+};
+
+// Jedno połączenie strumieniowe; wysłanie całej wiadomości pod mutexem, odbiór buforowany
+class MessageChannel
+{
+private:
+    int fd;
+    std::mutex sendMtx;
+    bool broken = false;
+    std::string buffer;
+
+public:
+    explicit MessageChannel(int descriptor) : fd(descriptor) {}
+    MessageChannel(const MessageChannel &) = delete;
+    ~MessageChannel() { ::close(fd); }
+
+    int descriptor() const { return fd; }
+
+    // false = połączenie zerwane (dalsze wysyłanie pomijane)
+    bool send(const std::string &message, const std::string &payload = std::string())
+    {
+        std::lock_guard<std::mutex> lock(sendMtx);
+        return writeAll(message.data(), message.size()) && writeAll("\n", 1) && writeAll(payload.data(), payload.size());
+    }
+
+    // Następna wiadomość i jej dane ("bytes"); false = koniec połączenia albo błąd odczytu.
+    // Uszkodzona linia zgłasza std::invalid_argument (FlatJson)
+    bool receive(FlatJson &message, std::vector<char> &payload)
+    {
+        std::string::size_type newline;
+        while ((newline = buffer.find('\n')) == std::string::npos)
+            if (!fill())
+                return false;
+        message = FlatJson::parse(buffer.substr(0, newline));
+        buffer.erase(0, newline + 1);
+
+        long long bytes = message.integer("bytes", 0);
+        if (bytes < 0)
+            throw std::invalid_argument("field bytes must be >= 0");
+        while ((long long)buffer.size() < bytes)
+            if (!fill())
+                return false;
+        payload.assign(buffer.begin(), buffer.begin() + bytes);
+        buffer.erase(0, (std::size_t)bytes);
+        return true;
+    }
+
+    // Odblokowanie odbioru w innym wątku; dane już wysłane zostaną doręczone
+    void close() { ::shutdown(fd, SHUT_RDWR); }
+
+private:
+    bool writeAll(const char *data, std::size_t size)
+    {
+        std::size_t done = 0;
+        while (!broken && done < size)
+        {
+            // MSG_NOSIGNAL: zerwane połączenie nie kończy procesu sygnałem SIGPIPE
+            ssize_t n = ::send(fd, data + done, size - done, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                broken = true;
+            else
+                done += (std::size_t)n;
+        }
+        return !broken;
+    }
+
+    bool fill()
+    {
+        char chunk[1 << 16];
+        for (;;)
+        {
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                return false;
+            buffer.append(chunk, (std::size_t)n);
+            return true;
+        }
+    }
+};
@@ -0,0 +1,54 @@
+#include "BenchSupport.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Globalne operator new/delete benchmarku: zliczają alokacje (tylko w pfsp_bench)
+namespace
+{
+    std::atomic<long long> allocations{0};
+    std::atomic<long long> allocatedBytes{0};
+
+    void *countedAlloc(std::size_t size)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add((long long)size, std::memory_order_relaxed);
+        if (void *p = std::malloc(size ? size : 1))
+            return p;
+        throw std::bad_alloc();
+    }
+
+    void *countedAlignedAlloc(std::size_t size, std::align_val_t align)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add((long long)size, std::memory_order_relaxed);
+        std::size_t alignment = (std::size_t)align;
+        if (alignment < sizeof(void *))
+            alignment = sizeof(void *);
+        void *p = nullptr;
+        if (::posix_memalign(&p, alignment, size ? size : 1) != 0)
+            throw std::bad_alloc();
+        return p;
+    }
+}
+
+void *operator new(std::size_t size) { return countedAlloc(size); }
+void *operator new[](std::size_t size) { return countedAlloc(size); }
+void *operator new(std::size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void *operator new[](std::size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace bench
+{
+    AllocStats allocationStats()
+    {
+        return {allocations.load(std::memory_order_relaxed), allocatedBytes.load(std::memory_order_relaxed)};
+    }
+}
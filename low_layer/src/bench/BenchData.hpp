@@ -0,0 +1,81 @@
+#pragma once
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../core/Instance.hpp"
+
+// Dane instancji w prostych tablicach (wspólne dla porównań implementacji i zestawu regresji)
+struct FlatData
+{
+    int jobs = 0;
+    int machines = 0;
+    std::vector<int> proc;  // [job][machine]
+    std::vector<int> setup; // [machine][prev][curr]
+};
+
+// Losowe dane w stylu data/generator.py (proc 5-15, setup 5-10, zera na przekątnej)
+inline FlatData generateData(int n, int m, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> procDist(5, 15);
+    std::uniform_int_distribution<int> setupDist(5, 10);
+
+    FlatData d;
+    d.jobs = n;
+    d.machines = m;
+    d.proc.resize((std::size_t)n * m);
+    for (int &v : d.proc)
+        v = procDist(rng);
+    d.setup.resize((std::size_t)m * n * n);
+    for (int mach = 0; mach < m; ++mach)
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j)
+                d.setup[((std::size_t)mach * n + i) * n + j] = (i == j) ? 0 : setupDist(rng);
+    return d;
+}
+
+inline FlatData extractData(const Instance &inst)
+{
+    FlatData d;
+    d.jobs = inst.getJobs();
+    d.machines = inst.getMachines();
+    d.proc.resize((std::size_t)d.jobs * d.machines);
+    d.setup.resize((std::size_t)d.machines * d.jobs * d.jobs);
+    for (int j = 0; j < d.jobs; ++j)
+        for (int mach = 0; mach < d.machines; ++mach)
+            d.proc[(std::size_t)j * d.machines + mach] = inst.getProcTime(j, mach);
+    for (int mach = 0; mach < d.machines; ++mach)
+        for (int i = 0; i < d.jobs; ++i)
+            for (int j = 0; j < d.jobs; ++j)
+                d.setup[((std::size_t)mach * d.jobs + i) * d.jobs + j] = inst.getSetupTime(mach, i, j);
+    return d;
+}
+
+// Zapis w formacie tekstowym z katalogu data/ (żeby mierzyć też wczytywanie)
+inline bool writeTextInstance(const FlatData &d, const std::string &path)
+{
+    std::ofstream out(path);
+    if (!out.is_open())
+        return false;
+    out << "jobs = " << d.jobs << "\nmachines = " << d.machines << "\n\nproc_time =\n";
+    for (int j = 0; j < d.jobs; ++j)
+    {
+        for (int mach = 0; mach < d.machines; ++mach)
+            out << (mach ? "  " : "") << d.proc[(std::size_t)j * d.machines + mach];
+        out << "\n";
+    }
+    out << "\nsetup_time =\n";
+    for (int mach = 0; mach < d.machines; ++mach)
+    {
+        out << "# machine " << mach + 1 << "\n";
+        for (int i = 0; i < d.jobs; ++i)
+        {
+            for (int j = 0; j < d.jobs; ++j)
+                out << (j ? "  " : "") << d.setup[((std::size_t)mach * d.jobs + i) * d.jobs + j];
+            out << "\n";
+        }
+        out << "\n";
+    }
+    return (bool)out;
+}
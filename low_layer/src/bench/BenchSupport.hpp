@@ -0,0 +1,86 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <malloc.h>
+#include <sys/resource.h>
+
+namespace bench
+{
+    // Liczniki globalnego operator new (AllocCounter.cpp); macierze z aligned_alloc nie są liczone
+    struct AllocStats
+    {
+        long long count = 0;
+        long long bytes = 0;
+    };
+    AllocStats allocationStats();
+
+    // Zeruje licznik szczytowego RSS procesu (Linux: /proc/self/clear_refs); false = brak wsparcia.
+    // Wcześniej oddaje systemowi zwolnioną pamięć sterty, żeby nie liczyć pozostałości po poprzednich pomiarach.
+    inline bool resetPeakRss()
+    {
+        malloc_trim(0);
+        std::ofstream refs("/proc/self/clear_refs");
+        refs << "5";
+        refs.flush();
+        return (bool)refs;
+    }
+
+    // Szczytowy RSS [KiB] od ostatniego resetPeakRss() (VmHWM), w ostateczności od startu procesu
+    inline long long peakRssKb()
+    {
+        std::ifstream status("/proc/self/status");
+        std::string key;
+        while (status >> key)
+        {
+            if (key == "VmHWM:")
+            {
+                long long kb = 0;
+                status >> kb;
+                return kb;
+            }
+            status.ignore(1 << 10, '\n');
+        }
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    template <typename F>
+    double secondsOf(F &&f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Wynik pomiaru: mediana i minimum czasu pojedynczego przebiegu, alokacje jednego przebiegu
+    struct Measurement
+    {
+        double median = 0.0;
+        double best = 0.0;
+        long long allocations = 0;
+    };
+
+    // warmup przebiegów bez pomiaru, potem repeat przebiegów mierzonych
+    template <typename F>
+    Measurement measure(int warmup, int repeat, F &&f)
+    {
+        for (int i = 0; i < warmup; ++i)
+            f();
+        std::vector<double> times;
+        Measurement result;
+        for (int i = 0; i < std::max(1, repeat); ++i)
+        {
+            long long before = allocationStats().count;
+            times.push_back(secondsOf(f));
+            result.allocations = allocationStats().count - before;
+        }
+        std::sort(times.begin(), times.end());
+        result.median = times[times.size() / 2];
+        result.best = times.front();
+        return result;
+    }
+}
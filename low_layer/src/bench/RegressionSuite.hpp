@@ -0,0 +1,341 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../core/Instance.hpp"
+#include "../core/NEHWithProgress.hpp"
+#include "../core/SimulatedAnnealing.hpp"
+#include "BenchData.hpp"
+#include "BenchSupport.hpp"
+
+struct SuiteOptions
+{
+    std::string dataDir = "../data";
+    std::string filter;                       // fragment nazwy pliku; pusty = wszystkie
+    int warmup = 1;
+    int repeat = 5;
+    int saIterations = 20000;
+    std::vector<int> generatedSizes = {200, 500, 900};
+    int generatedMachines = 4;
+};
+
+// Wynik jednej instancji; czasy i przepustowości z najszybszego z repeat przebiegów
+// (minimum jest stabilniejsze od mediany przy krótkich pomiarach na obciążonej maszynie)
+struct SuiteResult
+{
+    std::string instance;
+    int jobs = 0;
+    int machines = 0;
+    double loadMs = 0.0;
+    double makespansPerSec = 0.0;
+    double nehMs = 0.0;
+    double saItersPerSec = 0.0;
+    double nehCmax = 0.0; // wyniki deterministyczne - zmiana oznacza zmianę zachowania
+    double saCmax = 0.0;
+    long long peakRssKb = 0;
+    long long allocLoad = 0; // alokacje jednego przebiegu
+    long long allocMakespan = 0;
+    long long allocNeh = 0;
+    long long allocSa = 0;
+};
+
+// Zestaw regresji: wczytywanie, computeMakespan, NEH i SA o stałej liczbie iteracji
+// na instancjach z data/ oraz wygenerowanych (n = 200/500/900). Wyniki można zapisać do JSON
+// i porównać z zapisanym wcześniej plikiem bazowym (compare()).
+class RegressionSuite
+{
+private:
+    SuiteOptions options;
+
+public:
+    explicit RegressionSuite(const SuiteOptions &suiteOptions) : options(suiteOptions) {}
+
+    std::vector<SuiteResult> run()
+    {
+        namespace fs = std::filesystem;
+        std::vector<std::pair<std::string, std::string>> inputs; // nazwa, ścieżka
+        if (fs::is_directory(options.dataDir))
+            for (const auto &entry : fs::directory_iterator(options.dataDir))
+                if (entry.path().extension() == ".txt")
+                    inputs.push_back({entry.path().filename().string(), entry.path().string()});
+        std::sort(inputs.begin(), inputs.end());
+
+        // Duże instancje zapisywane tymczasowo w formacie tekstowym, żeby mierzyć też wczytywanie
+        std::vector<std::string> temporary;
+        for (int n : options.generatedSizes)
+        {
+            std::string name = "generated_" + std::to_string(n) + "x" + std::to_string(options.generatedMachines);
+            fs::path path = fs::temp_directory_path() / ("pfsp_bench_" + name + ".txt");
+            if (!matches(name))
+                continue;
+            if (!writeTextInstance(generateData(n, options.generatedMachines, (unsigned)n), path.string()))
+                throw std::runtime_error("cannot write " + path.string());
+            inputs.push_back({name, path.string()});
+            temporary.push_back(path.string());
+        }
+
+        std::cout << std::left << std::setw(24) << "instance" << std::right << std::setw(10) << "load ms"
+                  << std::setw(14) << "makespans/s" << std::setw(10) << "NEH ms" << std::setw(12) << "SA it/s"
+                  << std::setw(10) << "RSS KiB" << std::setw(12) << "allocs" << "\n";
+
+        std::vector<SuiteResult> results;
+        for (const auto &input : inputs)
+        {
+            if (!matches(input.first))
+                continue;
+            SuiteResult r;
+            if (!runInstance(input.first, input.second, r))
+                continue;
+            results.push_back(r);
+            std::cout << std::left << std::setw(24) << r.instance << std::right << std::fixed << std::setprecision(3)
+                      << std::setw(10) << r.loadMs << std::setprecision(0) << std::setw(14) << r.makespansPerSec
+                      << std::setprecision(3) << std::setw(10) << r.nehMs << std::setprecision(0) << std::setw(12)
+                      << r.saItersPerSec << std::setw(10) << r.peakRssKb << std::setw(12)
+                      << (r.allocLoad + r.allocMakespan + r.allocNeh + r.allocSa) << std::defaultfloat << std::endl;
+        }
+
+        for (const auto &path : temporary)
+            std::remove(path.c_str());
+        return results;
+    }
+
+    static void writeJson(std::ostream &out, const std::vector<SuiteResult> &results, const SuiteOptions &opts)
+    {
+        out << "{\n  \"version\": 1, \"warmup\": " << opts.warmup << ", \"repeat\": " << opts.repeat
+            << ", \"sa_iterations\": " << opts.saIterations << ",\n  \"results\": [\n";
+        out << std::setprecision(10);
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const SuiteResult &r = results[i];
+            // Jeden obiekt na linię - readBaseline() czyta plik linia po linii
+            out << "    {\"instance\": \"" << r.instance << "\", \"jobs\": " << r.jobs << ", \"machines\": " << r.machines
+                << ", \"load_ms\": " << r.loadMs << ", \"makespans_per_s\": " << r.makespansPerSec
+                << ", \"neh_ms\": " << r.nehMs << ", \"sa_iterations_per_s\": " << r.saItersPerSec
+                << ", \"neh_cmax\": " << r.nehCmax << ", \"sa_cmax\": " << r.saCmax
+                << ", \"peak_rss_kb\": " << r.peakRssKb << ", \"alloc_load\": " << r.allocLoad
+                << ", \"alloc_makespan\": " << r.allocMakespan << ", \"alloc_neh\": " << r.allocNeh
+                << ", \"alloc_sa\": " << r.allocSa << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+
+    // Odczyt pliku zapisanego przez writeJson()
+    static std::vector<SuiteResult> readBaseline(const std::string &path)
+    {
+        std::ifstream in(path);
+        if (!in.is_open())
+            throw std::runtime_error("cannot open baseline " + path);
+        std::vector<SuiteResult> results;
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.find("\"instance\"") == std::string::npos)
+                continue;
+            auto fields = parseFlatObject(line);
+            SuiteResult r;
+            r.instance = fields["instance"];
+            r.jobs = (int)number(fields, "jobs");
+            r.machines = (int)number(fields, "machines");
+            r.loadMs = number(fields, "load_ms");
+            r.makespansPerSec = number(fields, "makespans_per_s");
+            r.nehMs = number(fields, "neh_ms");
+            r.saItersPerSec = number(fields, "sa_iterations_per_s");
+            r.nehCmax = number(fields, "neh_cmax");
+            r.saCmax = number(fields, "sa_cmax");
+            r.peakRssKb = (long long)number(fields, "peak_rss_kb");
+            r.allocLoad = (long long)number(fields, "alloc_load");
+            r.allocMakespan = (long long)number(fields, "alloc_makespan");
+            r.allocNeh = (long long)number(fields, "alloc_neh");
+            r.allocSa = (long long)number(fields, "alloc_sa");
+            results.push_back(r);
+        }
+        if (results.empty())
+            throw std::runtime_error("no results in baseline " + path);
+        return results;
+    }
+
+    // Wypisuje zmiany względem bazy; zwraca liczbę regresji (pogorszenie ponad tolerance albo zmiana wyniku)
+    static int compare(const std::vector<SuiteResult> &current, const std::vector<SuiteResult> &baseline, double tolerance)
+    {
+        std::map<std::string, const SuiteResult *> byName;
+        for (const auto &b : baseline)
+            byName[b.instance] = &b;
+
+        int regressions = 0;
+        int compared = 0;
+        double speedSum = 0.0;
+        int speedCount = 0;
+        for (const auto &c : current)
+        {
+            auto it = byName.find(c.instance);
+            if (it == byName.end())
+                continue;
+            const SuiteResult &b = *it->second;
+            ++compared;
+
+            std::vector<std::string> notes;
+            auto check = [&](const char *metric, double now, double before, bool higherIsBetter, double slack)
+            {
+                if (before <= 0.0 && now <= 0.0)
+                    return;
+                double ratio = higherIsBetter ? now / std::max(before, 1e-12) : before / std::max(now, 1e-12);
+                if (std::string(metric).find("alloc") == std::string::npos && std::string(metric) != "peak_rss_kb")
+                {
+                    speedSum += std::log(std::max(ratio, 1e-12));
+                    ++speedCount;
+                }
+                bool worse = higherIsBetter ? now < before * (1.0 - tolerance) : now > before * (1.0 + tolerance) + slack;
+                if (worse)
+                {
+                    std::ostringstream ss;
+                    ss << metric << " " << before << " -> " << now;
+                    notes.push_back(ss.str());
+                }
+            };
+            check("load_ms", c.loadMs, b.loadMs, false, 0.05);
+            check("makespans_per_s", c.makespansPerSec, b.makespansPerSec, true, 0.0);
+            check("neh_ms", c.nehMs, b.nehMs, false, 0.05);
+            check("sa_iterations_per_s", c.saItersPerSec, b.saItersPerSec, true, 0.0);
+            check("peak_rss_kb", (double)c.peakRssKb, (double)b.peakRssKb, false, 1024.0);
+            check("alloc_makespan", (double)c.allocMakespan, (double)b.allocMakespan, false, 0.0);
+            check("alloc_neh", (double)c.allocNeh, (double)b.allocNeh, false, 0.0);
+            check("alloc_sa", (double)c.allocSa, (double)b.allocSa, false, 0.0);
+            if (c.nehCmax != b.nehCmax || c.saCmax != b.saCmax)
+            {
+                std::ostringstream ss;
+                ss << "RESULT CHANGED neh " << b.nehCmax << " -> " << c.nehCmax << ", sa " << b.saCmax << " -> " << c.saCmax;
+                notes.push_back(ss.str());
+            }
+
+            if (!notes.empty())
+            {
+                ++regressions;
+                std::cout << "REGRESSION " << c.instance << ":";
+                for (const auto &n : notes)
+                    std::cout << "  " << n << ";";
+                std::cout << "\n";
+            }
+        }
+
+        std::cout << "Compared " << compared << " instances against baseline, " << regressions << " regressions";
+        if (speedCount > 0)
+            std::cout << ", geometric mean speed ratio x" << std::fixed << std::setprecision(3)
+                      << std::exp(speedSum / speedCount) << std::defaultfloat;
+        std::cout << std::endl;
+        return regressions;
+    }
+
+private:
+    bool matches(const std::string &name) const
+    {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    }
+
+    bool runInstance(const std::string &name, const std::string &path, SuiteResult &r)
+    {
+        bench::resetPeakRss();
+        r.instance = name;
+
+        auto load = bench::measure(options.warmup, options.repeat, [&]
+                                   { Instance probe(path);
+                                     probe.loadFromFile(false); });
+        Instance inst(path);
+        if (!inst.loadFromFile(false) || inst.getJobs() == 0)
+            return false;
+        r.jobs = inst.getJobs();
+        r.machines = inst.getMachines();
+        r.loadMs = load.best * 1e3;
+        r.allocLoad = load.allocations;
+
+        // Stały zestaw losowych sekwencji; liczba rund dobrana tak, by przebieg trwał ~20 ms
+        std::mt19937 rng(7);
+        std::vector<std::vector<int>> seqs(32, std::vector<int>(r.jobs));
+        for (auto &s : seqs)
+        {
+            std::iota(s.begin(), s.end(), 0);
+            std::shuffle(s.begin(), s.end(), rng);
+        }
+        double checksum = 0.0;
+        auto evalAll = [&]
+        {
+            for (const auto &s : seqs)
+                checksum += inst.computeMakespan(s);
+        };
+        double once = bench::secondsOf(evalAll);
+        int rounds = std::max(1, (int)(0.02 / std::max(once, 1e-9)));
+        auto makespan = bench::measure(options.warmup, options.repeat, [&]
+                                       { for (int k = 0; k < rounds; ++k) evalAll(); });
+        r.makespansPerSec = (double)seqs.size() * rounds / makespan.best;
+        r.allocMakespan = makespan.allocations / rounds;
+
+        Schedule nehResult;
+        auto neh = bench::measure(options.warmup, options.repeat, [&]
+                                  { NEHWithProgress solver(inst);
+                                    solver.setVerbose(false);
+                                    nehResult = solver.solve(); });
+        r.nehMs = neh.best * 1e3;
+        r.nehCmax = inst.computeMakespan(nehResult.getJobSequence());
+        r.allocNeh = neh.allocations;
+
+        Schedule saResult;
+        auto sa = bench::measure(options.warmup, options.repeat, [&]
+                                 { SimulatedAnnealing solver(inst, 1);
+                                   solver.setParameters(options.saIterations, 100.0, 0.9975);
+                                   solver.setVerbose(false);
+                                   saResult = solver.solve(); });
+        r.saItersPerSec = options.saIterations / sa.best;
+        r.saCmax = inst.computeMakespan(saResult.getJobSequence());
+        r.allocSa = sa.allocations;
+
+        r.peakRssKb = bench::peakRssKb();
+        return checksum > 0.0;
+    }
+
+    static std::map<std::string, std::string> parseFlatObject(const std::string &line)
+    {
+        std::map<std::string, std::string> fields;
+        size_t pos = 0;
+        while ((pos = line.find('"', pos)) != std::string::npos)
+        {
+            size_t keyEnd = line.find('"', pos + 1);
+            size_t colon = line.find(':', keyEnd);
+            if (keyEnd == std::string::npos || colon == std::string::npos)
+                break;
+            std::string key = line.substr(pos + 1, keyEnd - pos - 1);
+            size_t v = line.find_first_not_of(' ', colon + 1);
+            size_t end;
+            if (line[v] == '"')
+            {
+                end = line.find('"', v + 1);
+                fields[key] = line.substr(v + 1, end - v - 1);
+                ++end;
+            }
+            else
+            {
+                end = line.find_first_of(",}", v);
+                fields[key] = line.substr(v, end - v);
+            }
+            pos = end;
+        }
+        return fields;
+    }
+
+    static double number(std::map<std::string, std::string> &fields, const std::string &key)
+    {
+        auto it = fields.find(key);
+        if (it == fields.end() || it->second.empty())
+            return 0.0;
+        return std::stod(it->second);
+    }
+};
@@ -0,0 +1,1018 @@
+#include "../core/Instance.hpp"
+#include "../core/BatchMakespan.hpp"
+#include "../core/SimulatedAnnealing.hpp"
+#include "../core/SolutionCache.hpp"
+#include "../core/IteratedGreedy.hpp"
+#include "../core/LocalSearch.hpp"
+#include "../core/NEHWithProgress.hpp"
+#include "../core/BranchAndBound.hpp"
+#include "../core/ReschedulingSession.hpp"
+#include "BenchData.hpp"
+#include "BenchSupport.hpp"
+#include "RegressionSuite.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Poprzednia reprezentacja (vector<vector<...>> + .at()), jako punkt odniesienia
+    struct NestedInstance
+    {
+        int machines = 0;
+        std::vector<std::vector<int>> proc_time;
+        std::vector<std::vector<std::vector<int>>> setup_time;
+
+        explicit NestedInstance(const FlatData &d) : machines(d.machines)
+        {
+            proc_time.assign(d.jobs, std::vector<int>(d.machines, 0));
+            setup_time.assign(d.machines, std::vector<std::vector<int>>(d.jobs, std::vector<int>(d.jobs, 0)));
+            for (int j = 0; j < d.jobs; ++j)
+                for (int mach = 0; mach < d.machines; ++mach)
+                    proc_time[j][mach] = d.proc[(std::size_t)j * d.machines + mach];
+            for (int mach = 0; mach < d.machines; ++mach)
+                for (int i = 0; i < d.jobs; ++i)
+                    for (int j = 0; j < d.jobs; ++j)
+                        setup_time[mach][i][j] = d.setup[((std::size_t)mach * d.jobs + i) * d.jobs + j];
+        }
+
+        double computeMakespan(const std::vector<int> &seq) const
+        {
+            int n = (int)seq.size();
+            if (n == 0)
+                return 0.0;
+            int m = machines;
+            std::vector<std::vector<double>> completion(n, std::vector<double>(m, 0.0));
+            for (int idx = 0; idx < n; ++idx)
+            {
+                int job = seq[idx];
+                for (int mach = 0; mach < m; ++mach)
+                {
+                    double prevMachineTime = (mach > 0) ? completion[idx][mach - 1] : 0.0;
+                    double prevJobTime = (idx > 0) ? completion[idx - 1][mach] : 0.0;
+                    double setup = (idx > 0) ? setup_time.at(mach).at(seq[idx - 1]).at(job) : 0.0;
+                    completion[idx][mach] = std::max(prevMachineTime, prevJobTime + setup) + proc_time.at(job).at(mach);
+                }
+            }
+            return completion[n - 1][m - 1];
+        }
+    };
+
+    std::vector<std::vector<int>> randomSequences(int n, int count, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::vector<std::vector<int>> seqs(count, std::vector<int>(n));
+        for (auto &s : seqs)
+        {
+            std::iota(s.begin(), s.end(), 0);
+            std::shuffle(s.begin(), s.end(), rng);
+        }
+        return seqs;
+    }
+
+    // Liczba obliczeń makespanu na sekundę (pętla trwa co najmniej minSeconds)
+    template <typename Eval>
+    double makespansPerSecond(Eval &&eval, const std::vector<std::vector<int>> &seqs, double minSeconds, double &checksum)
+    {
+        using Clock = std::chrono::steady_clock;
+        long long evaluations = 0;
+        checksum = 0.0;
+        auto start = Clock::now();
+        double elapsed = 0.0;
+        do
+        {
+            for (const auto &s : seqs)
+                checksum += eval(s);
+            evaluations += (long long)seqs.size();
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < minSeconds);
+        return evaluations / elapsed;
+    }
+
+    // Kolejność LPT jak w NEHWithProgress::solve
+    std::vector<int> nehOrder(const Instance &inst)
+    {
+        std::vector<std::pair<long long, int>> jobKeys;
+        for (int j = 0; j < inst.getJobs(); ++j)
+        {
+            long long totalTime = 0;
+            for (int mach = 0; mach < inst.getMachines(); ++mach)
+                totalTime += inst.getProcTime(j, mach);
+            jobKeys.push_back({-totalTime, j});
+        }
+        std::sort(jobKeys.begin(), jobKeys.end());
+        std::vector<int> order;
+        for (const auto &k : jobKeys)
+            order.push_back(k.second);
+        return order;
+    }
+
+    // Pierwotne NEH: kopia sekwencji i pełny makespan dla każdej pozycji, na pierwotnej reprezentacji
+    std::vector<int> nehNaive(const NestedInstance &inst, const std::vector<int> &order)
+    {
+        std::vector<int> sequence;
+        if (!order.empty())
+            sequence.push_back(order[0]);
+        for (std::size_t t = 1; t < order.size(); ++t)
+        {
+            std::vector<int> bestSeq;
+            double bestMakespan = 1e18;
+            for (int pos = 0; pos <= (int)sequence.size(); ++pos)
+            {
+                std::vector<int> candidate = sequence;
+                candidate.insert(candidate.begin() + pos, order[t]);
+                double makespan = inst.computeMakespan(candidate);
+                if (makespan < bestMakespan)
+                {
+                    bestMakespan = makespan;
+                    bestSeq = candidate;
+                }
+            }
+            sequence = bestSeq;
+        }
+        return sequence;
+    }
+
+    // NEH na BatchMakespan::bestInsertion z wymuszoną ścieżką (skalarna = TaillardInsertion)
+    std::vector<int> nehBatch(const Instance &inst, const std::vector<int> &order, BatchMakespan::Isa isa)
+    {
+        BatchMakespan insertion(inst);
+        insertion.setIsa(isa);
+        std::vector<int> sequence;
+        if (!order.empty())
+            sequence.push_back(order[0]);
+        for (std::size_t t = 1; t < order.size(); ++t)
+        {
+            long long makespan = 0;
+            int pos = insertion.bestInsertion(sequence, order[t], makespan);
+            sequence.insert(sequence.begin() + pos, order[t]);
+        }
+        return sequence;
+    }
+
+    using bench::secondsOf;
+
+    // Produkcyjne NEHWithProgress i wstawianie na każdej wspieranej ścieżce muszą dać sekwencję
+    // pierwotnego NEH; zwraca false przy niezgodności
+    bool benchNEH(const std::string &name, const Instance &inst)
+    {
+        auto order = nehOrder(inst);
+        NestedInstance nested(extractData(inst));
+        std::vector<int> naive, shipped;
+        double naiveSec = secondsOf([&]
+                                    { naive = nehNaive(nested, order); });
+        double shippedSec = secondsOf([&]
+                                      {
+                                          NEHWithProgress neh(inst);
+                                          neh.setVerbose(false);
+                                          shipped = neh.solve().getJobSequence(); });
+        bool same = naive == shipped;
+        std::cout << std::left << "  " << std::setw(24) << name << std::right << std::fixed << std::setprecision(3)
+                  << " naive " << std::setw(9) << naiveSec * 1e3 << " ms"
+                  << "  neh " << std::setw(8) << shippedSec * 1e3 << " ms"
+                  << "  x" << std::setprecision(1) << naiveSec / std::max(shippedSec, 1e-9);
+        for (auto isa : {BatchMakespan::Isa::Scalar, BatchMakespan::Isa::Sse41, BatchMakespan::Isa::Avx2})
+        {
+            if (isa > BatchMakespan::detect())
+                continue;
+            std::vector<int> fast;
+            double fastSec = secondsOf([&]
+                                       { fast = nehBatch(inst, order, isa); });
+            bool sameIsa = fast == naive;
+            same = same && sameIsa;
+            std::cout << "  " << BatchMakespan::name(isa) << " " << std::setprecision(3) << fastSec * 1e3 << " ms"
+                      << (sameIsa ? "" : " differs");
+        }
+        std::cout << "  Cmax=" << std::setprecision(0) << inst.computeMakespan(shipped)
+                  << (same ? "" : "  MISMATCH") << std::defaultfloat << "\n";
+        return same;
+    }
+
+    // Przekierowuje std::cout (linie RESULT/SLOT z solverów) na czas pomiaru
+    class SilenceCout
+    {
+        std::ostringstream sink;
+        std::streambuf *saved;
+
+    public:
+        SilenceCout() : saved(std::cout.rdbuf(sink.rdbuf())) {}
+        ~SilenceCout() { std::cout.rdbuf(saved); }
+    };
+
+    // Iteracje SA na sekundę: pełne przeliczanie vs ocena przyrostowa
+    bool benchSA(const std::string &name, const Instance &inst, int iterations)
+    {
+        double seconds[2] = {0.0, 0.0};
+        double cmax[2] = {0.0, 0.0};
+        for (int incremental = 0; incremental < 2; ++incremental)
+        {
+            SimulatedAnnealing sa(inst, 1);
+            sa.setParameters(iterations, 100.0, 0.9975);
+            sa.setIncremental(incremental == 1);
+            Schedule result;
+            {
+                SilenceCout quiet;
+                seconds[incremental] = secondsOf([&]
+                                                 { result = sa.solve(); });
+            }
+            cmax[incremental] = inst.computeMakespan(result.getJobSequence());
+        }
+        bool same = cmax[0] == cmax[1];
+        std::cout << std::left << "  " << std::setw(24) << name << std::right << std::fixed << std::setprecision(0)
+                  << " full " << std::setw(10) << iterations / seconds[0] << " it/s"
+                  << "  incremental " << std::setw(10) << iterations / seconds[1] << " it/s"
+                  << "  x" << std::setprecision(1) << seconds[0] / std::max(seconds[1], 1e-9)
+                  << "  Cmax=" << std::setprecision(0) << cmax[1]
+                  << (same ? "" : "  MISMATCH") << std::defaultfloat << "\n";
+        return same;
+    }
+
+    // SA z cache odwiedzonych rozwiązań i bez: ten sam ciąg losowań, więc makespan musi być
+    // identyczny; opłacalność zależy od rozmiaru (częstość powrotów do sąsiadów maleje z n)
+    bool benchSACache(const std::string &name, const Instance &inst, int iterations)
+    {
+        double seconds[2] = {0.0, 0.0};
+        double cmax[2] = {0.0, 0.0};
+        SolutionCache::Counters counters;
+        for (int cached = 0; cached < 2; ++cached)
+        {
+            SolutionCache cache((std::size_t)1 << 20);
+            SimulatedAnnealing sa(inst, 1);
+            sa.setParameters(iterations, 100.0, 0.9995);
+            sa.setSolutionCache(cached == 1 ? &cache : nullptr);
+            Schedule result;
+            {
+                SilenceCout quiet;
+                seconds[cached] = secondsOf([&]
+                                            { result = sa.solve(); });
+            }
+            cmax[cached] = inst.computeMakespan(result.getJobSequence());
+            counters = sa.getCacheCounters();
+        }
+        bool same = cmax[0] == cmax[1];
+        std::cout << std::left << "  " << std::setw(24) << name << std::right << std::fixed << std::setprecision(0)
+                  << " plain " << std::setw(10) << iterations / seconds[0] << " it/s"
+                  << "  cached " << std::setw(10) << iterations / seconds[1] << " it/s"
+                  << "  hits " << std::setprecision(1) << std::setw(5) << counters.hitRate() << "%"
+                  << "  x" << std::setprecision(2) << seconds[0] / std::max(seconds[1], 1e-9)
+                  << (seconds[1] < seconds[0] ? "  pays off" : "  no gain")
+                  << "  Cmax=" << std::setprecision(0) << cmax[1]
+                  << (same ? "" : "  MISMATCH") << std::defaultfloat << "\n";
+        return same;
+    }
+
+    // Ocena wsadowa na każdej wspieranej ścieżce: makespany sekwencji i wstawień muszą być
+    // identyczne z computeMakespan; zwraca false przy niezgodności
+    bool benchBatch(const std::string &name, const Instance &inst, double minSeconds)
+    {
+        int n = inst.getJobs();
+        auto seqs = randomSequences(n, 64, 11);
+        std::vector<int> flat;
+        for (const auto &s : seqs)
+            flat.insert(flat.end(), s.begin(), s.end());
+        std::vector<int> base(seqs[0].begin(), seqs[0].end() - 1);
+        int job = seqs[0].back();
+
+        std::vector<long long> expected(seqs.size()), insertExpected(n);
+        for (std::size_t c = 0; c < seqs.size(); ++c)
+            expected[c] = inst.makespanOf(seqs[c]);
+        for (int pos = 0; pos < n; ++pos)
+        {
+            std::vector<int> candidate = base;
+            candidate.insert(candidate.begin() + pos, job);
+            insertExpected[pos] = inst.makespanOf(candidate);
+        }
+
+        bool allSame = true;
+        std::cout << "  " << name << "\n";
+        for (auto isa : {BatchMakespan::Isa::Scalar, BatchMakespan::Isa::Sse41, BatchMakespan::Isa::Avx2})
+        {
+            if (isa > BatchMakespan::detect())
+                continue;
+            BatchMakespan batch(inst);
+            batch.setIsa(isa);
+            std::vector<long long> out(seqs.size()), insertOut;
+            batch.evaluate(flat.data(), (int)seqs.size(), n, out.data());
+            batch.evaluateInsertions(base, job, insertOut);
+            bool same = out == expected && insertOut == insertExpected;
+            allSame = allSame && same;
+
+            long long evaluations = 0;
+            double elapsed = 0.0;
+            auto start = std::chrono::steady_clock::now();
+            do
+            {
+                batch.evaluate(flat.data(), (int)seqs.size(), n, out.data());
+                evaluations += (long long)seqs.size();
+                elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            } while (elapsed < minSeconds);
+
+            std::cout << std::left << "    " << std::setw(8) << BatchMakespan::name(isa) << std::right << std::fixed
+                      << std::setprecision(0) << std::setw(12) << evaluations / elapsed << " makespans/s"
+                      << (same ? "" : "  MISMATCH") << std::defaultfloat << "\n";
+        }
+        return allSame;
+    }
+
+    // Przeszukiwanie lokalne od NEH: 1 wątek vs wiele - wynik musi być identyczny; zwraca false przy niezgodności
+    bool benchLocalSearch(const std::string &name, const Instance &inst, int threads)
+    {
+        NEHWithProgress neh(inst);
+        neh.setVerbose(false);
+        Schedule start = neh.solve();
+
+        struct Config
+        {
+            const char *label;
+            LocalSearch::Neighborhood neighborhood;
+            LocalSearch::Strategy strategy;
+        };
+        const Config configs[] = {
+            {"insertion/first", LocalSearch::Neighborhood::Insertion, LocalSearch::Strategy::FirstImprovement},
+            {"insertion/best", LocalSearch::Neighborhood::Insertion, LocalSearch::Strategy::BestImprovement},
+            {"swap/first", LocalSearch::Neighborhood::Swap, LocalSearch::Strategy::FirstImprovement},
+            {"swap/best", LocalSearch::Neighborhood::Swap, LocalSearch::Strategy::BestImprovement},
+        };
+
+        bool allSame = true;
+        std::cout << "  " << name << " (NEH Cmax=" << inst.makespanOf(start.getJobSequence()) << ")\n";
+        for (const auto &cfg : configs)
+        {
+            std::vector<int> result[2];
+            LocalSearch::Stats stats[2];
+            for (int run = 0; run < 2; ++run)
+            {
+                LocalSearch search(inst, run == 0 ? 1 : threads);
+                search.setNeighborhood(cfg.neighborhood);
+                search.setStrategy(cfg.strategy);
+                search.setVerbose(false);
+                result[run] = search.solve(start).getJobSequence();
+                stats[run] = search.getStats();
+            }
+            bool same = result[0] == result[1];
+            allSame = allSame && same;
+            std::cout << std::left << "    " << std::setw(16) << cfg.label << std::right << std::fixed << std::setprecision(0)
+                      << " 1 thread " << std::setw(11) << stats[0].movesPerSecond() << " moves/s"
+                      << "  " << threads << " threads " << std::setw(11) << stats[1].movesPerSecond() << " moves/s"
+                      << "  moves=" << stats[0].improvements << "  Cmax=" << inst.makespanOf(result[1])
+                      << (same ? "" : "  MISMATCH") << std::defaultfloat << "\n";
+        }
+        return allSame;
+    }
+
+    // Zwraca false, jeśli któryś wariant przechowywania daje inny makespan niż reprezentacja bazowa
+    bool benchMakespan(const std::string &name, const FlatData &data, double minSeconds)
+    {
+        auto seqs = randomSequences(data.jobs, 32, 7);
+        NestedInstance nested(data);
+        double refChecksum = 0.0;
+        double refRate = makespansPerSecond([&](const std::vector<int> &s)
+                                            { return nested.computeMakespan(s); },
+                                            seqs, minSeconds, refChecksum);
+
+        std::cout << std::left << std::setw(24) << name << " n=" << data.jobs << " m=" << data.machines << "\n";
+        std::cout << "  " << std::setw(28) << "nested (baseline)" << std::fixed << std::setprecision(0)
+                  << std::right << std::setw(12) << refRate << " makespans/s\n";
+
+        struct Config
+        {
+            const char *label;
+            SetupLayout layout;
+            SetupEncoding encoding;
+        };
+        const Config configs[] = {
+            {"flat machine-major int32", SetupLayout::MachineMajor, SetupEncoding::Wide},
+            {"flat machine-major narrowest", SetupLayout::MachineMajor, SetupEncoding::Narrowest},
+            {"flat prev-job-major int32", SetupLayout::PrevJobMajor, SetupEncoding::Wide},
+            {"flat prev-job-major narrowest", SetupLayout::PrevJobMajor, SetupEncoding::Narrowest},
+            {"packed rows", SetupLayout::MachineMajor, SetupEncoding::Packed},
+        };
+
+        bool allSame = true;
+        for (const auto &cfg : configs)
+        {
+            Instance inst(name);
+            inst.setStorageOptions(cfg.layout, cfg.encoding);
+            inst.loadFromData(data.jobs, data.machines, data.proc, data.setup);
+
+            double checksum = 0.0;
+            double rate = makespansPerSecond([&](const std::vector<int> &s)
+                                             { return inst.computeMakespan(s); },
+                                             seqs, minSeconds, checksum);
+            // Sumy kontrolne zależą od liczby powtórzeń, więc porównujemy pojedyncze wyniki
+            bool same = true;
+            for (const auto &s : seqs)
+                same = same && inst.computeMakespan(s) == nested.computeMakespan(s);
+            allSame = allSame && same;
+
+            std::cout << std::left << "  " << std::setw(28) << cfg.label << std::right << std::setw(12) << rate
+                      << " makespans/s  x" << std::setprecision(2) << rate / refRate << std::setprecision(0)
+                      << "  setup=" << inst.getSetupMatrix().bytes() / 1024 << " KiB ("
+                      << SetupMatrix::widthName(inst.getSetupMatrix().getWidth()) << ")"
+                      << (same ? "" : "  MISMATCH") << "\n";
+        }
+        std::cout << std::defaultfloat;
+        return allSame;
+    }
+
+    // Porównania implementacji (warianty układu setupów, NEH naiwne/produkcyjne, SA pełne/przyrostowe);
+    // zwraca liczbę niezgodności wyników
+    int runVariants(const std::string &dataDir)
+    {
+        namespace fs = std::filesystem;
+        double minSeconds = 0.3;
+
+        std::vector<fs::path> allFiles;
+        if (fs::is_directory(dataDir))
+            for (const auto &entry : fs::directory_iterator(dataDir))
+                if (entry.path().extension() == ".txt")
+                    allFiles.push_back(entry.path());
+        std::sort(allFiles.begin(), allFiles.end());
+
+        int mismatches = 0;
+        std::cout << "=== Makespan kernel benchmark ===" << std::endl;
+        for (const auto &path : allFiles)
+        {
+            if (path.filename().string().rfind("40_4_", 0) != 0)
+                continue;
+            Instance inst(path.string());
+            inst.loadFromFile();
+            mismatches += benchMakespan(path.filename().string(), extractData(inst), minSeconds) ? 0 : 1;
+        }
+
+        mismatches += benchMakespan("generated_900", generateData(900, 2, 900), minSeconds) ? 0 : 1;
+
+        std::cout << "=== Batch evaluation (best supported: " << BatchMakespan::name(BatchMakespan::detect())
+                  << ") ===" << std::endl;
+        for (const auto &path : allFiles)
+        {
+            if (path.filename().string().rfind("40_", 0) != 0)
+                continue;
+            Instance inst(path.string());
+            inst.loadFromFile();
+            mismatches += benchBatch(path.filename().string(), inst, 0.1) ? 0 : 1;
+        }
+        for (SetupEncoding encoding : {SetupEncoding::Narrowest, SetupEncoding::Wide, SetupEncoding::Packed})
+        {
+            FlatData d = generateData(500, 4, 500);
+            Instance inst("generated_500");
+            inst.setStorageOptions(SetupLayout::MachineMajor, encoding);
+            inst.loadFromData(d.jobs, d.machines, d.proc, d.setup);
+            mismatches += benchBatch(std::string("generated_500 machine-major ") + SetupMatrix::widthName(inst.getSetupMatrix().getWidth()),
+                                     inst, 0.3) ? 0 : 1;
+        }
+
+        std::cout << "=== NEH: naive vs NEHWithProgress and batch insertion per ISA ===" << std::endl;
+        for (const auto &path : allFiles)
+        {
+            Instance inst(path.string());
+            inst.loadFromFile();
+            mismatches += benchNEH(path.filename().string(), inst) ? 0 : 1;
+        }
+        for (int n : {200, 500})
+        {
+            FlatData d = generateData(n, 4, n);
+            Instance inst("generated_" + std::to_string(n));
+            inst.loadFromData(d.jobs, d.machines, d.proc, d.setup);
+            mismatches += benchNEH("generated_" + std::to_string(n), inst) ? 0 : 1;
+        }
+
+        std::cout << "=== SA: full vs incremental swap evaluation ===" << std::endl;
+        for (const auto &path : allFiles)
+        {
+            if (path.filename().string().rfind("40_", 0) != 0)
+                continue;
+            Instance inst(path.string());
+            inst.loadFromFile();
+            mismatches += benchSA(path.filename().string(), inst, 50000) ? 0 : 1;
+        }
+        {
+            FlatData d = generateData(500, 4, 500);
+            Instance inst("generated_500");
+            inst.loadFromData(d.jobs, d.machines, d.proc, d.setup);
+            mismatches += benchSA("generated_500", inst, 20000) ? 0 : 1;
+        }
+
+        std::cout << "=== SA: revisited-solution cache (per instance size) ===" << std::endl;
+        for (const char *size : {"10_", "20_", "30_", "40_"})
+            for (const auto &path : allFiles)
+                if (path.filename().string().rfind(size, 0) == 0)
+                {
+                    Instance inst(path.string());
+                    inst.loadFromFile();
+                    mismatches += benchSACache(path.filename().string(), inst, 200000) ? 0 : 1;
+                    break;
+                }
+        for (int n : {200, 500})
+        {
+            FlatData d = generateData(n, 4, n);
+            Instance inst("generated_" + std::to_string(n));
+            inst.loadFromData(d.jobs, d.machines, d.proc, d.setup);
+            mismatches += benchSACache("generated_" + std::to_string(n), inst, 50000) ? 0 : 1;
+        }
+
+        int lsThreads = std::max(2, (int)std::min(8u, std::thread::hardware_concurrency()));
+        std::cout << "=== Local search: 1 vs " << lsThreads << " threads (identical result required) ===" << std::endl;
+        for (const auto &path : allFiles)
+        {
+            if (path.filename().string().rfind("40_4_", 0) != 0)
+                continue;
+            Instance inst(path.string());
+            inst.loadFromFile();
+            mismatches += benchLocalSearch(path.filename().string(), inst, lsThreads) ? 0 : 1;
+        }
+        {
+            FlatData d = generateData(200, 4, 200);
+            Instance inst("generated_200");
+            inst.loadFromData(d.jobs, d.machines, d.proc, d.setup);
+            mismatches += benchLocalSearch("generated_200", inst, lsThreads) ? 0 : 1;
+        }
+
+        return mismatches;
+    }
+
+    // Jakość przy równym czasie: NEH + SA i NEH + IG z tym samym limitem czasu, kilka ziaren.
+    // RPD - odchylenie [%] od najlepszego makespanu znalezionego dla instancji w całym porównaniu.
+    void runSolverComparison(const std::string &dataDir, const std::string &filter, const std::vector<double> &budgets, int seeds)
+    {
+        namespace fs = std::filesystem;
+        std::vector<fs::path> files;
+        if (fs::is_directory(dataDir))
+            for (const auto &entry : fs::directory_iterator(dataDir))
+                if (entry.path().extension() == ".txt" && entry.path().filename().string().find(filter) != std::string::npos)
+                    files.push_back(entry.path());
+        std::sort(files.begin(), files.end());
+
+        // wyniki[plik][limit][0 = SA, 1 = IG] - średnia po ziarnach
+        std::vector<std::vector<std::array<double, 2>>> mean(files.size(), std::vector<std::array<double, 2>>(budgets.size()));
+        std::vector<double> best(files.size(), 1e18);
+
+        std::cout << "=== SA vs Iterated Greedy (equal time, " << seeds << " seeds, start from NEH) ===" << std::endl;
+        std::cout << std::left << std::setw(16) << "instance" << std::right;
+        for (double b : budgets)
+            std::cout << std::setw(10) << ("SA " + std::to_string((int)(b * 1000)) + "ms") << std::setw(10)
+                      << ("IG " + std::to_string((int)(b * 1000)) + "ms");
+        std::cout << "\n";
+
+        for (std::size_t f = 0; f < files.size(); ++f)
+        {
+            Instance inst(files[f].string());
+            if (!inst.loadFromFile(false))
+                continue;
+            NEHWithProgress neh(inst);
+            neh.setVerbose(false);
+            Schedule start = neh.solve();
+
+            std::cout << std::left << std::setw(16) << files[f].filename().string() << std::right << std::fixed << std::setprecision(1);
+            for (std::size_t b = 0; b < budgets.size(); ++b)
+            {
+                SolveBudget budget;
+                budget.timeLimit = budgets[b];
+                for (int algorithm = 0; algorithm < 2; ++algorithm)
+                {
+                    double sum = 0.0;
+                    for (int seed = 1; seed <= seeds; ++seed)
+                    {
+                        budget.start();
+                        Schedule result;
+                        if (algorithm == 0)
+                        {
+                            SimulatedAnnealing sa(inst, seed);
+                            sa.setVerbose(false);
+                            sa.setBudget(budget);
+                            result = sa.solve(start);
+                        }
+                        else
+                        {
+                            IteratedGreedy ig(inst, seed);
+                            ig.setVerbose(false);
+                            ig.setBudget(budget);
+                            result = ig.solve(start);
+                        }
+                        double cmax = inst.computeMakespan(result.getJobSequence());
+                        best[f] = std::min(best[f], cmax);
+                        sum += cmax;
+                    }
+                    mean[f][b][algorithm] = sum / seeds;
+                    std::cout << std::setw(10) << mean[f][b][algorithm];
+                }
+            }
+            std::cout << std::defaultfloat << std::endl;
+        }
+
+        for (std::size_t b = 0; b < budgets.size(); ++b)
+        {
+            double rpd[2] = {0.0, 0.0};
+            int wins[2] = {0, 0};
+            int counted = 0;
+            for (std::size_t f = 0; f < files.size(); ++f)
+            {
+                if (best[f] >= 1e18)
+                    continue;
+                ++counted;
+                for (int a = 0; a < 2; ++a)
+                    rpd[a] += 100.0 * (mean[f][b][a] - best[f]) / best[f];
+                if (mean[f][b][0] != mean[f][b][1])
+                    ++wins[mean[f][b][1] < mean[f][b][0] ? 1 : 0];
+            }
+            if (!counted)
+                continue;
+            std::cout << std::fixed << std::setprecision(2) << "Budget " << (int)(budgets[b] * 1000) << " ms: mean RPD SA "
+                      << rpd[0] / counted << "%, IG " << rpd[1] / counted << "%; better on " << wins[1] << " (IG) vs "
+                      << wins[0] << " (SA) of " << counted << " instances" << std::defaultfloat << std::endl;
+        }
+    }
+
+    // Optimum z branch-and-bound (start od najlepszego SA) vs heurystyki: luka NEH i SA (seeds ziaren,
+    // saIterations iteracji od NEH) do optimum oraz luka dolnego ograniczenia; instancje bez dowodu
+    // optymalności w limicie 60 s są pomijane w średnich
+    void runExactComparison(const std::string &dataDir, const std::string &filter, int seeds, int saIterations, int threads)
+    {
+        namespace fs = std::filesystem;
+        std::vector<fs::path> files;
+        if (fs::is_directory(dataDir))
+            for (const auto &entry : fs::directory_iterator(dataDir))
+                if (entry.path().extension() == ".txt" && entry.path().filename().string().find(filter) != std::string::npos)
+                    files.push_back(entry.path());
+        std::sort(files.begin(), files.end());
+
+        std::cout << "=== Branch and bound vs heuristics (threads=" << threads << ", SA " << saIterations << " iterations, "
+                  << seeds << " seeds) ===" << std::endl;
+        std::cout << std::left << std::setw(16) << "instance" << std::right << std::setw(8) << "LB" << std::setw(8) << "opt"
+                  << std::setw(8) << "NEH" << std::setw(10) << "SA mean" << std::setw(12) << "nodes" << std::setw(10) << "ms"
+                  << "\n";
+
+        double gapSum[3] = {0.0, 0.0, 0.0}; // LB, NEH, SA względem optimum
+        int proven = 0, saOptimal = 0, saRuns = 0;
+        for (const auto &path : files)
+        {
+            Instance inst(path.string());
+            if (!inst.loadFromFile(false))
+                continue;
+            NEHWithProgress neh(inst);
+            neh.setVerbose(false);
+            Schedule start = neh.solve();
+            double nehCmax = inst.computeMakespan(start.getJobSequence());
+
+            double saSum = 0.0;
+            std::vector<double> saCmax;
+            Schedule incumbent = start;
+            for (int seed = 1; seed <= seeds; ++seed)
+            {
+                SimulatedAnnealing sa(inst, seed);
+                sa.setParameters(saIterations, 100.0, 0.9975);
+                sa.setVerbose(false);
+                Schedule result = sa.solve(start);
+                double cmax = inst.computeMakespan(result.getJobSequence());
+                saSum += cmax;
+                saCmax.push_back(cmax);
+                if (cmax < inst.computeMakespan(incumbent.getJobSequence()))
+                    incumbent = result;
+            }
+
+            BranchAndBound exact(inst, threads);
+            exact.setVerbose(false);
+            SolveBudget budget;
+            budget.timeLimit = 60.0;
+            exact.setBudget(budget);
+            Schedule optimum = exact.solve(incumbent);
+            const auto &stats = exact.getStats();
+            double opt = inst.computeMakespan(optimum.getJobSequence());
+            double saMean = saSum / seeds;
+
+            std::cout << std::left << std::setw(16) << path.filename().string() << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(8) << stats.rootBound << std::setw(8) << opt << (stats.proven ? "" : "?") << std::setw(8)
+                      << nehCmax << std::setw(10) << saMean << std::setw(12) << stats.nodes << std::setw(10)
+                      << stats.seconds * 1000 << std::defaultfloat << "\n";
+            if (!stats.proven)
+                continue;
+            ++proven;
+            gapSum[0] += 100.0 * (opt - stats.rootBound) / opt;
+            gapSum[1] += 100.0 * (nehCmax - opt) / opt;
+            gapSum[2] += 100.0 * (saMean - opt) / opt;
+            saRuns += seeds;
+            saOptimal += (int)std::count(saCmax.begin(), saCmax.end(), opt);
+        }
+        if (!proven)
+            return;
+        std::cout << std::fixed << std::setprecision(2) << "Proven optimal: " << proven << " of " << files.size()
+                  << " instances; mean gap to optimum: NEH " << gapSum[1] / proven << "%, SA " << gapSum[2] / proven
+                  << "% (SA optimal in " << saOptimal << " of " << saRuns << " runs); lower bound below optimum by " << gapSum[0] / proven
+                  << "%" << std::defaultfloat << std::endl;
+    }
+
+    // Harmonogramy temperatury SA przy równej liczbie iteracji od NEH: T0 = 100 / alfa = 0.9975 (domyślne,
+    // przycięte do zakresu ruchów), kalibracja z próbki ruchów, Lundy-Mees i Lundy-Mees z podgrzewaniem (co 1/20 iteracji).
+    // RPD - odchylenie [%] od najlepszego makespanu instancji w porównaniu
+    void runScheduleComparison(const std::string &dataDir, const std::string &filter, int seeds, int saIterations)
+    {
+        namespace fs = std::filesystem;
+        std::vector<fs::path> files;
+        if (fs::is_directory(dataDir))
+            for (const auto &entry : fs::directory_iterator(dataDir))
+                if (entry.path().extension() == ".txt" && entry.path().filename().string().find(filter) != std::string::npos)
+                    files.push_back(entry.path());
+        std::sort(files.begin(), files.end());
+
+        const char *names[] = {"fixed", "calibrated", "lundy-mees", "lm+reheat"};
+        AnnealingSchedule schedules[4];
+        schedules[1].calibrate = true;
+        schedules[2].calibrate = true;
+        schedules[2].cooling = CoolingSchedule::LundyMees;
+        schedules[3] = schedules[2];
+        schedules[3].reheatInterval = std::max(1, saIterations / 20);
+
+        std::cout << "=== SA temperature schedules (" << saIterations << " iterations, " << seeds << " seeds, start from NEH) ===" << std::endl;
+        std::cout << std::left << std::setw(16) << "instance" << std::right;
+        for (const char *name : names)
+            std::cout << std::setw(12) << name;
+        std::cout << "\n";
+
+        double rpd[4] = {0.0, 0.0, 0.0, 0.0}, seconds[4] = {0.0, 0.0, 0.0, 0.0};
+        int wins[4] = {0, 0, 0, 0};
+        int counted = 0;
+        for (const auto &path : files)
+        {
+            Instance inst(path.string());
+            if (!inst.loadFromFile(false))
+                continue;
+            NEHWithProgress neh(inst);
+            neh.setVerbose(false);
+            Schedule start = neh.solve();
+
+            double mean[4];
+            std::cout << std::left << std::setw(16) << path.filename().string() << std::right << std::fixed << std::setprecision(1);
+            for (int v = 0; v < 4; ++v)
+            {
+                double sum = 0.0;
+                for (int seed = 1; seed <= seeds; ++seed)
+                {
+                    SimulatedAnnealing sa(inst, seed);
+                    sa.setParameters(saIterations, 100.0, 0.9975);
+                    sa.setSchedule(schedules[v]);
+                    sa.setVerbose(false);
+                    Schedule result;
+                    seconds[v] += secondsOf([&]
+                                            { result = sa.solve(start); });
+                    sum += inst.computeMakespan(result.getJobSequence());
+                }
+                mean[v] = sum / seeds;
+                std::cout << std::setw(12) << mean[v];
+            }
+            std::cout << std::defaultfloat << "\n";
+
+            double best = *std::min_element(mean, mean + 4);
+            ++counted;
+            for (int v = 0; v < 4; ++v)
+            {
+                rpd[v] += 100.0 * (mean[v] - best) / best;
+                wins[v] += (mean[v] == best) ? 1 : 0;
+            }
+        }
+        if (!counted)
+            return;
+        for (int v = 0; v < 4; ++v)
+            std::cout << std::fixed << std::setprecision(3) << std::left << std::setw(12) << names[v] << std::right
+                      << " mean RPD " << rpd[v] / counted << "%, best on " << wins[v] << " of " << counted << " instances, "
+                      << std::setprecision(0) << (double)counted * seeds * saIterations / std::max(seconds[v], 1e-9) << " it/s"
+                      << std::defaultfloat << std::endl;
+    }
+
+    // Sesja przeplanowania: naprzemienne losowe dodania i usunięcia zadań (instancja jobs x 5),
+    // percentyle opóźnienia zmiany z podziałem na etapy; co 50 zmian porównanie z liczeniem od zera
+    // (NEH + IG o tej samej liczbie iteracji) na tej samej instancji
+    void runRescheduleBench(int jobs, int updates)
+    {
+        const int machines = 5;
+        FlatData d = generateData(jobs, machines, 7);
+        Instance inst("generated");
+        inst.loadFromData(d.jobs, d.machines, d.proc, d.setup);
+        ReschedulingSession session(inst);
+        const auto &settings = session.getSettings();
+        std::cout << "=== Rescheduling session (" << jobs << " x " << machines << ", " << updates << " updates, IG "
+                  << settings.iterations << " iterations per update) ===" << std::endl;
+        std::cout << "Open: Cmax " << session.getMakespan() << ", " << session.lastUpdate().totalMs << " ms" << std::endl;
+
+        std::mt19937 rng(11);
+        std::uniform_int_distribution<int> procDist(5, 15), setupDist(5, 10);
+        std::vector<double> total, rebuild, repair, optimize;
+        double gainSum = 0.0, coldMs = 0.0, warmMs = 0.0, coldGap = 0.0;
+        int compared = 0;
+        for (int u = 0; u < updates; ++u)
+        {
+            int n = session.getJobs();
+            if (u % 2 == 1)
+                session.removeJob(session.getJobIds()[rng() % n]);
+            else
+            {
+                std::vector<int> procRow(machines), in((std::size_t)machines * n), out((std::size_t)machines * n);
+                for (int &v : procRow)
+                    v = procDist(rng);
+                for (std::size_t i = 0; i < in.size(); ++i)
+                {
+                    in[i] = setupDist(rng);
+                    out[i] = setupDist(rng);
+                }
+                session.addJob(procRow, in, out);
+            }
+            const auto &last = session.lastUpdate();
+            total.push_back(last.totalMs);
+            rebuild.push_back(last.rebuildMs);
+            repair.push_back(last.repairMs);
+            optimize.push_back(last.optimizeMs);
+            gainSum += 100.0 * (double)(last.repairedMakespan - last.makespan) / (double)last.repairedMakespan;
+
+            if ((u + 1) % 50 == 0)
+            {
+                const Instance &current = session.getInstance();
+                Schedule cold;
+                coldMs += 1000.0 * secondsOf([&]
+                                             {
+                                                 NEHWithProgress neh(current);
+                                                 neh.setVerbose(false);
+                                                 IteratedGreedy greedy(current, settings.seed);
+                                                 greedy.setParameters(settings.iterations, settings.destroy, settings.temperature);
+                                                 greedy.setLocalSearch(false);
+                                                 greedy.setVerbose(false);
+                                                 cold = greedy.solve(neh.solve()); });
+                warmMs += last.totalMs;
+                double coldCmax = current.computeMakespan(cold.getJobSequence());
+                coldGap += 100.0 * ((double)session.getMakespan() - coldCmax) / coldCmax;
+                ++compared;
+            }
+        }
+
+        auto percentile = [](std::vector<double> v, double q)
+        {
+            std::sort(v.begin(), v.end());
+            return v.empty() ? 0.0 : v[std::min(v.size() - 1, (std::size_t)(q * (double)v.size()))];
+        };
+        std::cout << std::left << std::setw(10) << "stage" << std::right << std::setw(10) << "p50 ms" << std::setw(10)
+                  << "p95 ms" << std::setw(10) << "max ms" << "\n" << std::fixed << std::setprecision(3);
+        const char *names[] = {"rebuild", "repair", "optimize", "total"};
+        const std::vector<double> *stages[] = {&rebuild, &repair, &optimize, &total};
+        for (int s = 0; s < 4; ++s)
+            std::cout << std::left << std::setw(10) << names[s] << std::right << std::setw(10) << percentile(*stages[s], 0.5)
+                      << std::setw(10) << percentile(*stages[s], 0.95) << std::setw(10) << percentile(*stages[s], 1.0) << "\n";
+        std::cout << std::setprecision(2) << "Re-optimization improves the repaired plan by " << gainSum / std::max(1, updates)
+                  << "% on average" << std::endl;
+        if (compared)
+            std::cout << "Cold start (NEH + IG) every 50 updates: " << coldMs / compared << " ms vs " << warmMs / compared
+                      << " ms incremental; incremental Cmax " << (coldGap >= 0 ? "+" : "") << coldGap / compared
+                      << "% vs cold" << std::defaultfloat << std::endl;
+    }
+
+    bool parseOption(const std::string &arg, const std::string &key, std::string &value)
+    {
+        std::string prefix = "--" + key + "=";
+        if (arg.rfind(prefix, 0) != 0)
+            return false;
+        value = arg.substr(prefix.size());
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    SuiteOptions suite;
+    bool variants = false;
+    bool solvers = false;
+    bool exact = false;
+    bool schedules = false;
+    int rescheduleJobs = 0;
+    int threads = 1;
+    std::vector<double> budgets = {0.05, 0.25};
+    int seeds = 3;
+    std::string jsonPath, baselinePath;
+    double tolerance = 0.15;
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i], value;
+            if (arg == "--variants")
+                variants = true;
+            else if (arg == "--ig-vs-sa")
+                solvers = true;
+            else if (arg == "--exact")
+                exact = true;
+            else if (arg == "--sa-schedules")
+                schedules = true;
+            else if (arg == "--reschedule")
+                rescheduleJobs = 300;
+            else if (parseOption(arg, "reschedule", value))
+                rescheduleJobs = std::max(2, std::stoi(value));
+            else if (parseOption(arg, "threads", value))
+                threads = std::max(1, std::stoi(value));
+            else if (parseOption(arg, "budgets", value))
+            {
+                budgets.clear();
+                for (std::stringstream list(value); std::getline(list, value, ',');)
+                    budgets.push_back(std::stod(value));
+            }
+            else if (parseOption(arg, "seeds", value))
+                seeds = std::max(1, std::stoi(value));
+            else if (parseOption(arg, "data", value))
+                suite.dataDir = value;
+            else if (parseOption(arg, "filter", value))
+                suite.filter = value;
+            else if (parseOption(arg, "warmup", value))
+                suite.warmup = std::stoi(value);
+            else if (parseOption(arg, "repeat", value))
+                suite.repeat = std::stoi(value);
+            else if (parseOption(arg, "sa-iters", value))
+                suite.saIterations = std::stoi(value);
+            else if (parseOption(arg, "json", value))
+                jsonPath = value;
+            else if (parseOption(arg, "compare", value))
+                baselinePath = value;
+            else if (parseOption(arg, "tolerance", value))
+                tolerance = std::stod(value);
+            else if (arg.rfind("--", 0) != 0)
+                suite.dataDir = arg;
+            else
+                throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << "\n"
+                  << "Usage: " << argv[0] << " [data_dir] [--filter=TEXT] [--warmup=N] [--repeat=N] [--sa-iters=N]"
+                  << " [--json=results.json] [--compare=baseline.json] [--tolerance=0.15] [--variants]"
+                  << " [--ig-vs-sa [--budgets=0.05,0.25] [--seeds=3]] [--exact [--seeds=3] [--threads=N]]"
+                  << " [--sa-schedules [--seeds=3]] [--reschedule[=JOBS]]" << std::endl;
+        return 1;
+    }
+
+    if (solvers)
+    {
+        runSolverComparison(suite.dataDir, suite.filter.empty() ? "40_" : suite.filter, budgets, seeds);
+        return 0;
+    }
+
+    if (rescheduleJobs > 0)
+    {
+        runRescheduleBench(rescheduleJobs, 200);
+        return 0;
+    }
+
+    if (schedules)
+    {
+        runScheduleComparison(suite.dataDir, suite.filter, seeds, suite.saIterations);
+        return 0;
+    }
+
+    if (exact)
+    {
+        runExactComparison(suite.dataDir, suite.filter.empty() ? "10_" : suite.filter, seeds, suite.saIterations, threads);
+        return 0;
+    }
+
+    if (variants)
+    {
+        int mismatches = runVariants(suite.dataDir);
+        if (mismatches)
+            std::cout << "Mismatches: " << mismatches << std::endl;
+        return mismatches ? 1 : 0;
+    }
+
+    try
+    {
+        std::vector<SuiteResult> baseline;
+        if (!baselinePath.empty())
+            baseline = RegressionSuite::readBaseline(baselinePath);
+
+        std::cout << "=== Regression suite (warmup " << suite.warmup << ", repeat " << suite.repeat
+                  << ", SA " << suite.saIterations << " iterations) ===" << std::endl;
+        auto results = RegressionSuite(suite).run();
+
+        if (!jsonPath.empty())
+        {
+            std::ofstream out(jsonPath);
+            if (!out.is_open())
+                throw std::runtime_error("cannot write " + jsonPath);
+            RegressionSuite::writeJson(out, results, suite);
+            std::cout << "Results written to: " << jsonPath << std::endl;
+        }
+
+        if (!baselinePath.empty() && RegressionSuite::compare(results, baseline, tolerance) > 0)
+            return 2;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+
+// Kształt spadku temperatury między T0 a temperaturą końcową
+enum class CoolingSchedule
+{
+    Geometric, // T *= alfa w każdej iteracji
+    LundyMees  // T = T / (1 + beta * T): szybko przy wysokiej temperaturze, wolno przy niskiej
+};
+
+// Harmonogram temperatury (obok parametrów iteracje / T0 / chłodzenie)
+struct AnnealingSchedule
+{
+    CoolingSchedule cooling = CoolingSchedule::Geometric;
+    bool calibrate = false; // T0 i temperatura końcowa z próbki losowych ruchów zamiast T0 i współczynnika
+    int reheatInterval = 0; // > 0 = podgrzanie po tylu iteracjach bez poprawy najlepszego wyniku
+
+    // Nazwy jak w --sa-schedule (geometric / lundy-mees)
+    static bool parseCooling(const std::string &text, CoolingSchedule &out)
+    {
+        if (text == "geometric")
+            out = CoolingSchedule::Geometric;
+        else if (text == "lundy-mees")
+            out = CoolingSchedule::LundyMees;
+        else
+            return false;
+        return true;
+    }
+
+    static const char *coolingName(CoolingSchedule cooling)
+    {
+        return cooling == CoolingSchedule::LundyMees ? "lundy-mees" : "geometric";
+    }
+};
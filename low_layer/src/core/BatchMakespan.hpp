@@ -0,0 +1,313 @@
+#pragma once
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <vector>
+#include "Instance.hpp"
+#include "MakespanKernel.hpp"
+#include "TaillardInsertion.hpp"
+
+// Jądra wektorowe z BatchMakespanSimd.cpp; wywoływane dopiero po sprawdzeniu CPU
+namespace batch_simd
+{
+    // Wstawienie jednego zadania na wszystkie pozycje 0..L; tablice ułożone [maszyna][pozycja],
+    // wiersz maszyny ma stride elementów (wielokrotność 8, dopełnienie zerami)
+    struct InsertionLanes
+    {
+        int machines = 0;
+        int positions = 0; // L + 1
+        int stride = 0;
+        const std::int32_t *head = nullptr;     // zakończenie poprzednika (0 dla pozycji 0)
+        const std::int32_t *tail = nullptr;     // ogon następnika (0 dla pozycji L)
+        const std::int32_t *setupIn = nullptr;  // s_k(poprzednik, job)
+        const std::int32_t *setupOut = nullptr; // s_k(job, następnik)
+        const std::int32_t *proc = nullptr;     // p[job][k]
+    };
+
+    // Spłaszczone dane instancji, z których tory zbierają czasy (gather);
+    // indeks przezbrojenia = prev * prevStride + curr * currStride + k * machineStride
+    struct SequenceLanes
+    {
+        int machines = 0;
+        const std::int32_t *proc = nullptr;
+        const std::int32_t *setupWide = nullptr;
+        const std::uint16_t *setupNarrow = nullptr;
+        const std::uint8_t *setupByte = nullptr;
+        bool narrowPadded = false; // za tablicą 8/16-bitową jest zapas na odczyt 32-bitowy (AlignedArray)
+        int prevStride = 0;
+        int currStride = 0;
+        int machineStride = 0;
+    };
+
+    bool cpuHasSse41();
+    bool cpuHasAvx2();
+
+    void insertionsSse41(const InsertionLanes &lanes, long long *out);
+    void insertionsAvx2(const InsertionLanes &lanes, long long *out);
+
+    // count sekwencji po length zadań (seqs[c * length + i]); scratch: machines * 8 elementów.
+    // Tylko AVX2 - bez sprzętowego gathera (SSE4.1) tory wolniejsze od wersji skalarnej.
+    void sequencesAvx2(const SequenceLanes &data, const int *seqs, int count, int length, std::int32_t *scratch, long long *out);
+}
+
+// Ocena wielu kandydatów naraz: jeden kandydat na tor wektora (AVX2 - 8, SSE4.1 - 4 tory int32;
+// pełne sekwencje wymagają gathera, więc na SSE4.1 liczone są skalarnie).
+// Ścieżka wybierana w czasie wykonania (najszersza wspierana); ścieżka skalarna to zwykłe jądro
+// makespanu i TaillardInsertion. Tory int32 są używane tylko, gdy górne ograniczenie makespanu
+// instancji mieści się w int32 - wyniki wszystkich ścieżek są identyczne.
+class BatchMakespan
+{
+public:
+    enum class Isa
+    {
+        Scalar,
+        Sse41,
+        Avx2
+    };
+
+private:
+    const Instance &instance;
+    TaillardInsertion insertion;
+    Isa isa;
+    int fits32 = -1; // -1 = jeszcze nie sprawdzone
+
+    std::vector<std::int32_t> head, tail, setupIn, setupOut, row, scratch;
+    std::vector<long long> positionMakespans;
+
+public:
+    explicit BatchMakespan(const Instance &inst) : instance(inst), insertion(inst), isa(detect()) {}
+
+    static Isa detect()
+    {
+        if (batch_simd::cpuHasAvx2())
+            return Isa::Avx2;
+        if (batch_simd::cpuHasSse41())
+            return Isa::Sse41;
+        return Isa::Scalar;
+    }
+
+    static const char *name(Isa path)
+    {
+        switch (path)
+        {
+        case Isa::Avx2:
+            return "avx2";
+        case Isa::Sse41:
+            return "sse4.1";
+        default:
+            return "scalar";
+        }
+    }
+
+    // Wymuszenie węższej ścieżki (porównania); szersza niż wspierana przez CPU jest obcinana
+    void setIsa(Isa requested) { isa = std::min(requested, detect()); }
+    Isa getIsa() const { return isa; }
+
+    // Makespany count sekwencji po length zadań ułożonych jedna za drugą w seqs
+    void evaluate(const int *seqs, int count, int length, long long *out)
+    {
+        if (count <= 0)
+            return;
+        if (isa != Isa::Avx2 || !lanes32() || !gatherable() || (long long)count * length > INT_MAX)
+        {
+            for (int c = 0; c < count; ++c)
+                out[c] = instance.visitKernel([&](const auto &setup, auto M)
+                                              { return makespan_kernel::makespan<decltype(M)::value>(
+                                                    setup, instance.getProcMatrix(), seqs + (std::size_t)c * length, length,
+                                                    instance.getMachines()); });
+            return;
+        }
+
+        scratch.resize((std::size_t)instance.getMachines() * 8);
+        batch_simd::sequencesAvx2(sequenceLanes(), seqs, count, length, scratch.data(), out);
+    }
+
+    // Makespany wstawienia job na każdą pozycję 0..L sekwencji base (out: L + 1 wartości)
+    void evaluateInsertions(const std::vector<int> &base, int job, std::vector<long long> &out)
+    {
+        int L = (int)base.size();
+        out.resize((std::size_t)L + 1);
+        if (!lanes32())
+        {
+            std::vector<int> candidate;
+            for (int pos = 0; pos <= L; ++pos)
+            {
+                candidate = base;
+                candidate.insert(candidate.begin() + pos, job);
+                out[pos] = instance.makespanOf(candidate);
+            }
+            return;
+        }
+
+        batch_simd::InsertionLanes lanes = instance.visitKernel([&](const auto &setup, auto M)
+                                                                { return prepareInsertions<decltype(M)::value>(setup, base, job); });
+        if (isa == Isa::Avx2)
+            batch_simd::insertionsAvx2(lanes, out.data());
+        else if (isa == Isa::Sse41)
+            batch_simd::insertionsSse41(lanes, out.data());
+        else
+            insertionsScalar(lanes, out.data());
+    }
+
+    // Pierwsza pozycja o minimalnym makespanie (jak TaillardInsertion::bestPosition)
+    int bestInsertion(const std::vector<int> &base, int job, long long &bestMakespan)
+    {
+        if (isa == Isa::Scalar || !lanes32())
+            return insertion.bestPosition(base, job, bestMakespan);
+
+        evaluateInsertions(base, job, positionMakespans);
+        auto best = std::min_element(positionMakespans.begin(), positionMakespans.end());
+        bestMakespan = *best;
+        return (int)(best - positionMakespans.begin());
+    }
+
+private:
+    // Najdłuższa ścieżka przechodzi przez n + m - 1 operacji i co najwyżej n - 1 przezbrojeń
+    bool lanes32()
+    {
+        if (fits32 >= 0)
+            return fits32 == 1;
+        int n = instance.getJobs();
+        int m = instance.getMachines();
+        long long maxProc = 0;
+        for (int j = 0; j < n; ++j)
+            for (int k = 0; k < m; ++k)
+                maxProc = std::max<long long>(maxProc, instance.getProcTime(j, k));
+
+        const SetupMatrix &setups = instance.getSetupMatrix();
+        long long maxSetup = (setups.getWidth() == SetupMatrix::Width::Narrow8) ? UINT8_MAX : UINT16_MAX;
+        if (setups.getWidth() == SetupMatrix::Width::Wide32 || setups.getWidth() == SetupMatrix::Width::Packed)
+        {
+            maxSetup = 0;
+            setups.visit([&](const auto &setup)
+                         {
+                for (int k = 0; k < m; ++k)
+                    for (int a = 0; a < n; ++a)
+                        for (int b = 0; b < n; ++b)
+                            maxSetup = std::max<long long>(maxSetup, setup(k, a, b)); });
+        }
+        long long bound = (long long)(n + m) * maxProc + (long long)n * maxSetup;
+        long long indices = (long long)n * n * m;
+        fits32 = (bound < INT_MAX && indices < INT_MAX) ? 1 : 0;
+        return fits32 == 1;
+    }
+
+    // Gather pełnych sekwencji czyta macierz bezpośrednio - nie dla upakowanej
+    bool gatherable() const { return instance.getSetupMatrix().getWidth() != SetupMatrix::Width::Packed; }
+
+    batch_simd::SequenceLanes sequenceLanes() const
+    {
+        const SetupMatrix &setups = instance.getSetupMatrix();
+        int n = instance.getJobs();
+        int m = instance.getMachines();
+        batch_simd::SequenceLanes data;
+        data.machines = m;
+        data.proc = instance.getProcMatrix().row(0);
+        if (setups.getWidth() == SetupMatrix::Width::Narrow16)
+        {
+            data.setupNarrow = static_cast<const std::uint16_t *>(setups.rawData());
+            data.narrowPadded = !setups.isExternal();
+        }
+        else if (setups.getWidth() == SetupMatrix::Width::Narrow8)
+        {
+            data.setupByte = static_cast<const std::uint8_t *>(setups.rawData());
+            data.narrowPadded = !setups.isExternal();
+        }
+        else
+            data.setupWide = static_cast<const std::int32_t *>(setups.rawData());
+        if (setups.getLayout() == SetupLayout::MachineMajor)
+        {
+            data.prevStride = n;
+            data.currStride = 1;
+            data.machineStride = n * n;
+        }
+        else
+        {
+            data.prevStride = n * m;
+            data.currStride = m;
+            data.machineStride = 1;
+        }
+        return data;
+    }
+
+    // Głowy, ogony i przezbrojenia sąsiadów w układzie [maszyna][pozycja] (jak w TaillardInsertion)
+    template <int M, typename SetupAccess>
+    batch_simd::InsertionLanes prepareInsertions(const SetupAccess &setup, const std::vector<int> &base, int job)
+    {
+        using namespace makespan_kernel;
+        const ProcMatrix &proc = instance.getProcMatrix();
+        int m = instance.getMachines();
+        int L = (int)base.size();
+        int stride = (L + 1 + 7) / 8 * 8;
+        std::size_t total = (std::size_t)m * stride;
+        // Pojemność od razu na największe wstawienie (L = n - 1), żeby NEH nie realokował buforów co krok
+        std::size_t largest = (std::size_t)m * ((instance.getJobs() + 7) / 8 * 8);
+        for (auto *buffer : {&head, &tail, &setupIn, &setupOut})
+            buffer->reserve(std::max(total, largest));
+        for (auto *buffer : {&head, &tail, &setupIn, &setupOut})
+            buffer->resize(total);
+        row.resize(m);
+
+        // Głowy razem z przezbrojeniami od poprzednika i do następnika każdej pozycji
+        for (int i = 0; i < L; ++i)
+        {
+            forwardRow<M>(setup, proc.row(base[i]), m, (i > 0) ? base[i - 1] : -1, base[i], (i > 0) ? row.data() : nullptr,
+                          row.data());
+            for (int k = 0; k < m; ++k)
+            {
+                std::size_t at = (std::size_t)k * stride + i;
+                head[at + 1] = row[k];
+                setupIn[at + 1] = setup(k, base[i], job);
+                setupOut[at] = setup(k, job, base[i]);
+            }
+        }
+        for (int i = L - 1; i >= 0; --i)
+        {
+            bool last = (i == L - 1);
+            backwardRow<M>(setup, proc.row(base[i]), m, base[i], last ? -1 : base[i + 1], last ? nullptr : row.data(),
+                           row.data());
+            for (int k = 0; k < m; ++k)
+                tail[(std::size_t)k * stride + i] = row[k];
+        }
+        // Brzegi (pozycja 0 bez poprzednika, pozycja L bez następnika) i dopełnienie torów zerami
+        for (int k = 0; k < m; ++k)
+        {
+            std::size_t rowStart = (std::size_t)k * stride;
+            head[rowStart] = 0;
+            setupIn[rowStart] = 0;
+            for (int pos = L; pos < stride; ++pos)
+            {
+                tail[rowStart + pos] = 0;
+                setupOut[rowStart + pos] = 0;
+                if (pos > L)
+                    head[rowStart + pos] = setupIn[rowStart + pos] = 0;
+            }
+        }
+
+        batch_simd::InsertionLanes lanes;
+        lanes.machines = m;
+        lanes.positions = L + 1;
+        lanes.stride = stride;
+        lanes.head = head.data();
+        lanes.tail = tail.data();
+        lanes.setupIn = setupIn.data();
+        lanes.setupOut = setupOut.data();
+        lanes.proc = proc.row(job);
+        return lanes;
+    }
+
+    static void insertionsScalar(const batch_simd::InsertionLanes &lanes, long long *out)
+    {
+        for (int pos = 0; pos < lanes.positions; ++pos)
+        {
+            std::int32_t front = 0, best = 0;
+            for (int k = 0; k < lanes.machines; ++k)
+            {
+                std::size_t at = (std::size_t)k * lanes.stride + pos;
+                front = std::max(front, lanes.head[at] + lanes.setupIn[at]) + lanes.proc[k];
+                best = std::max(best, front + lanes.setupOut[at] + lanes.tail[at]);
+            }
+            out[pos] = std::max(best, front);
+        }
+    }
+};
@@ -0,0 +1,164 @@
+#include "BatchMakespan.hpp"
+#include <algorithm>
+
+// Jądra SSE4.1/AVX2 kompilowane atrybutem target (bez flag -m dla całego programu);
+// BatchMakespan wywołuje je tylko na procesorach, które je wspierają
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+
+namespace batch_simd
+{
+    bool cpuHasSse41() { return __builtin_cpu_supports("sse4.1"); }
+    bool cpuHasAvx2() { return __builtin_cpu_supports("avx2"); }
+
+    namespace
+    {
+        void storeLanes(const std::int32_t *lanes, int valid, long long *out)
+        {
+            for (int i = 0; i < valid; ++i)
+                out[i] = lanes[i];
+        }
+
+        // Indeksy przezbrojeń toru -> wartości (tablice 8/16-bitowe nie mają gathera o tej szerokości)
+        template <typename T>
+        void fillSetups(const T *setup, const std::int32_t *index, std::int32_t *values, int lanes)
+        {
+            for (int c = 0; c < lanes; ++c)
+                values[c] = setup[index[c]];
+        }
+    }
+
+    __attribute__((target("sse4.1"))) void insertionsSse41(const InsertionLanes &lanes, long long *out)
+    {
+        alignas(16) std::int32_t result[4];
+        for (int first = 0; first < lanes.positions; first += 4)
+        {
+            __m128i front = _mm_setzero_si128();
+            __m128i best = _mm_setzero_si128();
+            for (int k = 0; k < lanes.machines; ++k)
+            {
+                std::size_t at = (std::size_t)k * lanes.stride + first;
+                __m128i head = _mm_loadu_si128((const __m128i *)(lanes.head + at));
+                __m128i in = _mm_loadu_si128((const __m128i *)(lanes.setupIn + at));
+                front = _mm_add_epi32(_mm_max_epi32(front, _mm_add_epi32(head, in)), _mm_set1_epi32(lanes.proc[k]));
+                __m128i out = _mm_loadu_si128((const __m128i *)(lanes.setupOut + at));
+                __m128i tail = _mm_loadu_si128((const __m128i *)(lanes.tail + at));
+                best = _mm_max_epi32(best, _mm_add_epi32(front, _mm_add_epi32(out, tail)));
+            }
+            _mm_store_si128((__m128i *)result, _mm_max_epi32(best, front));
+            storeLanes(result, std::min(4, lanes.positions - first), out + first);
+        }
+    }
+
+    __attribute__((target("avx2"))) void insertionsAvx2(const InsertionLanes &lanes, long long *out)
+    {
+        alignas(32) std::int32_t result[8];
+        for (int first = 0; first < lanes.positions; first += 8)
+        {
+            __m256i front = _mm256_setzero_si256();
+            __m256i best = _mm256_setzero_si256();
+            for (int k = 0; k < lanes.machines; ++k)
+            {
+                std::size_t at = (std::size_t)k * lanes.stride + first;
+                __m256i head = _mm256_loadu_si256((const __m256i *)(lanes.head + at));
+                __m256i in = _mm256_loadu_si256((const __m256i *)(lanes.setupIn + at));
+                front = _mm256_add_epi32(_mm256_max_epi32(front, _mm256_add_epi32(head, in)), _mm256_set1_epi32(lanes.proc[k]));
+                __m256i out = _mm256_loadu_si256((const __m256i *)(lanes.setupOut + at));
+                __m256i tail = _mm256_loadu_si256((const __m256i *)(lanes.tail + at));
+                best = _mm256_max_epi32(best, _mm256_add_epi32(front, _mm256_add_epi32(out, tail)));
+            }
+            _mm256_store_si256((__m256i *)result, _mm256_max_epi32(best, front));
+            storeLanes(result, std::min(8, lanes.positions - first), out + first);
+        }
+    }
+
+    namespace
+    {
+        __attribute__((target("avx2"), always_inline)) inline __m256i gatherSetups(const SequenceLanes &data, __m256i at)
+        {
+            if (data.setupWide)
+                return _mm256_i32gather_epi32(data.setupWide, at, 4);
+            if (data.narrowPadded && data.setupNarrow)
+                return _mm256_and_si256(_mm256_i32gather_epi32((const int *)data.setupNarrow, at, 2), _mm256_set1_epi32(0xFFFF));
+            if (data.narrowPadded)
+                return _mm256_and_si256(_mm256_i32gather_epi32((const int *)data.setupByte, at, 1), _mm256_set1_epi32(0xFF));
+            // Zmapowany plik: bez zapasu za tablicą, odczyt po jednej wartości
+            alignas(32) std::int32_t index[8], values[8];
+            _mm256_store_si256((__m256i *)index, at);
+            if (data.setupNarrow)
+                fillSetups(data.setupNarrow, index, values, 8);
+            else
+                fillSetups(data.setupByte, index, values, 8);
+            return _mm256_load_si256((const __m256i *)values);
+        }
+
+        // M > 0: wiersz zakończeń w rejestrach (pętla po maszynach rozwijana), M = 0: wiersz w scratch
+        template <int M>
+        __attribute__((target("avx2"))) void sequencesAvx2M(const SequenceLanes &data, const int *seqs, int count, int length,
+                                                            std::int32_t *scratch, long long *out)
+        {
+            const int m = (M > 0) ? M : data.machines;
+            const __m256i laneIds = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            __m256i rows[(M > 0) ? M : 1];
+            alignas(32) std::int32_t result[8];
+            for (int first = 0; first < count; first += 8)
+            {
+                int valid = std::min(8, count - first);
+                // Tory ponad count powtarzają ostatniego kandydata
+                __m256i candidate = _mm256_min_epi32(_mm256_add_epi32(_mm256_set1_epi32(first), laneIds), _mm256_set1_epi32(count - 1));
+                __m256i seqOffset = _mm256_mullo_epi32(candidate, _mm256_set1_epi32(length));
+                __m256i prev = _mm256_setzero_si256();
+                __m256i byMachine = _mm256_setzero_si256();
+                for (int i = 0; i < length; ++i)
+                {
+                    __m256i curr = _mm256_i32gather_epi32(seqs, _mm256_add_epi32(seqOffset, _mm256_set1_epi32(i)), 4);
+                    __m256i procIndex = _mm256_mullo_epi32(curr, _mm256_set1_epi32(m));
+                    __m256i setupIndex = _mm256_add_epi32(_mm256_mullo_epi32(prev, _mm256_set1_epi32(data.prevStride)),
+                                                          _mm256_mullo_epi32(curr, _mm256_set1_epi32(data.currStride)));
+                    byMachine = _mm256_setzero_si256();
+                    for (int k = 0; k < m; ++k)
+                    {
+                        __m256i proc = _mm256_i32gather_epi32(data.proc, _mm256_add_epi32(procIndex, _mm256_set1_epi32(k)), 4);
+                        __m256i ready = _mm256_setzero_si256();
+                        if (i > 0)
+                        {
+                            __m256i s = gatherSetups(data, _mm256_add_epi32(setupIndex, _mm256_set1_epi32(k * data.machineStride)));
+                            if constexpr (M > 0)
+                                ready = _mm256_add_epi32(rows[k], s);
+                            else
+                                ready = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(scratch + k * 8)), s);
+                        }
+                        byMachine = _mm256_add_epi32(_mm256_max_epi32(byMachine, ready), proc);
+                        if constexpr (M > 0)
+                            rows[k] = byMachine;
+                        else
+                            _mm256_storeu_si256((__m256i *)(scratch + k * 8), byMachine);
+                    }
+                    prev = curr;
+                }
+                _mm256_store_si256((__m256i *)result, byMachine);
+                storeLanes(result, valid, out + first);
+            }
+        }
+    }
+
+    void sequencesAvx2(const SequenceLanes &data, const int *seqs, int count, int length, std::int32_t *scratch, long long *out)
+    {
+        makespan_kernel::dispatch(data.machines, [&](auto M)
+                                  { sequencesAvx2M<decltype(M)::value>(data, seqs, count, length, scratch, out); });
+    }
+}
+
+#else
+
+// Inne architektury: tylko ścieżka skalarna (detect() nigdy nie wybierze jąder wektorowych)
+namespace batch_simd
+{
+    bool cpuHasSse41() { return false; }
+    bool cpuHasAvx2() { return false; }
+    void insertionsSse41(const InsertionLanes &, long long *) {}
+    void insertionsAvx2(const InsertionLanes &, long long *) {}
+    void sequencesAvx2(const SequenceLanes &, const int *, int, int, std::int32_t *, long long *) {}
+}
+
+#endif
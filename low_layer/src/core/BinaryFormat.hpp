@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+// Binarny format instancji (little-endian), mapowany bez parsowania:
+//   [nagłówek 64 B][proc: int32 [job][machine]][wyrównanie do 64 B][setup: uint8/uint16/int32 w zapisanym układzie]
+struct BinaryInstanceHeader
+{
+    char magic[8];             // "PFSPBIN1"
+    std::uint32_t version;     // 1
+    std::uint32_t jobs;
+    std::uint32_t machines;
+    std::uint32_t setupWidth;  // 1 (uint8), 2 (uint16) albo 4 (int32)
+    std::uint32_t setupLayout; // 0 = machine-major, 1 = prev-job-major
+    std::uint32_t reserved;
+    std::uint64_t procOffset;
+    std::uint64_t setupOffset;
+    std::uint64_t setupBytes;
+    std::uint64_t reservedTail;
+};
+static_assert(sizeof(BinaryInstanceHeader) == 64, "binary header must stay 64 bytes");
+
+namespace binary_format
+{
+    constexpr char Magic[8] = {'P', 'F', 'S', 'P', 'B', 'I', 'N', '1'};
+    constexpr std::uint32_t Version = 1;
+    constexpr std::uint64_t Alignment = 64;
+
+    inline bool hasMagic(const char *data, std::size_t size)
+    {
+        return size >= sizeof(Magic) && std::memcmp(data, Magic, sizeof(Magic)) == 0;
+    }
+
+    inline std::uint64_t alignUp(std::uint64_t offset)
+    {
+        return (offset + Alignment - 1) / Alignment * Alignment;
+    }
+
+    inline bool hostIsLittleEndian()
+    {
+        const std::uint16_t probe = 1;
+        return *reinterpret_cast<const unsigned char *>(&probe) == 1;
+    }
+}
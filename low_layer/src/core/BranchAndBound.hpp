@@ -0,0 +1,310 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <climits>
+#include "Instance.hpp"
+#include "Schedule.hpp"
+#include "LowerBound.hpp"
+#include "MakespanKernel.hpp"
+#include "NEHWithProgress.hpp"
+#include "WorkStealingPool.hpp"
+#include "Telemetry.hpp"
+#include "SolveBudget.hpp"
+
+// Dokładny branch-and-bound (w głąb) dla małych instancji. Węzeł to prefiks sekwencji;
+// potomkowie (kolejne zadanie) przeglądani są rosnąco po dolnym ograniczeniu (LowerBound),
+// gałąź odcinana, gdy ograniczenie >= najlepszego znanego makespanu.
+// Płytkie poziomy (do splitDepth) zlecane są jako osobne zadania WorkStealingPool, głębsze
+// poddrzewa wątek przegląda sam. Makespan rozwiązania bieżącego jest atomowy (odczyt przy
+// każdym odcięciu bez blokady), sekwencja zapisywana pod mutexem tylko przy poprawie.
+// Optymalny makespan nie zależy od liczby wątków; przy kilku optimach zwracane jest dowolne z nich.
+class BranchAndBound
+{
+public:
+    struct Stats
+    {
+        long long nodes = 0;      // odwiedzone węzły
+        long long rootBound = 0;  // dolne ograniczenie całej instancji
+        long long initial = 0;    // makespan rozwiązania startowego
+        bool proven = false;      // przeszukanie zakończone - wynik optymalny
+        double seconds = 0.0;
+    };
+
+private:
+    const Instance &instance;
+    LowerBound lowerBound;
+    int threads;
+    long long nodeLimit = 0; // 0 = bez limitu
+    int splitDepth = 0;
+    bool verbose = true;
+    SolveBudget budget;
+
+    std::atomic<long long> incumbent{LLONG_MAX};
+    std::atomic<long long> visited{0};
+    std::atomic<long long> nextCheck{0};
+    std::atomic<bool> aborted{false};
+    std::mutex bestMtx;
+    std::vector<int> bestSeq;
+    std::string stopReason;
+    Stats stats;
+
+public:
+    BranchAndBound(const Instance &inst, int threadCount = 1)
+        : instance(inst), lowerBound(inst), threads(std::max(1, threadCount)) {}
+
+    // Przerwanie po tylu węzłach (wynik bez dowodu optymalności)
+    void setNodeLimit(long long limit) { nodeLimit = std::max(0LL, limit); }
+
+    // false = brak linii RESULT/SLOT i logów
+    void setVerbose(bool enabled) { verbose = enabled; }
+
+    // Limit czasu i przerwanie kończą przeszukiwanie z najlepszym znalezionym rozwiązaniem
+    void setBudget(const SolveBudget &solveBudget) { budget = solveBudget; }
+
+    const Stats &getStats() const { return stats; }
+    const std::string &getStopReason() const { return stopReason; }
+
+    // initialSolution to górne ograniczenie startowe (np. z NEH/SA); pusta = NEH
+    Schedule solve(const Schedule &initialSolution = Schedule())
+    {
+        const std::string prefix = "BRANCH_AND_BOUND";
+        auto start = std::chrono::steady_clock::now();
+        int n = instance.getJobs();
+
+        std::vector<int> initial = initialSolution.getJobSequence();
+        if ((int)initial.size() != n)
+        {
+            NEHWithProgress neh(instance);
+            neh.setVerbose(false);
+            initial = neh.solve().getJobSequence();
+        }
+
+        stats = Stats();
+        stats.initial = instance.makespanOf(initial);
+        stats.rootBound = lowerBound.compute();
+        bestSeq = initial;
+        incumbent.store(stats.initial);
+        visited.store(0);
+        nextCheck.store(0);
+        aborted.store(false);
+        stopReason.clear();
+        splitDepth = chooseSplitDepth(n);
+
+        if (verbose)
+            LogLine() << prefix << " started. Initial makespan: " << stats.initial << ", lower bound: " << stats.rootBound
+                      << " (threads=" << threads << ", split depth=" << splitDepth << ")";
+
+        if (stats.initial > stats.rootBound && n > 1)
+        {
+            if (threads == 1)
+                explore({}, nullptr);
+            else
+            {
+                WorkStealingPool pool(threads);
+                pool.submit([this, &pool]
+                            { explore({}, &pool); });
+                pool.wait();
+            }
+        }
+
+        stats.nodes = visited.load();
+        stats.proven = !aborted.load();
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        long long best = incumbent.load();
+
+        if (verbose)
+        {
+            if (!stats.proven)
+                LogLine() << prefix << " stopped (" << stopReason << ") after " << stats.nodes << " nodes";
+            LogLine() << prefix << " nodes: " << stats.nodes << " in " << (long long)(stats.seconds * 1000) << " ms, "
+                      << (stats.proven ? "optimal" : "not proven") << ", gap to root lower bound: " << gapPercent(best) << "%";
+            LogLine() << prefix << " finished. Final best makespan: " << best;
+            Schedule(bestSeq).emitFinalSlots(instance);
+        }
+        return Schedule(bestSeq);
+    }
+
+    // Względna luka [%] między makespanem a ograniczeniem całej instancji
+    double gapPercent(long long makespan) const
+    {
+        return stats.rootBound > 0 ? 100.0 * (double)(makespan - stats.rootBound) / (double)stats.rootBound : 0.0;
+    }
+
+private:
+    // Tyle poziomów rozdzielanych na zadania, żeby każdy wątek miał kilkadziesiąt poddrzew do kradzieży
+    int chooseSplitDepth(int n) const
+    {
+        if (threads == 1)
+            return 0;
+        long long subtrees = 1;
+        int depth = 0;
+        while (depth < n - 2 && subtrees < (long long)threads * 32)
+            subtrees *= (n - depth++);
+        return depth;
+    }
+
+    // Zadanie: poddrzewo o zadanym prefiksie; wiersz zakończeń liczony od nowa (O(długość * m))
+    void explore(std::vector<int> prefix, WorkStealingPool *pool)
+    {
+        instance.visitKernel([&](const auto &setup, auto M)
+                             { exploreWith<decltype(M)::value>(setup, prefix, pool); });
+    }
+
+    template <int M, typename SetupAccess>
+    void exploreWith(const SetupAccess &setup, std::vector<int> &prefix, WorkStealingPool *pool)
+    {
+        using namespace makespan_kernel;
+        const ProcMatrix &proc = instance.getProcMatrix();
+        int n = instance.getJobs();
+        int m = instance.getMachines();
+
+        // Stos wierszy: rows[d] = zakończenia d-tego zadania prefiksu
+        std::vector<long long> rows((std::size_t)(n + 1) * m, 0);
+        std::vector<char> used(n, 0);
+        for (int d = 0; d < (int)prefix.size(); ++d)
+        {
+            forwardRow<M>(setup, proc.row(prefix[d]), m, (d > 0) ? prefix[d - 1] : -1, prefix[d],
+                          (d > 0) ? rows.data() + (std::size_t)(d - 1) * m : nullptr, rows.data() + (std::size_t)d * m);
+            used[prefix[d]] = 1;
+        }
+        std::vector<int> seq(prefix);
+        seq.resize(n);
+        // children[d]: kandydaci (ograniczenie, zadanie) na pozycji d
+        std::vector<std::vector<std::pair<long long, int>>> children(n);
+        std::vector<int> unscheduled(n);
+        descend<M>(setup, seq, (int)prefix.size(), rows, used, children, unscheduled, pool);
+    }
+
+    template <int M, typename SetupAccess>
+    void descend(const SetupAccess &setup, std::vector<int> &seq, int depth, std::vector<long long> &rows,
+                 std::vector<char> &used, std::vector<std::vector<std::pair<long long, int>>> &children,
+                 std::vector<int> &unscheduled, WorkStealingPool *pool)
+    {
+        using namespace makespan_kernel;
+        const ProcMatrix &proc = instance.getProcMatrix();
+        int n = instance.getJobs();
+        int m = instance.getMachines();
+
+        // Rozwiązanie równe ograniczeniu instancji jest optymalne
+        if (shouldAbort() || incumbent.load(std::memory_order_relaxed) <= stats.rootBound)
+            return;
+
+        const long long *prevRow = (depth > 0) ? rows.data() + (std::size_t)(depth - 1) * m : nullptr;
+        long long *row = rows.data() + (std::size_t)depth * m;
+        int last = (depth > 0) ? seq[depth - 1] : -1;
+
+        // Pełna sekwencja po dołożeniu ostatniego zadania
+        if (depth == n - 1)
+        {
+            for (int j = 0; j < n; ++j)
+                if (!used[j])
+                {
+                    seq[depth] = j;
+                    forwardRow<M>(setup, proc.row(j), m, last, j, prevRow, row);
+                    visited.fetch_add(1, std::memory_order_relaxed);
+                    offer(seq, row[m - 1]);
+                }
+            return;
+        }
+
+        // Ograniczenia potomków
+        auto &candidates = children[depth];
+        candidates.clear();
+        for (int j = 0; j < n; ++j)
+        {
+            if (used[j])
+                continue;
+            forwardRow<M>(setup, proc.row(j), m, last, j, prevRow, row);
+            int count = 0;
+            for (int u = 0; u < n; ++u)
+                if (!used[u] && u != j)
+                    unscheduled[count++] = u;
+            long long bound = lowerBound.partial(setup, row, j, unscheduled.data(), count);
+            visited.fetch_add(1, std::memory_order_relaxed);
+            if (bound < incumbent.load(std::memory_order_relaxed))
+                candidates.push_back({bound, j});
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        // Płytkie poziomy jako osobne zadania: zlecane od najgorszego, żeby własny wątek (LIFO)
+        // zaczął od najbardziej obiecującego, a złodzieje zabierali pozostałe
+        if (pool && depth < splitDepth)
+        {
+            for (auto it = candidates.rbegin(); it != candidates.rend(); ++it)
+            {
+                std::vector<int> childPrefix(seq.begin(), seq.begin() + depth);
+                childPrefix.push_back(it->second);
+                long long bound = it->first;
+                pool->submit([this, pool, bound, childPrefix]() mutable
+                             {
+                                 if (bound < incumbent.load(std::memory_order_relaxed))
+                                     explore(std::move(childPrefix), pool); });
+            }
+            return;
+        }
+
+        for (std::size_t c = 0; c < candidates.size(); ++c)
+        {
+            auto [bound, j] = candidates[c];
+            if (bound >= incumbent.load(std::memory_order_relaxed))
+                break; // posortowane - dalsze też odcięte
+            seq[depth] = j;
+            used[j] = 1;
+            forwardRow<M>(setup, proc.row(j), m, last, j, prevRow, row);
+            descend<M>(setup, seq, depth + 1, rows, used, children, unscheduled, pool);
+            used[j] = 0;
+        }
+    }
+
+    // Nowe rozwiązanie bieżące: makespan przez CAS (bez blokady), sekwencja pod mutexem
+    void offer(const std::vector<int> &seq, long long makespan)
+    {
+        long long seen = incumbent.load(std::memory_order_relaxed);
+        while (makespan < seen)
+        {
+            if (incumbent.compare_exchange_weak(seen, makespan, std::memory_order_relaxed))
+            {
+                std::lock_guard<std::mutex> lock(bestMtx);
+                // Inny wątek mógł w międzyczasie zapisać lepsze
+                if (makespan <= incumbent.load(std::memory_order_relaxed))
+                {
+                    bestSeq = seq;
+                    if (verbose)
+                        Telemetry::get().result((int)visited.load(std::memory_order_relaxed), (double)makespan, bestSeq);
+                }
+                return;
+            }
+        }
+    }
+
+    bool shouldAbort()
+    {
+        if (aborted.load(std::memory_order_relaxed))
+            return true;
+        // Limit węzłów przy każdym węźle, zegar co ~1024 węzły
+        long long count = visited.load(std::memory_order_relaxed);
+        const char *reason = nullptr;
+        if (nodeLimit > 0 && count >= nodeLimit)
+            reason = "node limit";
+        else
+        {
+            long long due = nextCheck.load(std::memory_order_relaxed);
+            if (count < due || !nextCheck.compare_exchange_strong(due, count + 1024, std::memory_order_relaxed))
+                return false;
+            if (Cancellation::requested())
+                reason = "cancelled";
+            else if (budget.timeUp())
+                reason = "time limit";
+        }
+        if (!reason)
+            return false;
+        std::lock_guard<std::mutex> lock(bestMtx);
+        if (!aborted.exchange(true))
+            stopReason = reason;
+        return true;
+    }
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+
+// xoshiro256** (Blackman, Vigna): 4 słowa stanu, kilka operacji na liczbę - zamiast std::mt19937
+// w pętli SA. Spełnia wymagania UniformRandomBitGenerator (std::shuffle itp.).
+// Stan z ziarna przez splitmix64, więc sąsiednie ziarna dają niezależne strumienie.
+class Xoshiro256
+{
+private:
+    std::uint64_t s[4];
+
+    static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    using result_type = std::uint64_t;
+
+    explicit Xoshiro256(std::uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(std::uint64_t seed)
+    {
+        for (auto &word : s)
+        {
+            std::uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()()
+    {
+        std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+        std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Liczba z [0, bound) mnożeniem (Lemire) - bez dzielenia; obciążenie rzędu bound / 2^32
+    std::uint32_t below(std::uint32_t bound) { return (std::uint32_t)(((operator()() >> 32) * bound) >> 32); }
+
+    // Liczba z [0, 1) z 53 bitów
+    double unit() { return (double)(operator()() >> 11) * (1.0 / 9007199254740992.0); }
+};
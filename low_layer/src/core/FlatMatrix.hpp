@@ -0,0 +1,527 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <sys/mman.h>
+
+// Ciągły bufor wyrównany do linii cache (zamiast zagnieżdżonych vectorów).
+// Duże bufory mogą być mapowane anonimowo z prośbą o duże strony (MADV_HUGEPAGE) - mniej
+// chybień TLB przy losowym dostępie do wielogigabajtowej macierzy przezbrojeń.
+template <typename T>
+class AlignedArray
+{
+private:
+    static constexpr std::size_t Alignment = 64;
+    // Zapas za ostatnim elementem: 32-bitowy odczyt (gather) ostatniej wartości 16-bitowej
+    static constexpr std::size_t Slack = sizeof(std::uint32_t);
+    static constexpr std::size_t HugePage = std::size_t(2) << 20;
+
+    T *ptr = nullptr;
+    std::size_t count = 0;
+    std::size_t mappedBytes = 0; // > 0 = pamięć z mmap (zwalniana munmap)
+
+public:
+    AlignedArray() = default;
+    explicit AlignedArray(std::size_t n, T fill = T()) { assign(n, fill); }
+    ~AlignedArray() { release(); }
+
+    AlignedArray(const AlignedArray &other) { *this = other; }
+    AlignedArray &operator=(const AlignedArray &other)
+    {
+        if (this != &other)
+        {
+            allocate(other.count, other.mappedBytes > 0);
+            if (count)
+                std::memcpy(ptr, other.ptr, count * sizeof(T));
+        }
+        return *this;
+    }
+    AlignedArray(AlignedArray &&other) noexcept { swap(other); }
+    AlignedArray &operator=(AlignedArray &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            swap(other);
+        }
+        return *this;
+    }
+
+    // hugePages: bufory od 2 MiB mapowane z MADV_HUGEPAGE (zerowane przez system)
+    void assign(std::size_t n, T fill = T(), bool hugePages = false)
+    {
+        allocate(n, hugePages);
+        const T zero{};
+        if (mappedBytes && std::memcmp(&fill, &zero, sizeof(T)) == 0)
+            return;
+        for (std::size_t i = 0; i < n; ++i)
+            ptr[i] = fill;
+    }
+
+    T *data() { return ptr; }
+    const T *data() const { return ptr; }
+    std::size_t size() const { return count; }
+    std::size_t bytes() const { return count * sizeof(T); }
+    bool mapped() const { return mappedBytes > 0; }
+
+    T &operator[](std::size_t i) { return ptr[i]; }
+    const T &operator[](std::size_t i) const { return ptr[i]; }
+
+private:
+    void swap(AlignedArray &other) noexcept
+    {
+        std::swap(ptr, other.ptr);
+        std::swap(count, other.count);
+        std::swap(mappedBytes, other.mappedBytes);
+    }
+
+    void release()
+    {
+        if (mappedBytes)
+            ::munmap(ptr, mappedBytes);
+        else
+            std::free(ptr);
+        ptr = nullptr;
+        count = 0;
+        mappedBytes = 0;
+    }
+
+    void allocate(std::size_t n, bool hugePages)
+    {
+        release();
+        count = n;
+        if (n == 0)
+            return;
+        std::size_t needed = n * sizeof(T) + Slack;
+        if (hugePages && needed >= HugePage)
+        {
+            std::size_t size = (needed + HugePage - 1) / HugePage * HugePage;
+            void *raw = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw != MAP_FAILED)
+            {
+#ifdef MADV_HUGEPAGE
+                ::madvise(raw, size, MADV_HUGEPAGE); // tylko wskazówka - bez THP zostają zwykłe strony
+#endif
+                ptr = static_cast<T *>(raw);
+                mappedBytes = size;
+                return;
+            }
+        }
+        // aligned_alloc wymaga rozmiaru będącego wielokrotnością wyrównania
+        std::size_t size = (needed + Alignment - 1) / Alignment * Alignment;
+        T *raw = static_cast<T *>(std::aligned_alloc(Alignment, size));
+        if (!raw)
+        {
+            count = 0;
+            throw std::bad_alloc();
+        }
+        ptr = raw;
+    }
+};
+
+// Czasy operacji: wiersz na zadanie, kolejne maszyny obok siebie
+class ProcMatrix
+{
+private:
+    int jobs = 0;
+    int machines = 0;
+    AlignedArray<std::int32_t> values;
+
+public:
+    void assign(int n, int m)
+    {
+        jobs = n;
+        machines = m;
+        values.assign((std::size_t)n * m, 0);
+    }
+
+    int operator()(int job, int machine) const { return values[(std::size_t)job * machines + machine]; }
+    std::int32_t &at(int job, int machine) { return values[(std::size_t)job * machines + machine]; }
+    const std::int32_t *row(int job) const { return values.data() + (std::size_t)job * machines; }
+    std::size_t bytes() const { return values.bytes(); }
+};
+
+enum class SetupLayout
+{
+    MachineMajor, // [machine][prev][curr] - jak w pliku wejściowym
+    PrevJobMajor  // [prev][curr][machine] - wszystkie maszyny dla pary zadań obok siebie
+};
+
+// Sposób przechowywania przezbrojeń
+enum class SetupEncoding
+{
+    Narrowest, // najwęższy typ całkowity mieszczący wszystkie wartości (uint8 / uint16 / int32)
+    Wide,      // zawsze int32
+    Packed     // wiersze [machine][prev] względem minimum wiersza, upakowane bitowo
+};
+
+// Niesprawdzany dostęp do macierzy przezbrojeń o konkretnym typie i układzie
+template <typename T, SetupLayout L>
+struct SetupView
+{
+    const T *base;
+    int jobs;
+    int machines;
+
+    int operator()(int machine, int prevJob, int currJob) const
+    {
+        if constexpr (L == SetupLayout::MachineMajor)
+            return base[((std::size_t)machine * jobs + prevJob) * jobs + currJob];
+        else
+            return base[((std::size_t)prevJob * jobs + currJob) * machines + machine];
+    }
+};
+
+// Wiersz upakowanej macierzy: wartości (v - base) po bits bitów od bitu offset
+struct PackedSetupRow
+{
+    std::uint64_t offset;
+    std::int32_t base;
+    std::uint32_t bits;
+};
+
+// Odczyt upakowanego wiersza: jedno 64-bitowe pobranie (bits <= 32, przesunięcie < 8),
+// bajty little-endian jak w formacie binarnym
+struct PackedSetupView
+{
+    const std::uint8_t *bytes;
+    const PackedSetupRow *rows;
+    int jobs;
+
+    int operator()(int machine, int prevJob, int currJob) const
+    {
+        const PackedSetupRow &row = rows[(std::size_t)machine * jobs + prevJob];
+        std::uint64_t pos = row.offset + (std::uint64_t)currJob * row.bits;
+        std::uint64_t word;
+        std::memcpy(&word, bytes + (pos >> 3), sizeof(word));
+        std::uint64_t mask = (row.bits == 32) ? 0xFFFFFFFFull : ((1ull << row.bits) - 1);
+        return row.base + (int)((word >> (pos & 7)) & mask);
+    }
+};
+
+// Macierz przezbrojeń m x n x n. Budowana wiersz po wierszu w kolejności pliku (begin, setRow,
+// finish), więc parser nie potrzebuje pełnej kopii int32: przy Narrowest bufor startuje jako
+// uint8 i jest poszerzany dopiero, gdy wiersz się nie mieści; przy Packed wiersze muszą
+// przychodzić po kolei. Solvery czytają przez visit() - widok dobrany raz do typu i układu.
+class SetupMatrix
+{
+public:
+    enum class Width
+    {
+        Narrow8,
+        Narrow16,
+        Wide32,
+        Packed
+    };
+
+private:
+    int jobs = 0;
+    int machines = 0;
+    SetupLayout layout = SetupLayout::PrevJobMajor;
+    Width width = Width::Wide32;
+    bool hugePages = false;
+    AlignedArray<std::uint8_t> narrow8;
+    AlignedArray<std::uint16_t> narrow;
+    AlignedArray<std::int32_t> wide;
+    AlignedArray<std::uint8_t> packed;
+    AlignedArray<PackedSetupRow> packedRows;
+    // Budowa upakowanej macierzy: słowa bitowe i następny oczekiwany wiersz
+    std::vector<std::uint64_t> packing;
+    std::uint64_t packedBits = 0;
+    std::size_t nextPackedRow = 0;
+    // Dane spoza obiektu (np. zmapowany plik binarny); owner utrzymuje je przy życiu
+    const void *external = nullptr;
+    std::size_t externalBytes = 0;
+    std::shared_ptr<const void> owner;
+
+public:
+    // Pusta (wyzerowana) macierz; layout nie dotyczy Packed (zawsze wiersze [machine][prev])
+    void begin(int n, int m, SetupLayout targetLayout, SetupEncoding encoding, bool useHugePages = false)
+    {
+        jobs = n;
+        machines = m;
+        layout = (encoding == SetupEncoding::Packed) ? SetupLayout::MachineMajor : targetLayout;
+        hugePages = useHugePages;
+        releaseAll();
+        std::size_t cells = (std::size_t)m * n * n;
+        if (encoding == SetupEncoding::Packed)
+        {
+            width = Width::Packed;
+            packedRows.assign((std::size_t)m * n, PackedSetupRow{0, 0, 0});
+            packing.clear();
+        }
+        else if (encoding == SetupEncoding::Wide)
+        {
+            width = Width::Wide32;
+            wide.assign(cells, 0, hugePages);
+        }
+        else
+        {
+            width = Width::Narrow8;
+            narrow8.assign(cells, 0, hugePages);
+        }
+    }
+
+    // Wiersz pliku: s_machine(prev, 0..n-1)
+    void setRow(int machine, int prev, const int *values)
+    {
+        if (width == Width::Packed)
+        {
+            packRow(machine, prev, values);
+            return;
+        }
+        int lo = 0, hi = 0;
+        for (int c = 0; c < jobs; ++c)
+        {
+            lo = std::min(lo, values[c]);
+            hi = std::max(hi, values[c]);
+        }
+        if (lo < 0 || hi > std::numeric_limits<std::uint16_t>::max())
+            widen(Width::Wide32);
+        else if (hi > std::numeric_limits<std::uint8_t>::max())
+            widen(Width::Narrow16);
+
+        if (width == Width::Narrow8)
+            storeRow(narrow8, machine, prev, values);
+        else if (width == Width::Narrow16)
+            storeRow(narrow, machine, prev, values);
+        else
+            storeRow(wide, machine, prev, values);
+    }
+
+    // Kończy budowę (brakujące wiersze zostają zerami)
+    void finish()
+    {
+        if (width != Width::Packed)
+            return;
+        // Zapas 8 bajtów na 64-bitowy odczyt ostatniej wartości
+        std::size_t used = (std::size_t)((packedBits + 7) / 8);
+        packed.assign(used + sizeof(std::uint64_t), 0, hugePages);
+        for (std::size_t i = 0; i < used; ++i)
+            packed[i] = (std::uint8_t)(packing[i / 8] >> (8 * (i % 8)));
+        std::vector<std::uint64_t>().swap(packing);
+        // Pominięte wiersze: zera (0 bitów) za ostatnim zapisanym
+        for (; nextPackedRow < packedRows.size(); ++nextPackedRow)
+            packedRows[nextPackedRow] = PackedSetupRow{packedBits, 0, 0};
+    }
+
+    // Wejście w kolejności z pliku: [machine][prev][curr]
+    void build(int n, int m, const std::vector<int> &machineMajor, SetupLayout targetLayout, SetupEncoding encoding,
+               bool useHugePages = false)
+    {
+        begin(n, m, targetLayout, encoding, useHugePages);
+        for (int mach = 0; mach < m; ++mach)
+            for (int prev = 0; prev < n; ++prev)
+                setRow(mach, prev, machineMajor.data() + ((std::size_t)mach * n + prev) * n);
+        finish();
+    }
+
+    // Używa gotowej macierzy w podanym typie i układzie bez kopiowania
+    void adopt(int n, int m, SetupLayout sourceLayout, Width sourceWidth, const void *data, std::size_t size,
+               std::shared_ptr<const void> keepAlive)
+    {
+        jobs = n;
+        machines = m;
+        layout = sourceLayout;
+        width = sourceWidth;
+        releaseAll();
+        external = data;
+        externalBytes = size;
+        owner = std::move(keepAlive);
+    }
+
+    int getJobs() const { return jobs; }
+    int getMachines() const { return machines; }
+    SetupLayout getLayout() const { return layout; }
+    Width getWidth() const { return width; }
+    std::size_t bytes() const
+    {
+        return narrow8.bytes() + narrow.bytes() + wide.bytes() + packed.bytes() + packedRows.bytes() + externalBytes;
+    }
+    bool isExternal() const { return external != nullptr; }
+    bool usesHugePages() const { return narrow8.mapped() || narrow.mapped() || wide.mapped() || packed.mapped(); }
+
+    // Rozmiar elementu w bajtach; 0 dla Packed
+    std::size_t elementBytes() const
+    {
+        switch (width)
+        {
+        case Width::Narrow8:
+            return 1;
+        case Width::Narrow16:
+            return 2;
+        case Width::Wide32:
+            return 4;
+        default:
+            return 0;
+        }
+    }
+
+    static const char *widthName(Width w)
+    {
+        switch (w)
+        {
+        case Width::Narrow8:
+            return "uint8";
+        case Width::Narrow16:
+            return "uint16";
+        case Width::Wide32:
+            return "int32";
+        default:
+            return "packed";
+        }
+    }
+
+    // Surowe dane w aktualnym typie i układzie (zapis formatu binarnego); nullptr dla Packed
+    const void *rawData() const
+    {
+        if (external)
+            return external;
+        switch (width)
+        {
+        case Width::Narrow8:
+            return narrow8.data();
+        case Width::Narrow16:
+            return narrow.data();
+        case Width::Wide32:
+            return wide.data();
+        default:
+            return nullptr;
+        }
+    }
+
+    // Wywołuje f z widokiem odpowiadającym aktualnemu typowi i układowi.
+    // Rozgałęzienie następuje raz na wywołanie, a nie na każdy odczyt.
+    template <typename F>
+    decltype(auto) visit(F &&f) const
+    {
+        switch (width)
+        {
+        case Width::Narrow8:
+            if (layout == SetupLayout::MachineMajor)
+                return f(SetupView<std::uint8_t, SetupLayout::MachineMajor>{data<std::uint8_t>(), jobs, machines});
+            return f(SetupView<std::uint8_t, SetupLayout::PrevJobMajor>{data<std::uint8_t>(), jobs, machines});
+        case Width::Narrow16:
+            if (layout == SetupLayout::MachineMajor)
+                return f(SetupView<std::uint16_t, SetupLayout::MachineMajor>{data<std::uint16_t>(), jobs, machines});
+            return f(SetupView<std::uint16_t, SetupLayout::PrevJobMajor>{data<std::uint16_t>(), jobs, machines});
+        case Width::Packed:
+            return f(PackedSetupView{packed.data(), packedRows.data(), jobs});
+        default:
+            if (layout == SetupLayout::MachineMajor)
+                return f(SetupView<std::int32_t, SetupLayout::MachineMajor>{data<std::int32_t>(), jobs, machines});
+            return f(SetupView<std::int32_t, SetupLayout::PrevJobMajor>{data<std::int32_t>(), jobs, machines});
+        }
+    }
+
+    int operator()(int machine, int prevJob, int currJob) const
+    {
+        return visit([&](const auto &view) { return view(machine, prevJob, currJob); });
+    }
+
+private:
+    template <typename T>
+    const T *data() const
+    {
+        if (external)
+            return static_cast<const T *>(external);
+        if constexpr (sizeof(T) == sizeof(std::uint8_t))
+            return narrow8.data();
+        else if constexpr (sizeof(T) == sizeof(std::uint16_t))
+            return narrow.data();
+        else
+            return wide.data();
+    }
+
+    void releaseAll()
+    {
+        narrow8 = AlignedArray<std::uint8_t>();
+        narrow = AlignedArray<std::uint16_t>();
+        wide = AlignedArray<std::int32_t>();
+        packed = AlignedArray<std::uint8_t>();
+        packedRows = AlignedArray<PackedSetupRow>();
+        std::vector<std::uint64_t>().swap(packing);
+        packedBits = 0;
+        nextPackedRow = 0;
+        external = nullptr;
+        externalBytes = 0;
+        owner.reset();
+    }
+
+    std::size_t index(int machine, int prev, int curr) const
+    {
+        return (layout == SetupLayout::MachineMajor) ? ((std::size_t)machine * jobs + prev) * jobs + curr
+                                                     : ((std::size_t)prev * jobs + curr) * machines + machine;
+    }
+
+    template <typename T>
+    void storeRow(AlignedArray<T> &dst, int machine, int prev, const int *values)
+    {
+        for (int curr = 0; curr < jobs; ++curr)
+            dst[index(machine, prev, curr)] = (T)values[curr];
+    }
+
+    // Przepisanie dotychczasowych wierszy do szerszego typu (co najwyżej dwa razy na budowę)
+    void widen(Width target)
+    {
+        if (width == target || width == Width::Wide32)
+            return;
+        std::size_t cells = (std::size_t)machines * jobs * jobs;
+        if (target == Width::Narrow16)
+        {
+            narrow.assign(cells, 0, hugePages);
+            for (std::size_t i = 0; i < cells; ++i)
+                narrow[i] = narrow8[i];
+        }
+        else
+        {
+            wide.assign(cells, 0, hugePages);
+            for (std::size_t i = 0; i < cells; ++i)
+                wide[i] = (width == Width::Narrow8) ? narrow8[i] : narrow[i];
+            narrow = AlignedArray<std::uint16_t>();
+        }
+        narrow8 = AlignedArray<std::uint8_t>();
+        width = target;
+    }
+
+    void packRow(int machine, int prev, const int *values)
+    {
+        std::size_t row = (std::size_t)machine * jobs + prev;
+        if (row < nextPackedRow)
+            throw std::logic_error("packed setup rows must be added in file order");
+        for (; nextPackedRow < row; ++nextPackedRow)
+            packedRows[nextPackedRow] = PackedSetupRow{packedBits, 0, 0};
+
+        long long lo = values[0], hi = values[0];
+        for (int c = 1; c < jobs; ++c)
+        {
+            lo = std::min<long long>(lo, values[c]);
+            hi = std::max<long long>(hi, values[c]);
+        }
+        std::uint32_t bits = 0;
+        while (bits < 32 && ((unsigned long long)(hi - lo) >> bits) != 0)
+            ++bits;
+
+        packedRows[row] = PackedSetupRow{packedBits, (std::int32_t)lo, bits};
+        packing.resize((std::size_t)((packedBits + (std::uint64_t)bits * jobs + 63) / 64) + 1, 0);
+        for (int c = 0; c < jobs && bits > 0; ++c)
+        {
+            std::uint64_t v = (std::uint64_t)((long long)values[c] - lo);
+            std::uint64_t word = packedBits >> 6;
+            unsigned shift = (unsigned)(packedBits & 63);
+            packing[word] |= v << shift;
+            if (shift + bits > 64)
+                packing[word + 1] |= v >> (64 - shift);
+            packedBits += bits;
+        }
+        nextPackedRow = row + 1;
+    }
+};
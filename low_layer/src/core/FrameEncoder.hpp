@@ -0,0 +1,119 @@
+#pragma once
+#include <ostream>
+#include <vector>
+
+// Pojedyncza operacja na wykresie Gantta
+struct SlotRecord
+{
+    int machine;
+    int job;
+    long long start;
+    long long end;
+    int setup;
+
+    bool operator==(const SlotRecord &o) const
+    {
+        return machine == o.machine && job == o.job && start == o.start && end == o.end && setup == o.setup;
+    }
+    bool operator!=(const SlotRecord &o) const { return !(*this == o); }
+};
+
+// Koder ramek harmonogramu dla GUI. Sloty przychodzą w kolejności [maszyna][pozycja].
+// Pamięta ostatnią wysłaną ramkę i wysyła tylko zmienione sloty (pozycja = miejsce na maszynie),
+// a co keyframeInterval ramek (oraz dla ramek końcowych) pełną ramkę kluczową. Gdy zmieniła się
+// ponad połowa slotów (np. przesunięcie początku sekwencji), pełna ramka jest krótsza niż różnicowa.
+// keyframeInterval = 0: każda ramka pełna (dotychczasowy format SLOT;/FRAME_END;).
+//
+// Tekst:  pełna  - SLOT;iter=0;machine=..;job=..;start=..;end=..;setup=..  ...  FRAME_END;iter=0
+//         zmiany - SLOT_DELTA;machine=..;pos=..;job=..;start=..;end=..;setup=..  ...  FRAME_END;iter=0;delta=1
+// JSON:   {"type":"frame","final":..,"key":true,"slots":[[m,j,s,e,setup],...]}
+//         {"type":"frame","final":..,"key":false,"changes":[[m,pos,j,s,e,setup],...]}
+class FrameEncoder
+{
+private:
+    int keyframeInterval = 0;
+    int sinceKey = 0;
+    std::vector<SlotRecord> last;
+
+public:
+    void setKeyframeInterval(int frames)
+    {
+        keyframeInterval = frames > 0 ? frames : 0;
+        reset();
+    }
+
+    // Następna ramka będzie pełna
+    void reset()
+    {
+        last.clear();
+        sinceKey = 0;
+    }
+
+    void encode(const std::vector<SlotRecord> &slots, bool final, bool json, std::ostream &out)
+    {
+        bool key = keyframeInterval == 0 || final || last.size() != slots.size() || ++sinceKey >= keyframeInterval ||
+                   changedCount(slots) * 2 > slots.size();
+        if (key)
+            writeKey(slots, final, json, out);
+        else
+            writeDelta(slots, final, json, out);
+
+        if (keyframeInterval == 0)
+            return;
+        if (key)
+            sinceKey = 0;
+        last = slots;
+    }
+
+private:
+    size_t changedCount(const std::vector<SlotRecord> &slots) const
+    {
+        size_t changed = 0;
+        for (size_t i = 0; i < slots.size(); ++i)
+            changed += slots[i] != last[i];
+        return changed;
+    }
+
+    void writeKey(const std::vector<SlotRecord> &slots, bool final, bool json, std::ostream &out) const
+    {
+        if (!json)
+        {
+            for (const auto &s : slots)
+                out << "SLOT;iter=0;machine=" << s.machine << ";job=" << s.job << ";start=" << s.start
+                    << ";end=" << s.end << ";setup=" << s.setup << "\n";
+            out << "FRAME_END;iter=0\n";
+            return;
+        }
+        out << "{\"type\":\"frame\",\"final\":" << (final ? "true" : "false") << ",\"key\":true,\"slots\":[";
+        for (size_t i = 0; i < slots.size(); ++i)
+        {
+            const auto &s = slots[i];
+            out << (i ? "," : "") << "[" << s.machine << "," << s.job << "," << s.start << "," << s.end << "," << s.setup << "]";
+        }
+        out << "]}\n";
+    }
+
+    void writeDelta(const std::vector<SlotRecord> &slots, bool final, bool json, std::ostream &out) const
+    {
+        // Ta sama liczba slotów na każdej maszynie
+        size_t perMachine = slots.empty() ? 1 : slots.size() / (size_t)(slots.back().machine + 1);
+        bool first = true;
+        if (json)
+            out << "{\"type\":\"frame\",\"final\":" << (final ? "true" : "false") << ",\"key\":false,\"changes\":[";
+        for (size_t i = 0; i < slots.size(); ++i)
+        {
+            const auto &s = slots[i];
+            if (s == last[i])
+                continue;
+            size_t pos = i % perMachine;
+            if (json)
+                out << (first ? "" : ",") << "[" << s.machine << "," << pos << "," << s.job << "," << s.start << ","
+                    << s.end << "," << s.setup << "]";
+            else
+                out << "SLOT_DELTA;machine=" << s.machine << ";pos=" << pos << ";job=" << s.job << ";start=" << s.start
+                    << ";end=" << s.end << ";setup=" << s.setup << "\n";
+            first = false;
+        }
+        out << (json ? "]}\n" : "FRAME_END;iter=0;delta=1\n");
+    }
+};
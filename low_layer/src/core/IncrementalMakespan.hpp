@@ -0,0 +1,208 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include "Instance.hpp"
+
+// Przyrostowa ocena ruchu zamiany dwóch pozycji (SA).
+// Trzyma trwałą macierz zakończeń (head) i ogonów (tail) bieżącej sekwencji.
+// Po zamianie pozycji lo < hi przeliczane są tylko wiersze lo..hi; prefiks bierzemy
+// z head[lo-1], a niezmieniony sufiks dołączamy w O(m) przez tail[hi+1]:
+//   Cmax = max_k (C[hi][k] + s_k(seq[hi], seq[hi+1]) + tail[hi+1][k])
+// Odrzucenie ruchu to tylko zamiana z powrotem - macierze nie są modyfikowane.
+// Po akceptacji wiersze poza lo..hi są odświeżane leniwie przy kolejnych ruchach.
+class IncrementalMakespan
+{
+private:
+    const Instance &instance;
+    std::vector<int> seq;
+    std::vector<long long> head;
+    std::vector<long long> tail;
+    std::vector<long long> scratch;
+    int headValid = 0; // wiersze [0, headValid) są aktualne
+    int tailValid = 0; // wiersze [tailValid, n) są aktualne
+    long long makespan = 0;
+    bool fullRecompute = false;
+
+    // Ruch oczekujący na accept()/undo()
+    int pendingLo = -1;
+    int pendingHi = -1;
+    long long pendingMakespan = 0;
+
+public:
+    explicit IncrementalMakespan(const Instance &inst) : instance(inst) {}
+
+    // Tryb porównawczy: każdy ruch liczony pełnym computeMakespan
+    void setFullRecompute(bool full) { fullRecompute = full; }
+
+    void reset(const std::vector<int> &sequence)
+    {
+        int m = instance.getMachines();
+        seq = sequence;
+        int n = (int)seq.size();
+        head.assign((std::size_t)n * m, 0);
+        tail.assign((std::size_t)n * m, 0);
+        scratch.assign((std::size_t)n * m, 0);
+        headValid = 0;
+        tailValid = n;
+        pendingLo = pendingHi = -1;
+        if (fullRecompute)
+        {
+            makespan = (long long)instance.computeMakespan(seq);
+            return;
+        }
+        instance.visitKernel([&](const auto &setup, auto M)
+                             { extendHead<decltype(M)::value>(setup, n); });
+        makespan = (n > 0) ? head[(std::size_t)n * m - 1] : 0;
+    }
+
+    const std::vector<int> &getSequence() const { return seq; }
+    long long getMakespan() const { return makespan; }
+
+    // Zamienia pozycje i zwraca nowy makespan; ruch trzeba potwierdzić accept() lub cofnąć undo()
+    long long trySwap(int pos1, int pos2)
+    {
+        int lo = std::min(pos1, pos2);
+        int hi = std::max(pos1, pos2);
+        std::swap(seq[lo], seq[hi]);
+        pendingLo = lo;
+        pendingHi = hi;
+
+        if (lo == hi)
+            pendingMakespan = makespan;
+        else if (fullRecompute)
+            pendingMakespan = (long long)instance.computeMakespan(seq);
+        else
+            pendingMakespan = instance.visitKernel([&](const auto &setup, auto M)
+                                                   { return evaluateRange<decltype(M)::value>(setup, lo, hi); });
+        return pendingMakespan;
+    }
+
+    void accept()
+    {
+        if (pendingLo < 0)
+            return;
+        if (!fullRecompute && pendingLo != pendingHi)
+        {
+            int m = instance.getMachines();
+            std::size_t rows = (std::size_t)(pendingHi - pendingLo + 1);
+            std::memcpy(head.data() + (std::size_t)pendingLo * m, scratch.data(), rows * m * sizeof(long long));
+            headValid = pendingHi + 1;
+            tailValid = std::max(tailValid, pendingHi + 1);
+        }
+        makespan = pendingMakespan;
+        pendingLo = pendingHi = -1;
+    }
+
+    void undo()
+    {
+        if (pendingLo < 0)
+            return;
+        std::swap(seq[pendingLo], seq[pendingHi]);
+        pendingLo = pendingHi = -1;
+    }
+
+    // Zamiana oceniona poza ewaluatorem (BatchMakespan): wiersze od lo (głowy) i do hi (ogony)
+    // przestają być aktualne i zostaną dociągnięte leniwie
+    void applySwap(int pos1, int pos2, long long newMakespan)
+    {
+        int lo = std::min(pos1, pos2);
+        int hi = std::max(pos1, pos2);
+        std::swap(seq[lo], seq[hi]);
+        pendingLo = pendingHi = -1;
+        if (lo != hi)
+        {
+            headValid = std::min(headValid, lo);
+            tailValid = std::max(tailValid, hi + 1);
+        }
+        makespan = newMakespan;
+    }
+
+    // Sloty wykresu Gantta bieżącej sekwencji wprost z macierzy zakończeń (dociągane są tylko
+    // nieaktualne wiersze); kolejność [maszyna][pozycja] jak w Schedule::computeSlots
+    void buildSlots(std::vector<SlotRecord> &slots)
+    {
+        int m = instance.getMachines();
+        int n = (int)seq.size();
+        if (fullRecompute)
+            headValid = 0; // w trybie porównawczym macierz nie jest utrzymywana
+        const ProcMatrix &proc = instance.getProcMatrix();
+        slots.resize((std::size_t)n * m);
+        instance.visitKernel([&](const auto &setup, auto M)
+                             {
+            extendHead<decltype(M)::value>(setup, n);
+            for (int i = 0; i < n; ++i)
+            {
+                const std::int32_t *p = proc.row(seq[i]);
+                const long long *row = head.data() + (std::size_t)i * m;
+                for (int k = 0; k < m; ++k)
+                {
+                    int setupTime = (i > 0) ? setup(k, seq[i - 1], seq[i]) : 0;
+                    slots[(std::size_t)k * n + i] = {k, seq[i], row[k] - p[k], row[k], setupTime};
+                }
+            } });
+    }
+
+private:
+    template <int M, typename SetupAccess>
+    void extendHead(const SetupAccess &setup, int upTo)
+    {
+        const ProcMatrix &proc = instance.getProcMatrix();
+        int m = instance.getMachines();
+        for (int i = headValid; i < upTo; ++i)
+            computeRow<M>(setup, proc, i, (i > 0) ? head.data() + (std::size_t)(i - 1) * m : nullptr,
+                          head.data() + (std::size_t)i * m);
+        headValid = std::max(headValid, upTo);
+    }
+
+    template <int M, typename SetupAccess>
+    void extendTail(const SetupAccess &setup, int downTo)
+    {
+        const ProcMatrix &proc = instance.getProcMatrix();
+        int m = instance.getMachines();
+        int n = (int)seq.size();
+        for (int i = tailValid - 1; i >= downTo; --i)
+        {
+            long long *row = tail.data() + (std::size_t)i * m;
+            bool last = (i == n - 1);
+            makespan_kernel::backwardRow<M>(setup, proc.row(seq[i]), m, seq[i], last ? -1 : seq[i + 1],
+                                            last ? nullptr : row + m, row);
+        }
+        tailValid = std::min(tailValid, downTo);
+    }
+
+    template <int M, typename SetupAccess>
+    void computeRow(const SetupAccess &setup, const ProcMatrix &proc, int i, const long long *prevRow, long long *row) const
+    {
+        makespan_kernel::forwardRow<M>(setup, proc.row(seq[i]), instance.getMachines(), prevRow ? seq[i - 1] : -1,
+                                       seq[i], prevRow, row);
+    }
+
+    // Wywoływane z już zamienioną sekwencją; prefiks i sufiks są niezmienione
+    template <int M, typename SetupAccess>
+    long long evaluateRange(const SetupAccess &setup, int lo, int hi)
+    {
+        const ProcMatrix &proc = instance.getProcMatrix();
+        int m = instance.getMachines();
+        int n = (int)seq.size();
+
+        // Prefiks [0, lo) i sufiks (hi, n) nie zależą od zamienionych pozycji
+        extendHead<M>(setup, lo);
+        if (hi + 1 < n)
+            extendTail<M>(setup, hi + 1);
+
+        for (int i = lo; i <= hi; ++i)
+        {
+            const long long *prevRow = (i == lo) ? ((lo > 0) ? head.data() + (std::size_t)(lo - 1) * m : nullptr)
+                                                 : scratch.data() + (std::size_t)(i - lo - 1) * m;
+            computeRow<M>(setup, proc, i, prevRow, scratch.data() + (std::size_t)(i - lo) * m);
+        }
+
+        const long long *last = scratch.data() + (std::size_t)(hi - lo) * m;
+        if (hi == n - 1)
+            return last[m - 1];
+
+        return makespan_kernel::joinTail<M>(setup, m, seq[hi], seq[hi + 1], last, tail.data() + (std::size_t)(hi + 1) * m);
+    }
+};
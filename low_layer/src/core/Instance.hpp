@@ -2,9 +2,18 @@
 #include <vector>
 #include <string>
 #include "Schedule.hpp"
+#include "FlatMatrix.hpp"
+#include "MakespanKernel.hpp"
+#include "MappedFile.hpp"
+#include "BinaryFormat.hpp"
+#include "Profiler.hpp"
 #include <fstream>
 #include <iostream>
-#include <sstream>
+#include <memory>
+#include <charconv>
+#include <cctype>
+#include <cstring>
+#include <string_view>
 #include <vector>
 #include <algorithm>
 class Instance
@@ -12,73 +21,343 @@ class Instance
 private:
     int jobs = 0;
     int machines = 0;
-    std::vector<std::vector<int>> proc_time;
-    std::vector<std::vector<std::vector<int>>> setup_time;
+    ProcMatrix proc_time;
+    SetupMatrix setup_time;
+    SetupLayout setupLayout = SetupLayout::PrevJobMajor;
+    SetupEncoding setupEncoding = SetupEncoding::Narrowest;
+    bool hugePages = false;
     const std::string filePath;
 
 public:
     Instance(const std::string &filename) : filePath(filename) {}
-    inline void loadFromFile()
+
+    // Ustawienia przechowywania; obowiązują przy następnym wczytaniu danych.
+    // hugePages - duże macierze w pamięci mapowanej z prośbą o duże strony
+    void setStorageOptions(SetupLayout layout, SetupEncoding encoding, bool useHugePages = false)
     {
-        std::ifstream file(filePath);
-        if (!file.is_open())
-        {
+        setupLayout = layout;
+        setupEncoding = encoding;
+        hugePages = useHugePages;
+    }
+
+    // Zwraca false, jeśli plik nie został wczytany w całości (szczegóły na std::cerr)
+    // Rozpoznaje format po nagłówku: tekstowy (parsowany z mmap) albo binarny (bez parsowania)
+    inline bool loadFromFile(bool announce = true)
+    {
+        Profiler::Scope profile(Profiler::Phase::Load);
+        auto file = std::make_shared<MappedFile>();
+        bool ok = file->open(filePath);
+        if (!ok)
             std::cerr << "Error: cannot open file " << filePath << std::endl;
-            return;
+        else if (binary_format::hasMagic(file->data(), file->size()))
+            ok = loadBinary(file);
+        else
+            ok = parseText(file->data(), file->size()); // przy błędzie zostaje to, co udało się wczytać
+        if (!ok)
+            return false;
+
+        if (announce)
+        {
+            LogLine() << "=== Instance loaded from: " << filePath << " ===";
+            LogLine() << "Jobs: " << jobs << ", Machines: " << machines;
+            LogLine() << "Setup storage: " << SetupMatrix::widthName(setup_time.getWidth()) << ", "
+                      << (setup_time.bytes() + proc_time.bytes()) / 1024 << " KiB"
+                      << (setup_time.usesHugePages() ? " (huge pages)" : "") << (setup_time.isExternal() ? " (mapped file)" : "");
         }
+        return true;
+    }
+
+    const std::string &getFilePath() const { return filePath; }
 
-        std::string line;
-        while (std::getline(file, line))
+    // Instancja w formacie binarnym z pamięci (np. odebrana przez sieć) - bez parsowania
+    bool loadFromBuffer(std::vector<char> bytes)
+    {
+        auto file = std::make_shared<MappedFile>();
+        file->assign(std::move(bytes));
+        if (!binary_format::hasMagic(file->data(), file->size()))
         {
-            if (line.find("jobs") != std::string::npos)
-            {
-                std::stringstream ss(line);
-                std::string dummy;
-                ss >> dummy >> dummy >> jobs;
-            }
-            else if (line.find("machines") != std::string::npos)
-            {
-                std::stringstream ss(line);
-                std::string dummy;
-                ss >> dummy >> dummy >> machines;
-            }
-            else if (line.find("proc_time") != std::string::npos)
-            {
+            std::cerr << "Error: invalid binary instance (magic) in " << filePath << std::endl;
+            return false;
+        }
+        return loadBinary(file);
+    }
+
+    // Zapis w formacie binarnym (BinaryFormat.hpp) z bieżącym typem i układem przezbrojeń
+    bool saveBinary(const std::string &path) const
+    {
+        std::ofstream out(path, std::ios::binary);
+        if (!out.is_open())
+        {
+            std::cerr << "Error: cannot write file " << path << std::endl;
+            return false;
+        }
+        if (!writeBinary(out))
+            return false;
+        if (!out)
+        {
+            std::cerr << "Error: failed while writing " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool writeBinary(std::ostream &out) const
+    {
+        if (!binary_format::hostIsLittleEndian())
+        {
+            std::cerr << "Error: binary instance format requires a little-endian host" << std::endl;
+            return false;
+        }
+
+        BinaryInstanceHeader header{};
+        std::memcpy(header.magic, binary_format::Magic, sizeof(header.magic));
+        header.version = binary_format::Version;
+        header.jobs = (std::uint32_t)jobs;
+        header.machines = (std::uint32_t)machines;
+        if (setup_time.getWidth() == SetupMatrix::Width::Packed)
+        {
+            std::cerr << "Error: packed setup storage has no binary form; convert with narrow or wide storage" << std::endl;
+            return false;
+        }
+        header.setupWidth = (std::uint32_t)setup_time.elementBytes();
+        header.setupLayout = (setup_time.getLayout() == SetupLayout::MachineMajor) ? 0 : 1;
+        header.procOffset = sizeof(BinaryInstanceHeader);
+        std::uint64_t procBytes = (std::uint64_t)jobs * machines * sizeof(std::int32_t);
+        header.setupOffset = binary_format::alignUp(header.procOffset + procBytes);
+        header.setupBytes = (std::uint64_t)machines * jobs * jobs * header.setupWidth;
+
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        for (int j = 0; j < jobs; ++j)
+            out.write(reinterpret_cast<const char *>(proc_time.row(j)), machines * sizeof(std::int32_t));
+        std::vector<char> padding(header.setupOffset - header.procOffset - procBytes, 0);
+        out.write(padding.data(), padding.size());
+        out.write(static_cast<const char *>(setup_time.rawData()), header.setupBytes);
+        return (bool)out;
+    }
+
+    // procFlat: [job][machine], setupFlat: [machine][prev][curr]
+    void loadFromData(int n, int m, const std::vector<int> &procFlat, const std::vector<int> &setupFlat)
+    {
+        loadFromRows(n, m, [&](int job) { return procFlat.data() + (std::size_t)job * m; },
+                     [&](int machine, int prev) { return setupFlat.data() + ((std::size_t)machine * n + prev) * n; });
+    }
+
+    // Dane wierszami z pamięci (bez płaskiej kopii): procRow(job) -> m wartości,
+    // setupRow(machine, prev) -> n wartości s_machine(prev, 0..n-1)
+    template <typename ProcRow, typename SetupRow>
+    void loadFromRows(int n, int m, ProcRow procRow, SetupRow setupRow)
+    {
+        jobs = n;
+        machines = m;
+        proc_time.assign(n, m);
+        for (int j = 0; j < n; ++j)
+        {
+            const int *row = procRow(j);
+            for (int mach = 0; mach < m; ++mach)
+                proc_time.at(j, mach) = row[mach];
+        }
+        setup_time.begin(n, m, setupLayout, setupEncoding, hugePages);
+        for (int mach = 0; mach < m; ++mach)
+            for (int prev = 0; prev < n; ++prev)
+                setup_time.setRow(mach, prev, setupRow(mach, prev));
+        setup_time.finish();
+    }
+
+    int getJobs() const { return jobs; }
+    int getMachines() const { return machines; }
+
+    int getProcTime(int job, int machine) const
+    {
+        return proc_time(job, machine);
+    }
+
+    int getSetupTime(int machine, int prevJob, int currJob) const
+    {
+        return setup_time(machine, prevJob, currJob);
+    }
+
+    const ProcMatrix &getProcMatrix() const { return proc_time; }
+    const SetupMatrix &getSetupMatrix() const { return setup_time; }
+
+    // f(setup, Machines<M>{}) - widok przezbrojeń i wariant jądra dobrany do liczby maszyn
+    template <typename F>
+    decltype(auto) visitKernel(F &&f) const
+    {
+        return setup_time.visit([&](const auto &setup)
+                                { return makespan_kernel::dispatch(machines, [&](auto M)
+                                                                   { return f(setup, M); }); });
+    }
+
+    // Makespan na jądrze całkowitoliczbowym (MakespanKernel.hpp): jeden wiersz kroczący zamiast macierzy n×m
+    inline long long makespanOf(const std::vector<int> &seq) const
+    {
+        Profiler::Scope profile(Profiler::Phase::Makespan);
+        profile.addEvaluations(1);
+        return visitKernel([&](const auto &setup, auto M)
+                           { return makespan_kernel::makespan<decltype(M)::value>(setup, proc_time, seq.data(), (int)seq.size(), machines); });
+    }
+
+    inline double computeMakespan(const std::vector<int> &seq) const
+    {
+        return (double)makespanOf(seq);
+    }
+
+private:
+    bool loadBinary(const std::shared_ptr<MappedFile> &file)
+    {
+        auto fail = [&](const char *reason)
+        {
+            std::cerr << "Error: invalid binary instance (" << reason << ") in " << filePath << std::endl;
+            return false;
+        };
+
+        if (!binary_format::hostIsLittleEndian())
+            return fail("little-endian host required");
+        if (file->size() < sizeof(BinaryInstanceHeader))
+            return fail("truncated header");
+
+        BinaryInstanceHeader header;
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (header.version != binary_format::Version)
+            return fail("unsupported version");
+        if (header.setupWidth != 1 && header.setupWidth != 2 && header.setupWidth != 4)
+            return fail("setup width");
+        if (header.setupLayout > 1)
+            return fail("setup layout");
+        if (header.setupOffset % binary_format::Alignment != 0)
+            return fail("misaligned setup matrix");
+
+        std::uint64_t n = header.jobs, m = header.machines;
+        std::uint64_t procBytes = n * m * sizeof(std::int32_t);
+        if (header.procOffset + procBytes > file->size())
+            return fail("truncated proc_time");
+        if (header.setupBytes != m * n * n * header.setupWidth || header.setupOffset + header.setupBytes > file->size())
+            return fail("truncated setup_time");
+
+        jobs = (int)n;
+        machines = (int)m;
+        proc_time.assign(jobs, machines);
+        const char *proc = file->data() + header.procOffset;
+        for (int j = 0; j < jobs; ++j)
+            for (int mach = 0; mach < machines; ++mach)
+                std::memcpy(&proc_time.at(j, mach), proc + ((std::size_t)j * machines + mach) * sizeof(std::int32_t), sizeof(std::int32_t));
+
+        setup_time.adopt(jobs, machines, header.setupLayout == 0 ? SetupLayout::MachineMajor : SetupLayout::PrevJobMajor,
+                         header.setupWidth == 1   ? SetupMatrix::Width::Narrow8
+                         : header.setupWidth == 2 ? SetupMatrix::Width::Narrow16
+                                                  : SetupMatrix::Width::Wide32,
+                         file->data() + header.setupOffset, header.setupBytes, file);
+        return true;
+    }
+
+    // Kolejna linia bufora (bez '\n'); false na końcu danych
+    static bool nextLine(const char *&pos, const char *end, std::string_view &line)
+    {
+        if (pos >= end)
+            return false;
+        const char *nl = static_cast<const char *>(std::memchr(pos, '\n', (std::size_t)(end - pos)));
+        const char *stop = nl ? nl : end;
+        line = std::string_view(pos, (std::size_t)(stop - pos));
+        pos = nl ? nl + 1 : end;
+        return true;
+    }
+
+    static bool isBlank(std::string_view line)
+    {
+        return line.find_first_not_of(" \t\r\n") == std::string_view::npos;
+    }
+
+    // Odpowiednik "ss >> val": pomija białe znaki i czyta liczbę przez from_chars
+    static bool readInt(const char *&p, const char *end, int &val)
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\v' || *p == '\f'))
+            ++p;
+        if (p < end && *p == '+')
+            ++p;
+        auto res = std::from_chars(p, end, val);
+        if (res.ec != std::errc())
+            return false;
+        p = res.ptr;
+        return true;
+    }
+
+    // Trzeci token linii "jobs = 10" / "machines : 4"
+    static void readHeaderValue(std::string_view line, int &target)
+    {
+        const char *p = line.data();
+        const char *end = p + line.size();
+        for (int token = 0; token < 2; ++token)
+        {
+            while (p < end && std::isspace((unsigned char)*p))
+                ++p;
+            if (p == end)
+                return;
+            while (p < end && !std::isspace((unsigned char)*p))
+                ++p;
+        }
+        int val = 0;
+        if (readInt(p, end, val))
+            target = val;
+    }
+
+    // Wiersze przezbrojeń trafiają do macierzy od razu (bez pełnej kopii int32 m*n*n)
+    bool parseText(const char *data, std::size_t size)
+    {
+        const char *pos = data;
+        const char *end = data + size;
+        std::string_view line;
+
+        while (nextLine(pos, end, line))
+        {
+            if (line.find("jobs") != std::string_view::npos)
+                readHeaderValue(line, jobs);
+            else if (line.find("machines") != std::string_view::npos)
+                readHeaderValue(line, machines);
+            else if (line.find("proc_time") != std::string_view::npos)
                 break;
-            }
         }
 
-        proc_time.assign(jobs, std::vector<int>(machines, 0));
+        proc_time.assign(jobs, machines);
+        setup_time.begin(jobs, machines, setupLayout, setupEncoding, hugePages);
+        bool ok = parseBody(pos, end);
+        setup_time.finish();
+        return ok;
+    }
+
+    bool parseBody(const char *pos, const char *end)
+    {
+        std::string_view line;
+
         for (int j = 0; j < jobs; ++j)
         {
-            std::string l;
             do
             {
-                if (!std::getline(file, l))
+                if (!nextLine(pos, end, line))
                 {
                     std::cerr << "Error: unexpected EOF while reading proc_time (job=" << j << ") in " << filePath << std::endl;
-                    return;
+                    return false;
                 }
-            } while (l.find_first_not_of(" \t\r\n") == std::string::npos);
+            } while (isBlank(line));
 
-            std::stringstream ss(l);
+            const char *p = line.data();
+            const char *lineEnd = p + line.size();
             for (int m = 0; m < machines; ++m)
             {
                 int val = 0;
-                if (!(ss >> val))
+                if (!readInt(p, lineEnd, val))
                 {
                     std::cerr << "Error: failed to parse proc_time at job=" << j << " machine=" << m
-                              << " from line: '" << l << "' in " << filePath << std::endl;
-                    return;
+                              << " from line: '" << line << "' in " << filePath << std::endl;
+                    return false;
                 }
-                proc_time[j][m] = val;
+                proc_time.at(j, m) = val;
             }
         }
 
         long long procSum = 0;
         for (int j = 0; j < jobs; ++j)
             for (int m = 0; m < machines; ++m)
-                procSum += proc_time[j][m];
+                procSum += proc_time(j, m);
 
         if (procSum == 0)
         {
@@ -89,106 +368,51 @@ public:
             for (int j = 0; j < std::min(jobs, 3); ++j)
             {
                 for (int m = 0; m < std::min(machines, 3); ++m)
-                    std::cerr << proc_time[j][m] << " ";
+                    std::cerr << proc_time(j, m) << " ";
                 std::cerr << "\n";
             }
         }
 
-        setup_time.assign(machines, std::vector<std::vector<int>>(jobs, std::vector<int>(jobs, 0)));
-
+        std::vector<int> row((std::size_t)std::max(jobs, 0));
         for (int m = 0; m < machines; ++m)
         {
 
-            while (std::getline(file, line))
+            while (nextLine(pos, end, line))
             {
-                if (line.find("# machine") != std::string::npos)
+                if (line.find("# machine") != std::string_view::npos)
                     break;
             }
 
             for (int i = 0; i < jobs; ++i)
             {
-                std::string l;
                 do
                 {
-                    if (!std::getline(file, l))
+                    if (!nextLine(pos, end, line))
                     {
                         std::cerr << "Error: unexpected EOF while reading setup_time (machine=" << m << " row=" << i << ") in " << filePath << std::endl;
-                        return;
+                        return false;
                     }
-                } while (l.find_first_not_of(" \t\r\n") == std::string::npos);
+                } while (isBlank(line));
 
-                std::stringstream ss(l);
+                const char *p = line.data();
+                const char *lineEnd = p + line.size();
+                std::fill(row.begin(), row.end(), 0);
                 for (int j = 0; j < jobs; ++j)
                 {
                     int val = 0;
-                    if (!(ss >> val))
+                    if (!readInt(p, lineEnd, val))
                     {
                         std::cerr << "Error: failed to parse setup_time at machine=" << m << " prev=" << i
-                                  << " curr=" << j << " from line: '" << l << "' in " << filePath << std::endl;
-                        return;
+                                  << " curr=" << j << " from line: '" << line << "' in " << filePath << std::endl;
+                        setup_time.setRow(m, i, row.data()); // wczytany początek wiersza
+                        return false;
                     }
-                    setup_time[m][i][j] = val;
+                    row[j] = val;
                 }
+                setup_time.setRow(m, i, row.data());
             }
         }
 
-        file.close();
-
-        std::cout << "=== Instance loaded from: " << filePath << " ===" << std::endl;
-        std::cout << "Jobs: " << jobs << ", Machines: " << machines << std::endl;
-    }
-
-    int getJobs() const { return jobs; }
-    int getMachines() const { return machines; }
-
-    int getProcTime(int job, int machine) const
-    {
-        return proc_time.at(job).at(machine);
-    }
-
-    int getSetupTime(int machine, int prevJob, int currJob) const
-    {
-        return setup_time.at(machine).at(prevJob).at(currJob);
-    }
-
-    const std::vector<std::vector<int>> &getProcTimes() const { return proc_time; }
-    const std::vector<std::vector<std::vector<int>>> &getSetupTimes() const { return setup_time; }
-
-    inline double computeMakespan(const std::vector<int> &seq) const
-    {
-        int n = (int)seq.size();
-        if (n == 0)
-            return 0.0;
-
-        int m = machines;
-
-        std::vector<std::vector<double>> completion(n, std::vector<double>(m, 0.0));
-
-        for (int idx = 0; idx < n; ++idx)
-        {
-            int job = seq[idx];
-
-            for (int mach = 0; mach < m; ++mach)
-            {
-
-                double prevMachineTime = (mach > 0) ? completion[idx][mach - 1] : 0.0;
-                double prevJobTime = (idx > 0) ? completion[idx - 1][mach] : 0.0;
-
-                int prevJob = (idx > 0) ? seq[idx - 1] : job;
-                double setup = 0.0;
-                if (idx > 0)
-                {
-
-                    setup = setup_time[mach][prevJob][job];
-                }
-
-                double proc = proc_time[job][mach];
-
-                double start = std::max(prevMachineTime, prevJobTime + setup);
-                completion[idx][mach] = start + proc;
-            }
-        }
-
-        return completion[n - 1][m - 1];
+        return true;
     }
 };
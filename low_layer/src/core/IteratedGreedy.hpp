@@ -0,0 +1,245 @@
+#pragma once
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <string>
+#include "Instance.hpp"
+#include "Schedule.hpp"
+#include "BatchMakespan.hpp"
+#include "NEHWithProgress.hpp"
+#include "Telemetry.hpp"
+#include "SolveBudget.hpp"
+
+// Iterated Greedy (Ruiz, Stützle): z bieżącej sekwencji usuwamy d losowych zadań, wstawiamy je
+// z powrotem zachłannie jak w NEH (najlepsza pozycja, BatchMakespan::bestInsertion), opcjonalnie
+// poprawiamy lokalnym przeszukiwaniem przez wstawianie, a gorsze rozwiązanie przyjmujemy
+// z prawdopodobieństwem exp(-delta / T) przy stałej temperaturze
+//   T = Tp * suma(p + średni setup) / (n * m * 10).
+class IteratedGreedy
+{
+private:
+    const Instance &instance;
+    std::mt19937 rng;
+    BatchMakespan insertion;
+
+    int maxIterations = 2000;
+    int destroySize = 4;
+    double temperatureFactor = 0.4; // Tp
+    bool localSearch = true;
+    bool verbose = true;
+
+    SolveBudget budget;
+    int iteration = 0;
+    int lastImprovement = 0;
+    bool stopped = false;
+    std::string stopReason;
+
+    std::vector<int> current;
+    long long currentCmax = 0;
+    std::vector<int> bestSeq;
+    long long bestCmax = 0;
+
+    std::vector<int> candidate;
+    std::vector<int> removed;
+    std::vector<int> order;
+
+public:
+    IteratedGreedy(const Instance &inst, int seed = 0) : instance(inst), rng(seed), insertion(inst) {}
+
+    // Iteracje, liczba usuwanych zadań d i współczynnik temperatury Tp
+    void setParameters(int iterations, int destroy, double temperature)
+    {
+        maxIterations = iterations;
+        destroySize = std::max(1, destroy);
+        temperatureFactor = temperature;
+    }
+
+    // false = bez lokalnego przeszukiwania po rekonstrukcji (czyste IG)
+    void setLocalSearch(bool enabled) { localSearch = enabled; }
+
+    // false = brak linii RESULT/SLOT
+    void setVerbose(bool enabled) { verbose = enabled; }
+
+    // Jak w SA: przy limicie czasu liczba iteracji nie jest ograniczeniem
+    void setBudget(const SolveBudget &solveBudget) { budget = solveBudget; }
+
+    const std::string &getStopReason() const { return stopReason; }
+    int getIteration() const { return iteration; }
+
+    Schedule solve(const Schedule &initialSolution = Schedule())
+    {
+        const std::string prefix = "ITERATED_GREEDY";
+        current = initialSolution.getJobSequence();
+        if (current.empty())
+        {
+            NEHWithProgress neh(instance);
+            neh.setVerbose(false);
+            current = neh.solve().getJobSequence();
+        }
+        currentCmax = instance.makespanOf(current);
+        bestSeq = current;
+        bestCmax = currentCmax;
+        iteration = 0;
+        lastImprovement = 0;
+        stopped = false;
+        stopReason.clear();
+        if (budget.targetReached((double)bestCmax))
+            stopWith(budget.targetReason((double)bestCmax));
+
+        if (verbose)
+            LogLine() << prefix << " started. Initial makespan: " << currentCmax;
+
+        int n = (int)current.size();
+        double temperature = acceptanceTemperature();
+        std::uniform_real_distribution<double> probDist(0.0, 1.0);
+        int limit = budget.hasTimeLimit() ? INT_MAX : maxIterations;
+
+        if (localSearch && n > 1 && !stopped)
+        {
+            insertionLocalSearch(current, currentCmax);
+            improve(current, currentCmax);
+        }
+
+        for (; iteration < limit && n > 1; ++iteration)
+        {
+            if (shouldStop())
+                break;
+
+            // Destrukcja: d różnych losowych zadań
+            candidate = current;
+            removed.clear();
+            int d = std::min(destroySize, n - 1);
+            for (int r = 0; r < d; ++r)
+            {
+                int pos = std::uniform_int_distribution<int>(0, (int)candidate.size() - 1)(rng);
+                removed.push_back(candidate[pos]);
+                candidate.erase(candidate.begin() + pos);
+            }
+
+            // Konstrukcja: wstawianie jak w NEH, w kolejności usunięcia
+            long long candidateCmax = 0;
+            for (int job : removed)
+            {
+                int pos = insertion.bestInsertion(candidate, job, candidateCmax);
+                candidate.insert(candidate.begin() + pos, job);
+            }
+
+            if (localSearch)
+                insertionLocalSearch(candidate, candidateCmax);
+
+            // Kryterium akceptacji ze stałą temperaturą
+            if (candidateCmax < currentCmax)
+            {
+                current.swap(candidate);
+                currentCmax = candidateCmax;
+                improve(current, currentCmax);
+            }
+            else if (candidateCmax == currentCmax ||
+                     probDist(rng) < std::exp(-(double)(candidateCmax - currentCmax) / temperature))
+            {
+                current.swap(candidate);
+                currentCmax = candidateCmax;
+            }
+        }
+
+        if (verbose)
+        {
+            if (stopped)
+                LogLine() << prefix << " stopped (" << stopReason << ") after " << iteration << " iterations";
+            LogLine() << prefix << " finished. Final best makespan: " << bestCmax;
+            Schedule(bestSeq).emitFinalSlots(instance);
+        }
+        return Schedule(bestSeq);
+    }
+
+private:
+    double acceptanceTemperature() const
+    {
+        int n = instance.getJobs();
+        int m = instance.getMachines();
+        double total = 0.0;
+        for (int j = 0; j < n; ++j)
+            for (int k = 0; k < m; ++k)
+                total += instance.getProcTime(j, k);
+        // Średni czas przezbrojenia na każdą operację (bez przekątnej)
+        if (n > 1)
+            instance.getSetupMatrix().visit([&](const auto &setup)
+                                            {
+                double setups = 0.0;
+                for (int k = 0; k < m; ++k)
+                    for (int a = 0; a < n; ++a)
+                        for (int b = 0; b < n; ++b)
+                            if (a != b)
+                                setups += setup(k, a, b);
+                total += setups / (n - 1); });
+        return std::max(temperatureFactor * total / ((double)n * m * 10.0), 1e-9);
+    }
+
+    // Pierwsza poprawa przez wstawianie: każde zadanie (w losowej kolejności) wyjmowane
+    // i wstawiane na najlepszą pozycję; powtarzane, dopóki przebieg coś poprawia
+    void insertionLocalSearch(std::vector<int> &seq, long long &cmax)
+    {
+        order = seq;
+        bool improved = true;
+        while (improved && !stopped)
+        {
+            improved = false;
+            std::shuffle(order.begin(), order.end(), rng);
+            for (int job : order)
+            {
+                if (shouldStop())
+                    break;
+                auto at = std::find(seq.begin(), seq.end(), job);
+                seq.erase(at);
+                long long reinserted = 0;
+                int pos = insertion.bestInsertion(seq, job, reinserted);
+                seq.insert(seq.begin() + pos, job);
+                if (reinserted < cmax)
+                {
+                    cmax = reinserted;
+                    improved = true;
+                }
+            }
+        }
+    }
+
+    void improve(const std::vector<int> &seq, long long cmax)
+    {
+        if (cmax >= bestCmax)
+            return;
+        bestCmax = cmax;
+        bestSeq = seq;
+        lastImprovement = iteration;
+        if (budget.targetReached((double)bestCmax))
+            stopWith(budget.targetReason((double)bestCmax));
+        if (verbose)
+        {
+            Telemetry::get().result(iteration, (double)bestCmax, bestSeq);
+            if (Telemetry::get().wantsFrame())
+                Telemetry::get().frame(Schedule(bestSeq).computeSlots(instance), false);
+        }
+    }
+
+    bool stopWith(const char *reason)
+    {
+        stopped = true;
+        stopReason = reason;
+        return true;
+    }
+
+    bool shouldStop()
+    {
+        if (stopped)
+            return true;
+        if (Cancellation::requested())
+            return stopWith("cancelled");
+        if (budget.stagnationLimit > 0 && iteration - lastImprovement >= budget.stagnationLimit)
+            return stopWith("stagnation limit");
+        if (budget.timeUp())
+            return stopWith("time limit");
+        return false;
+    }
+};
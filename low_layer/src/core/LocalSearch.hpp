@@ -0,0 +1,423 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <algorithm>
+#include <string>
+#include "Instance.hpp"
+#include "Schedule.hpp"
+#include "BatchMakespan.hpp"
+#include "MakespanKernel.hpp"
+#include "ThreadPool.hpp"
+#include "Telemetry.hpp"
+#include "SolveBudget.hpp"
+
+// Przeszukiwanie lokalne do optimum lokalnego: sąsiedztwo wstawiania (zadanie z pozycji i na
+// pozycję j) i zamiany (pozycje i < j), strategia pierwszej albo najlepszej poprawy.
+// Przegląd sąsiedztwa dzielony jest między wątki po pozycjach źródłowych i; wątki czytają
+// tylko wspólne Instance oraz głowy/ogony bieżącej sekwencji. Remisy rozstrzyga kolejność
+// przeglądu (najmniejsze i, potem j), więc wynik nie zależy od liczby wątków.
+//  - wstawianie: dla każdego i wszystkie pozycje naraz (BatchMakespan::evaluateInsertions),
+//  - zamiana: wiersze i..j liczone od head[i-1], sufiks dołączany przez tail[j+1].
+class LocalSearch
+{
+public:
+    enum class Neighborhood
+    {
+        Insertion,
+        Swap,
+        Both // VND: wstawianie do optimum, potem zamiana; poprawa zamianą wraca do wstawiania
+    };
+
+    enum class Strategy
+    {
+        FirstImprovement,
+        BestImprovement
+    };
+
+    struct Stats
+    {
+        long long evaluated = 0; // ocenione ruchy
+        int improvements = 0;    // wykonane ruchy
+        int scans = 0;           // przeglądy sąsiedztwa
+        double seconds = 0.0;
+
+        double movesPerSecond() const { return seconds > 0 ? evaluated / seconds : 0.0; }
+    };
+
+    static bool parseNeighborhood(const std::string &text, Neighborhood &out)
+    {
+        if (text == "insertion")
+            out = Neighborhood::Insertion;
+        else if (text == "swap")
+            out = Neighborhood::Swap;
+        else if (text == "both")
+            out = Neighborhood::Both;
+        else
+            return false;
+        return true;
+    }
+
+    static bool parseStrategy(const std::string &text, Strategy &out)
+    {
+        if (text == "first")
+            out = Strategy::FirstImprovement;
+        else if (text == "best")
+            out = Strategy::BestImprovement;
+        else
+            return false;
+        return true;
+    }
+
+private:
+    // Ruch: from = pozycja źródłowa, to = pozycja docelowa (wstawianie: w sekwencji bez zadania)
+    struct Move
+    {
+        long long cmax = LLONG_MAX;
+        int from = -1;
+        int to = -1;
+    };
+
+    // Bufory jednego wątku
+    struct Worker
+    {
+        BatchMakespan insertion;
+        std::vector<int> reduced;
+        std::vector<long long> positions;
+        std::vector<long long> rows;
+        long long evaluated = 0;
+
+        explicit Worker(const Instance &inst) : insertion(inst) {}
+    };
+
+    const Instance &instance;
+    int threads;
+    Neighborhood neighborhood = Neighborhood::Insertion;
+    Strategy strategy = Strategy::FirstImprovement;
+    bool verbose = true;
+    SolveBudget budget;
+
+    std::unique_ptr<ThreadPool> pool;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::vector<int> seq;
+    long long cmax = 0;
+    std::vector<long long> head, tail;
+    std::vector<Move> chunkMoves;
+    std::atomic<int> firstFound{INT_MAX};
+    std::atomic<bool> abortScan{false};
+
+    Stats stats;
+    bool stopped = false;
+    std::string stopReason;
+
+public:
+    LocalSearch(const Instance &inst, int threadCount = 1) : instance(inst), threads(std::max(1, threadCount)) {}
+
+    void setNeighborhood(Neighborhood n) { neighborhood = n; }
+    void setStrategy(Strategy s) { strategy = s; }
+
+    // false = brak linii RESULT/SLOT i logów
+    void setVerbose(bool enabled) { verbose = enabled; }
+
+    // Limit czasu, cel i przerwanie sprawdzane między ruchami i w trakcie przeglądu
+    void setBudget(const SolveBudget &solveBudget) { budget = solveBudget; }
+
+    const Stats &getStats() const { return stats; }
+    const std::string &getStopReason() const { return stopReason; }
+
+    Schedule solve(const Schedule &initialSolution)
+    {
+        const std::string prefix = "LOCAL_SEARCH";
+        auto start = std::chrono::steady_clock::now();
+        seq = initialSolution.getJobSequence();
+        if (seq.empty())
+        {
+            seq.resize(instance.getJobs());
+            for (int j = 0; j < (int)seq.size(); ++j)
+                seq[j] = j;
+        }
+        cmax = instance.makespanOf(seq);
+        stats = Stats();
+        stopped = false;
+        stopReason.clear();
+
+        int n = (int)seq.size();
+        if (threads > 1 && !pool)
+            pool = std::make_unique<ThreadPool>(threads);
+        while ((int)workers.size() < threads)
+            workers.push_back(std::make_unique<Worker>(instance));
+
+        if (verbose)
+            LogLine() << prefix << " started. Initial makespan: " << cmax << " (threads=" << threads << ")";
+
+        Neighborhood active = (neighborhood == Neighborhood::Swap) ? Neighborhood::Swap : Neighborhood::Insertion;
+        int offset = 0;
+        while (n > 1 && !shouldStop())
+        {
+            Move move = scan(active, (strategy == Strategy::FirstImprovement) ? offset : 0);
+            if (stopped)
+                break;
+            if (move.from < 0)
+            {
+                // Optimum lokalne w tym sąsiedztwie
+                if (neighborhood == Neighborhood::Both && active == Neighborhood::Insertion)
+                {
+                    active = Neighborhood::Swap;
+                    offset = 0;
+                    continue;
+                }
+                break;
+            }
+
+            apply(active, move);
+            offset = move.from;
+            if (neighborhood == Neighborhood::Both)
+                active = Neighborhood::Insertion;
+            ++stats.improvements;
+            if (verbose)
+            {
+                Telemetry::get().result(stats.improvements, (double)cmax, seq);
+                if (Telemetry::get().wantsFrame())
+                    Telemetry::get().frame(Schedule(seq).computeSlots(instance), false);
+            }
+        }
+
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (verbose)
+        {
+            if (stopped)
+                LogLine() << prefix << " stopped (" << stopReason << ") after " << stats.improvements << " moves";
+            LogLine() << prefix << " moves evaluated: " << stats.evaluated << " in " << (long long)(stats.seconds * 1000)
+                      << " ms (" << (long long)stats.movesPerSecond() << " moves/s), improving moves: " << stats.improvements;
+            LogLine() << prefix << " finished. Final best makespan: " << cmax;
+            Schedule(seq).emitFinalSlots(instance);
+        }
+        return Schedule(seq);
+    }
+
+private:
+    // Jeden przegląd sąsiedztwa; pozycje źródłowe w kolejności (offset + t) % n, t dzielone na
+    // ciągłe porcje. Porcje pobierane są rosnąco, więc przy pierwszej poprawie późniejsze porcje
+    // mogą przerwać pracę, gdy któraś wcześniejsza już znalazła ruch.
+    Move scan(Neighborhood active, int offset)
+    {
+        int n = (int)seq.size();
+        ++stats.scans;
+        if (active == Neighborhood::Swap)
+            buildHeadTail();
+
+        int chunk = std::max(1, n / (threads * 8));
+        int chunks = (n + chunk - 1) / chunk;
+        chunkMoves.assign(chunks, Move());
+        firstFound.store(INT_MAX, std::memory_order_relaxed);
+        abortScan.store(false, std::memory_order_relaxed);
+        std::atomic<int> nextChunk{0};
+
+        auto work = [&, active, offset, chunk, chunks](Worker &worker)
+        {
+            for (int c = nextChunk.fetch_add(1); c < chunks; c = nextChunk.fetch_add(1))
+            {
+                int first = c * chunk;
+                int last = std::min(n, first + chunk);
+                chunkMoves[c] = scanChunk(worker, active, offset, first, last);
+            }
+        };
+
+        for (auto &worker : workers)
+            worker->evaluated = 0;
+        if (threads == 1)
+            work(*workers[0]);
+        else
+        {
+            for (int w = 0; w < threads; ++w)
+                pool->submit([&, w]
+                             { work(*workers[w]); });
+            pool->wait();
+        }
+        for (const auto &worker : workers)
+            stats.evaluated += worker->evaluated;
+
+        if (abortScan.load(std::memory_order_relaxed))
+        {
+            if (!stopped)
+                shouldStop();
+            return Move();
+        }
+
+        // Porcje w kolejności przeglądu: pierwsza znaleziona albo najmniejszy makespan (pierwszy z równych)
+        Move best;
+        for (const auto &move : chunkMoves)
+        {
+            if (move.from < 0)
+                continue;
+            if (strategy == Strategy::FirstImprovement)
+                return move;
+            if (move.cmax < best.cmax)
+                best = move;
+        }
+        return best;
+    }
+
+    Move scanChunk(Worker &worker, Neighborhood active, int offset, int first, int last)
+    {
+        int n = (int)seq.size();
+        Move best;
+        for (int t = first; t < last; ++t)
+        {
+            if (strategy == Strategy::FirstImprovement && t > firstFound.load(std::memory_order_relaxed))
+                break;
+            if (abortScan.load(std::memory_order_relaxed))
+                break;
+            if (Cancellation::requested() || budget.timeUp())
+            {
+                abortScan.store(true, std::memory_order_relaxed);
+                break;
+            }
+
+            int from = (offset + t) % n;
+            Move found = (active == Neighborhood::Insertion) ? bestInsertionFrom(worker, from)
+                                                              : bestSwapFrom(worker, from);
+            if (found.from < 0 || found.cmax >= best.cmax)
+                continue;
+            best = found;
+            if (strategy == Strategy::FirstImprovement)
+            {
+                int seen = firstFound.load(std::memory_order_relaxed);
+                while (t < seen && !firstFound.compare_exchange_weak(seen, t, std::memory_order_relaxed))
+                {
+                }
+                break;
+            }
+        }
+        return best;
+    }
+
+    // Zadanie z pozycji from na każdą inną pozycję; pierwszy poprawiający albo najlepszy ruch
+    Move bestInsertionFrom(Worker &worker, int from)
+    {
+        int n = (int)seq.size();
+        int job = seq[from];
+        worker.reduced.assign(seq.begin(), seq.end());
+        worker.reduced.erase(worker.reduced.begin() + from);
+        worker.insertion.evaluateInsertions(worker.reduced, job, worker.positions);
+        worker.evaluated += n - 1;
+
+        Move best;
+        for (int to = 0; to < n; ++to)
+        {
+            long long value = worker.positions[to];
+            if (to == from || value >= cmax || value >= best.cmax)
+                continue;
+            best = {value, from, to};
+            if (strategy == Strategy::FirstImprovement)
+                break;
+        }
+        return best;
+    }
+
+    // Zamiana pozycji from z każdą późniejszą pozycją
+    Move bestSwapFrom(Worker &worker, int from)
+    {
+        return instance.visitKernel([&](const auto &setup, auto M)
+                                    { return bestSwapWith<decltype(M)::value>(setup, worker, from); });
+    }
+
+    template <int M, typename SetupAccess>
+    Move bestSwapWith(const SetupAccess &setup, Worker &worker, int lo)
+    {
+        using namespace makespan_kernel;
+        const ProcMatrix &proc = instance.getProcMatrix();
+        int m = instance.getMachines();
+        int n = (int)seq.size();
+        worker.rows.resize((std::size_t)2 * m);
+        long long *rowA = worker.rows.data();
+        long long *rowB = rowA + m;
+
+        Move best;
+        for (int hi = lo + 1; hi < n; ++hi)
+        {
+            // Sekwencja po zamianie na pozycjach lo..hi: seq[hi], seq[lo+1..hi-1], seq[lo]
+            auto jobAt = [&](int i)
+            { return (i == lo) ? seq[hi] : (i == hi) ? seq[lo] : seq[i]; };
+            const long long *prevRow = (lo > 0) ? head.data() + (std::size_t)(lo - 1) * m : nullptr;
+            long long *row = rowA;
+            for (int i = lo; i <= hi; ++i)
+            {
+                forwardRow<M>(setup, proc.row(jobAt(i)), m, (i > 0) ? jobAt(i - 1) : -1, jobAt(i), prevRow, row);
+                prevRow = row;
+                row = (row == rowA) ? rowB : rowA;
+            }
+            long long value = (hi == n - 1) ? prevRow[m - 1]
+                                            : joinTail<M>(setup, m, seq[lo], seq[hi + 1], prevRow,
+                                                          tail.data() + (std::size_t)(hi + 1) * m);
+            ++worker.evaluated;
+            if (value >= cmax || value >= best.cmax)
+                continue;
+            best = {value, lo, hi};
+            if (strategy == Strategy::FirstImprovement)
+                break;
+        }
+        return best;
+    }
+
+    void buildHeadTail()
+    {
+        int m = instance.getMachines();
+        int n = (int)seq.size();
+        head.resize((std::size_t)n * m);
+        tail.resize((std::size_t)n * m);
+        instance.visitKernel([&](const auto &setup, auto M)
+                             {
+            using namespace makespan_kernel;
+            const ProcMatrix &proc = instance.getProcMatrix();
+            for (int i = 0; i < n; ++i)
+            {
+                long long *row = head.data() + (std::size_t)i * m;
+                forwardRow<decltype(M)::value>(setup, proc.row(seq[i]), m, (i > 0) ? seq[i - 1] : -1, seq[i],
+                                               (i > 0) ? row - m : nullptr, row);
+            }
+            for (int i = n - 1; i >= 0; --i)
+            {
+                long long *row = tail.data() + (std::size_t)i * m;
+                bool last = (i == n - 1);
+                backwardRow<decltype(M)::value>(setup, proc.row(seq[i]), m, seq[i], last ? -1 : seq[i + 1],
+                                                last ? nullptr : row + m, row);
+            } });
+    }
+
+    void apply(Neighborhood active, const Move &move)
+    {
+        if (active == Neighborhood::Insertion)
+        {
+            int job = seq[move.from];
+            seq.erase(seq.begin() + move.from);
+            seq.insert(seq.begin() + move.to, job);
+        }
+        else
+            std::swap(seq[move.from], seq[move.to]);
+        cmax = move.cmax;
+        if (budget.targetReached((double)cmax))
+            stopWith(budget.targetReason((double)cmax));
+    }
+
+    bool stopWith(const char *reason)
+    {
+        stopped = true;
+        stopReason = reason;
+        return true;
+    }
+
+    bool shouldStop()
+    {
+        if (stopped)
+            return true;
+        if (Cancellation::requested())
+            return stopWith("cancelled");
+        if (budget.timeUp())
+            return stopWith("time limit");
+        return false;
+    }
+};
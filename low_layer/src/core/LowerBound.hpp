@@ -0,0 +1,128 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include "Instance.hpp"
+
+// Dolne ograniczenie makespanu PFSP-SDST oparte na maszynach. Dla maszyny k i zbioru U zadań
+// jeszcze nieuszeregowanych (po prefiksie kończącym się zadaniem last z wierszem zakończeń C):
+//   LB_k = start_k + suma_U p[j][k] + setup_k(U) + min_U q_k(j)
+// start_k  - C[k] (pusty prefiks: min_U suma p[j][0..k-1]),
+// q_k(j)   - suma p[j][k+1..m-1] (ostatnie zadanie musi jeszcze przejść przez kolejne maszyny),
+// setup_k  - każde zadanie z U ma poprzednika z U ∪ {last}, więc suma najmniejszych przezbrojeń
+//            wchodzących (przy pustym prefiksie bez największego - pierwsze zadanie go nie ma);
+//            symetrycznie wychodzące z U ∪ {last} bez największego (ostatnie nie ma następnika).
+//            Bierzemy większe z obu.
+// LB = max_k LB_k. Przezbrojenia minimalne liczone są tylko w obrębie U ∪ {last}, więc koszt
+// jednej oceny to O(|U|^2 * m) - tanio dla małych instancji w branch-and-bound.
+class LowerBound
+{
+private:
+    const Instance &instance;
+    int n = 0;
+    int m = 0;
+    std::vector<long long> headSum; // [j * m + k] = suma p[j][0..k-1]
+    std::vector<long long> tailSum; // [j * m + k] = suma p[j][k+1..m-1]
+
+public:
+    explicit LowerBound(const Instance &inst) : instance(inst), n(inst.getJobs()), m(inst.getMachines())
+    {
+        headSum.assign((std::size_t)n * m, 0);
+        tailSum.assign((std::size_t)n * m, 0);
+        for (int j = 0; j < n; ++j)
+        {
+            long long before = 0;
+            for (int k = 0; k < m; ++k)
+            {
+                headSum[(std::size_t)j * m + k] = before;
+                before += instance.getProcTime(j, k);
+            }
+            long long after = 0;
+            for (int k = m - 1; k >= 0; --k)
+            {
+                tailSum[(std::size_t)j * m + k] = after;
+                after += instance.getProcTime(j, k);
+            }
+        }
+    }
+
+    // Ograniczenie dla całej instancji (pusty prefiks)
+    long long compute() const
+    {
+        std::vector<int> all(n);
+        for (int j = 0; j < n; ++j)
+            all[j] = j;
+        return instance.getSetupMatrix().visit([&](const auto &setup)
+                                               { return partial(setup, nullptr, -1, all.data(), n); });
+    }
+
+    // Ograniczenie dla prefiksu: row - zakończenia ostatniego zadania prefiksu (nullptr dla pustego),
+    // last - to zadanie (-1), unscheduled - count zadań jeszcze nieuszeregowanych
+    template <typename SetupAccess>
+    long long partial(const SetupAccess &setup, const long long *row, int last, const int *unscheduled, int count) const
+    {
+        if (count == 0)
+            return row ? row[m - 1] : 0;
+
+        long long bound = 0;
+        for (int k = 0; k < m; ++k)
+        {
+            long long start = LLONG_MAX;
+            long long tail = LLONG_MAX;
+            long long work = 0;
+            for (int u = 0; u < count; ++u)
+            {
+                int j = unscheduled[u];
+                work += instance.getProcTime(j, k);
+                start = std::min(start, headSum[(std::size_t)j * m + k]);
+                tail = std::min(tail, tailSum[(std::size_t)j * m + k]);
+            }
+            if (row)
+                start = row[k];
+
+            bound = std::max(bound, start + work + setupBound(setup, k, last, unscheduled, count) + tail);
+        }
+        return bound;
+    }
+
+private:
+    template <typename SetupAccess>
+    long long setupBound(const SetupAccess &setup, int k, int last, const int *unscheduled, int count) const
+    {
+        // Wchodzące: poprzednik z U \ {j} albo last
+        long long inSum = 0, inMax = 0;
+        for (int a = 0; a < count; ++a)
+        {
+            int j = unscheduled[a];
+            long long best = (last >= 0) ? setup(k, last, j) : LLONG_MAX;
+            for (int b = 0; b < count; ++b)
+                if (b != a)
+                    best = std::min<long long>(best, setup(k, unscheduled[b], j));
+            if (best == LLONG_MAX)
+                best = 0;
+            inSum += best;
+            inMax = std::max(inMax, best);
+        }
+        if (last < 0)
+            inSum -= inMax;
+
+        // Wychodzące: następnik z U \ {i}; źródła to U oraz last
+        long long outSum = 0, outMax = 0;
+        for (int a = (last >= 0) ? -1 : 0; a < count; ++a)
+        {
+            int i = (a < 0) ? last : unscheduled[a];
+            long long best = LLONG_MAX;
+            for (int b = 0; b < count; ++b)
+                if (b != a)
+                    best = std::min<long long>(best, setup(k, i, unscheduled[b]));
+            if (best == LLONG_MAX)
+                best = 0;
+            outSum += best;
+            outMax = std::max(outMax, best);
+        }
+        outSum -= outMax;
+
+        return std::max(inSum, outSum);
+    }
+};
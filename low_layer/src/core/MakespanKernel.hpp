@@ -0,0 +1,124 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "FlatMatrix.hpp"
+
+// Wspólne jądro rekurencji PFSP-SDST na liczbach całkowitych (NEH, SA, harmonogram dla GUI):
+//   C[k] = max(C[k-1], C_prev[k] + s_k(prev, job)) + p[job][k]     (pierwsze zadanie bez przezbrojenia)
+// Parametr M > 0 to liczba maszyn znana w czasie kompilacji (pętle po maszynach rozwijane),
+// M = 0 to wersja ogólna z m podanym w czasie wykonania. dispatch() wybiera wariant raz na wywołanie.
+namespace makespan_kernel
+{
+    constexpr int MaxSpecialized = 4;
+
+    template <int M>
+    using Machines = std::integral_constant<int, M>;
+
+    // f(Machines<M>{}) dla m = 1..MaxSpecialized, w przeciwnym razie f(Machines<0>{})
+    template <typename F>
+    decltype(auto) dispatch(int m, F &&f)
+    {
+        switch (m)
+        {
+        case 1:
+            return f(Machines<1>{});
+        case 2:
+            return f(Machines<2>{});
+        case 3:
+            return f(Machines<3>{});
+        case 4:
+            return f(Machines<4>{});
+        default:
+            return f(Machines<0>{});
+        }
+    }
+
+    template <int M>
+    inline int machineCount(int m) { return (M > 0) ? M : m; }
+
+    // Wiersz zakończeń zadania job po prevJob; prev == nullptr dla pierwszego zadania.
+    // out może być tym samym wierszem co prev (wiersz kroczący). T - typ czasów (long long; int32 w BatchMakespan).
+    template <int M, typename SetupAccess, typename T>
+    inline void forwardRow(const SetupAccess &setup, const std::int32_t *p, int m, int prevJob, int job,
+                           const T *prev, T *out)
+    {
+        const int mm = machineCount<M>(m);
+        T byMachine = 0;
+        if (prev)
+        {
+            for (int k = 0; k < mm; ++k)
+            {
+                byMachine = std::max<T>(byMachine, prev[k] + setup(k, prevJob, job)) + p[k];
+                out[k] = byMachine;
+            }
+        }
+        else
+        {
+            for (int k = 0; k < mm; ++k)
+            {
+                byMachine += p[k];
+                out[k] = byMachine;
+            }
+        }
+    }
+
+    // Ogon zadania job przed nextJob (najdłuższa ścieżka od startu na maszynie k do końca);
+    // next == nullptr dla ostatniego zadania
+    template <int M, typename SetupAccess, typename T>
+    inline void backwardRow(const SetupAccess &setup, const std::int32_t *p, int m, int job, int nextJob,
+                            const T *next, T *out)
+    {
+        const int mm = machineCount<M>(m);
+        T byMachine = 0;
+        for (int k = mm - 1; k >= 0; --k)
+        {
+            T bySequence = next ? next[k] + setup(k, job, nextJob) : 0;
+            byMachine = std::max(byMachine, bySequence) + p[k];
+            out[k] = byMachine;
+        }
+    }
+
+    // Makespan połączenia: wiersz zakończeń zadania job, przezbrojenie do nextJob i ogon następnika
+    template <int M, typename SetupAccess>
+    inline long long joinTail(const SetupAccess &setup, int m, int job, int nextJob, const long long *row,
+                              const long long *nextTail)
+    {
+        const int mm = machineCount<M>(m);
+        long long result = 0;
+        for (int k = 0; k < mm; ++k)
+            result = std::max(result, row[k] + setup(k, job, nextJob) + nextTail[k]);
+        return result;
+    }
+
+    // Cały harmonogram na jednym wierszu kroczącym row (co najmniej m elementów);
+    // onRow(idx, row) widzi zakończenia zadania seq[idx] na wszystkich maszynach
+    template <int M, typename SetupAccess, typename OnRow>
+    inline long long scheduleRows(const SetupAccess &setup, const ProcMatrix &proc, const int *seq, int n, int m,
+                                  long long *row, OnRow &&onRow)
+    {
+        const int mm = machineCount<M>(m);
+        for (int idx = 0; idx < n; ++idx)
+        {
+            forwardRow<M>(setup, proc.row(seq[idx]), mm, (idx > 0) ? seq[idx - 1] : -1, seq[idx],
+                          (idx > 0) ? row : nullptr, row);
+            onRow(idx, (const long long *)row);
+        }
+        return (n > 0) ? row[mm - 1] : 0;
+    }
+
+    // Sam makespan; dla m <= 16 wiersz na stosie, bez alokacji
+    template <int M, typename SetupAccess>
+    inline long long makespan(const SetupAccess &setup, const ProcMatrix &proc, const int *seq, int n, int m)
+    {
+        auto ignore = [](int, const long long *) {};
+        if (M > 0 || m <= 16)
+        {
+            long long row[(M > 0) ? M : 16];
+            return scheduleRows<M>(setup, proc, seq, n, m, row, ignore);
+        }
+        std::vector<long long> row(m);
+        return scheduleRows<M>(setup, proc, seq, n, m, row.data(), ignore);
+    }
+}
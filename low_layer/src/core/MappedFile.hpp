@@ -0,0 +1,83 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Plik tylko do odczytu zmapowany w pamięć (mmap). Gdy mmap nie jest możliwy
+// (np. potok albo pusty plik), zawartość jest wczytywana do zwykłego bufora.
+// assign() przejmuje gotowy bufor (np. instancja binarna odebrana przez sieć).
+class MappedFile
+{
+private:
+    const char *ptr = nullptr;
+    std::size_t length = 0;
+    bool mapped = false;
+    std::vector<char> fallback;
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const std::string &path)
+    {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+        {
+            void *addr = ::mmap(nullptr, (std::size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED)
+            {
+                ::madvise(addr, (std::size_t)st.st_size, MADV_SEQUENTIAL);
+                ptr = static_cast<const char *>(addr);
+                length = (std::size_t)st.st_size;
+                mapped = true;
+                ::close(fd);
+                return true;
+            }
+        }
+
+        char chunk[1 << 16];
+        ssize_t got;
+        while ((got = ::read(fd, chunk, sizeof(chunk))) > 0)
+            fallback.insert(fallback.end(), chunk, chunk + got);
+        ::close(fd);
+        if (got < 0)
+            return false;
+        ptr = fallback.data();
+        length = fallback.size();
+        return true;
+    }
+
+    void assign(std::vector<char> bytes)
+    {
+        close();
+        fallback = std::move(bytes);
+        ptr = fallback.data();
+        length = fallback.size();
+    }
+
+    void close()
+    {
+        if (mapped)
+            ::munmap(const_cast<char *>(ptr), length);
+        ptr = nullptr;
+        length = 0;
+        mapped = false;
+        fallback.clear();
+    }
+
+    const char *data() const { return ptr; }
+    std::size_t size() const { return length; }
+    bool isMapped() const { return mapped; }
+};
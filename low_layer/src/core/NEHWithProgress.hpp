@@ -4,15 +4,33 @@
 #include <iostream>
 #include "Instance.hpp"
 #include "Schedule.hpp"
+#include "BatchMakespan.hpp"
+#include "Telemetry.hpp"
+#include "SolveBudget.hpp"
+#include "Profiler.hpp"
 
 class NEHWithProgress {
 private:
     const Instance &instance;
+    BatchMakespan insertion;
+    bool verbose = true;
+    SolveBudget budget;
+    bool stopped = false;
 
 public:
-    NEHWithProgress(const Instance &inst) : instance(inst) {}
+    NEHWithProgress(const Instance &inst) : instance(inst), insertion(inst) {}
+
+    // false = brak linii NEH_PROGRESS/SLOT (tryb wsadowy)
+    void setVerbose(bool enabled) { verbose = enabled; }
+
+    // Limit czasu i przerwanie sprawdzane między wstawieniami
+    void setBudget(const SolveBudget &solveBudget) { budget = solveBudget; }
+
+    // true = przerwane; pozostałe zadania dopisane na końcu w kolejności LPT
+    bool wasStopped() const { return stopped; }
 
     Schedule solve() {
+        Profiler::Scope profile(Profiler::Phase::Neh);
         int n = instance.getJobs();
         int m = instance.getMachines();
 
@@ -28,7 +46,14 @@ public:
         std::vector<int> sequence;
         if (!jobKeys.empty()) sequence.push_back(jobKeys[0].second);
 
+        stopped = false;
         for (size_t t = 1; t < jobKeys.size(); ++t) {
+            if (Cancellation::requested() || budget.timeUp()) {
+                // Harmonogram musi być kompletny - reszta zadań bez optymalizacji pozycji
+                stopped = true;
+                for (; t < jobKeys.size(); ++t) sequence.push_back(jobKeys[t].second);
+                break;
+            }
             int newJob = jobKeys[t].second;
             insertBestWithChoice(sequence, newJob, t + 1);
             
@@ -39,29 +64,21 @@ public:
 
         // Wynik końcowy wysyła sloty do GUI
         Schedule finalSched(sequence);
-        finalSched.emitFinalSlots(instance);
+        if (verbose) finalSched.emitFinalSlots(instance);
 
         return finalSched;
     }
 
 private:
+    // Wszystkie pozycje oceniane naraz (głowy/ogony, po jednej pozycji na tor wektora), bez kopiowania sekwencji
     void insertBestWithChoice(std::vector<int> &sequence, int job, int iteration) {
-        std::vector<int> bestSeq;
-        double bestMakespan = 1e18;
-
-        for (int pos = 0; pos <= (int)sequence.size(); ++pos) {
-            std::vector<int> candidate = sequence;
-            candidate.insert(candidate.begin() + pos, job);
-
-            double makespan = instance.computeMakespan(candidate);
-            if (makespan < bestMakespan) {
-                bestMakespan = makespan;
-                bestSeq = candidate;
-            }
-        }
-        sequence = bestSeq;
+        Profiler::Scope profile(Profiler::Phase::NehInsertion);
+        profile.addEvaluations((long long)sequence.size() + 1);
+        long long bestMakespan = 0;
+        int bestPos = insertion.bestInsertion(sequence, job, bestMakespan);
+        sequence.insert(sequence.begin() + bestPos, job);
         
         // Informacja o postępie dla GUI
-        std::cout << "NEH_PROGRESS;iter=" << iteration << ";cmax=" << bestMakespan << std::endl;
+        if (verbose) Telemetry::get().progress(iteration, (double)bestMakespan);
     }
 };
\ No newline at end of file
@@ -0,0 +1,191 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <iostream>
+#include "Instance.hpp"
+#include "Schedule.hpp"
+#include "SimulatedAnnealing.hpp"
+#include "ThreadPool.hpp"
+#include "Telemetry.hpp"
+#include "SolveBudget.hpp"
+
+// Parametry jednego łańcucha SA
+struct AnnealingChainConfig
+{
+    int seed = 1;
+    int iterations = 50000;
+    double temperature = 100.0;
+    double cooling = 0.9975;
+};
+
+// Wiele niezależnych łańcuchów SA (wyspy) na puli wątków, współdzielących tylko Instance.
+// Łańcuchy liczą odcinki po migrationInterval iteracji; między odcinkami (bariera) najlepsze
+// rozwiązanie wyspy i-1 trafia do wyspy i (pierścień), jeśli jest lepsze od jej bieżącego.
+// Wymiana odbywa się w stałej kolejności, więc wynik zależy tylko od ziarna i liczby łańcuchów.
+class ParallelAnnealing
+{
+public:
+    struct ChainReport
+    {
+        int seed;
+        double bestMakespan;
+        double seconds;
+    };
+
+private:
+    const Instance &instance;
+    int threads;
+    int migrationInterval = 0; // 0 = łańcuchy całkowicie niezależne (multi-start)
+    std::vector<AnnealingChainConfig> chains;
+    std::vector<ChainReport> reports;
+    double wallSeconds = 0.0;
+    SolveBudget budget;
+    int moveBatch = 1;
+    AnnealingSchedule schedule;
+    SolutionCache *cache = nullptr;
+    SolutionCache::Counters cacheCounters;
+
+public:
+    ParallelAnnealing(const Instance &inst, int threadCount) : instance(inst), threads(std::max(1, threadCount)) {}
+
+    // Łańcuch 0 dostaje bazowe ziarno (jak pojedyncze SA), pozostałe ziarna wyprowadzone z seed_seq
+    static std::vector<AnnealingChainConfig> makeChains(int count, int baseSeed, int iterations, double temperature, double cooling)
+    {
+        std::vector<AnnealingChainConfig> configs(std::max(1, count));
+        for (int i = 0; i < (int)configs.size(); ++i)
+        {
+            int seed = baseSeed;
+            if (i > 0)
+            {
+                std::seed_seq seq{baseSeed, i};
+                std::uint32_t derived = 0;
+                seq.generate(&derived, &derived + 1);
+                seed = (int)(derived & 0x7fffffff);
+            }
+            configs[i] = {seed, iterations, temperature, cooling};
+        }
+        return configs;
+    }
+
+    void setChains(const std::vector<AnnealingChainConfig> &configs) { chains = configs; }
+    void setMigrationInterval(int iterations) { migrationInterval = std::max(0, iterations); }
+
+    // Wspólny budżet wszystkich łańcuchów; cel osiągnięty przez jeden łańcuch kończy wszystkie na barierze
+    void setBudget(const SolveBudget &solveBudget) { budget = solveBudget; }
+
+    // Ruch "najlepszy z K" w każdym łańcuchu (SimulatedAnnealing::setMoveBatch)
+    void setMoveBatch(int k) { moveBatch = std::max(1, k); }
+
+    // Harmonogram temperatury każdego łańcucha (SimulatedAnnealing::setSchedule)
+    void setSchedule(const AnnealingSchedule &annealingSchedule) { schedule = annealingSchedule; }
+
+    // Jeden cache odwiedzonych rozwiązań dla wszystkich łańcuchów (SimulatedAnnealing::setSolutionCache)
+    void setSolutionCache(SolutionCache *solutionCache) { cache = solutionCache; }
+    const SolutionCache::Counters &getCacheCounters() const { return cacheCounters; }
+
+    const std::vector<ChainReport> &getReports() const { return reports; }
+    double getWallSeconds() const { return wallSeconds; }
+
+    Schedule solve(const Schedule &initialSolution = Schedule())
+    {
+        using Clock = std::chrono::steady_clock;
+        auto wallStart = Clock::now();
+
+        if (chains.empty())
+            chains = makeChains(threads, 1, 50000, 100.0, 0.9975);
+
+        int count = (int)chains.size();
+        std::vector<std::unique_ptr<SimulatedAnnealing>> sa;
+        int longest = 0;
+        for (const auto &cfg : chains)
+        {
+            sa.push_back(std::make_unique<SimulatedAnnealing>(instance, cfg.seed));
+            sa.back()->setParameters(cfg.iterations, cfg.temperature, cfg.cooling);
+            sa.back()->setVerbose(false);
+            sa.back()->setBudget(budget);
+            sa.back()->setMoveBatch(moveBatch);
+            sa.back()->setSchedule(schedule);
+            sa.back()->setSolutionCache(cache);
+            sa.back()->begin(initialSolution);
+            longest = std::max(longest, cfg.iterations);
+        }
+
+        reports.assign(count, ChainReport{0, 0.0, 0.0});
+        int epoch = (migrationInterval > 0) ? migrationInterval : std::max(1, longest);
+        int bestChain = bestOf(sa);
+        double globalBest = sa[bestChain]->getBestMakespan();
+
+        ThreadPool pool(std::min(threads, count));
+        bool running = true;
+        while (running)
+        {
+            for (int i = 0; i < count; ++i)
+                pool.submit([&, i]
+                            {
+                                auto t0 = Clock::now();
+                                sa[i]->advance(epoch);
+                                reports[i].seconds += std::chrono::duration<double>(Clock::now() - t0).count(); });
+            pool.wait();
+
+            running = false;
+            for (const auto &chain : sa)
+                running = running || !chain->finished();
+
+            bestChain = bestOf(sa);
+            if (sa[bestChain]->getBestMakespan() < globalBest)
+            {
+                globalBest = sa[bestChain]->getBestMakespan();
+                Telemetry::get().result(sa[bestChain]->getIteration(), globalBest, sa[bestChain]->getBestSequence(), bestChain);
+            }
+
+            if (budget.targetReached(globalBest))
+                running = false;
+
+            if (running && migrationInterval > 0 && count > 1)
+                migrate(sa);
+        }
+
+        cacheCounters = SolutionCache::Counters();
+        for (int i = 0; i < count; ++i)
+        {
+            reports[i].seed = chains[i].seed;
+            reports[i].bestMakespan = sa[i]->getBestMakespan();
+            cacheCounters += sa[i]->getCacheCounters();
+        }
+        wallSeconds = std::chrono::duration<double>(Clock::now() - wallStart).count();
+        return Schedule(sa[bestChain]->getBestSequence());
+    }
+
+private:
+    // Pierwszy łańcuch o najmniejszym makespanie - deterministyczne rozstrzyganie remisów
+    static int bestOf(const std::vector<std::unique_ptr<SimulatedAnnealing>> &sa)
+    {
+        int best = 0;
+        for (int i = 1; i < (int)sa.size(); ++i)
+            if (sa[i]->getBestMakespan() < sa[best]->getBestMakespan())
+                best = i;
+        return best;
+    }
+
+    static void migrate(std::vector<std::unique_ptr<SimulatedAnnealing>> &sa)
+    {
+        int count = (int)sa.size();
+        // Migranci kopiowani przed jakąkolwiek zmianą, żeby kolejność nie wpływała na wynik
+        std::vector<std::vector<int>> migrants;
+        std::vector<double> migrantCmax;
+        for (const auto &chain : sa)
+        {
+            migrants.push_back(chain->getBestSequence());
+            migrantCmax.push_back(chain->getBestMakespan());
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            int from = (i + count - 1) % count;
+            if (migrantCmax[from] < sa[i]->getCurrentMakespan())
+                sa[i]->adoptSolution(migrants[from]);
+        }
+    }
+};
@@ -0,0 +1,238 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// PFSP_PROFILE=0 (make PROFILE=0) usuwa instrumentację z kodu; przy 1 jest wyłączona do --profile
+#ifndef PFSP_PROFILE
+#define PFSP_PROFILE 1
+#endif
+
+// Profil gorących ścieżek: stoper zakresu (Profiler::Scope) i liczniki atomowe na fazę.
+// Wyłączony w czasie działania kosztuje jeden odczyt flagi na wywołanie. Fazy oznaczone jako
+// śledzone zapisują też zdarzenia w formacie Chrome trace (chrome://tracing, Perfetto);
+// drobne (pojedynczy makespan, wstawienie NEH) są tylko sumowane.
+// Alokacje liczone są wyłącznie w pfsp_sdst (app/ProfileAlloc.cpp podmienia operator new).
+class Profiler
+{
+public:
+    enum class Phase
+    {
+        Load,
+        LowerBound,
+        Neh,
+        NehInsertion,
+        IteratedGreedy,
+        Annealing,
+        LocalSearch,
+        BranchAndBound,
+        Makespan,
+        Slots,
+        Count
+    };
+
+    static constexpr bool compiledIn = PFSP_PROFILE != 0;
+
+    // Pomiar od konstrukcji do destrukcji; evaluations - liczba ocen rozwiązań w zakresie
+    class Scope
+    {
+    private:
+        Phase phase;
+        bool active;
+        long long evaluations = 0;
+        long long allocations = 0;
+        std::chrono::steady_clock::time_point begin;
+
+    public:
+        explicit Scope(Phase p) : phase(p), active(compiledIn && enabled())
+        {
+            if (active)
+            {
+                allocations = threadAllocations();
+                begin = std::chrono::steady_clock::now();
+            }
+        }
+        ~Scope()
+        {
+            if (active)
+                get().record(phase, begin, std::chrono::steady_clock::now(), evaluations, threadAllocations() - allocations);
+        }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+        void addEvaluations(long long count) { evaluations += count; }
+    };
+
+private:
+    struct Stats
+    {
+        std::atomic<long long> calls{0};
+        std::atomic<long long> nanos{0};
+        std::atomic<long long> evaluations{0};
+        std::atomic<long long> allocations{0};
+    };
+
+    struct TraceEvent
+    {
+        Phase phase;
+        int thread;
+        long long startMicros;
+        long long durationMicros;
+        long long evaluations;
+    };
+
+    static constexpr std::size_t MaxTraceEvents = 1 << 20;
+
+    static inline std::atomic<bool> on{false}; // poza get() - sprawdzenie bez strażnika zmiennej statycznej
+    std::atomic<bool> tracing{false};
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    Stats stats[(int)Phase::Count];
+    std::atomic<long long> saAccepted{0};
+    std::atomic<long long> saRejected{0};
+    std::atomic<int> nextThread{0};
+
+    std::mutex traceMtx;
+    std::vector<TraceEvent> events;
+    long long droppedEvents = 0;
+
+public:
+    static Profiler &get()
+    {
+        static Profiler instance;
+        return instance;
+    }
+
+    static bool enabled() { return compiledIn && on.load(std::memory_order_relaxed); }
+
+    // Licznik alokacji bieżącego wątku (zwiększany przez podmieniony operator new) i informacja, czy działa
+    static long long &threadAllocations()
+    {
+        static thread_local long long count = 0;
+        return count;
+    }
+    static std::atomic<bool> &allocationsHooked()
+    {
+        static std::atomic<bool> hooked{false};
+        return hooked;
+    }
+
+    void enable(bool trace)
+    {
+        if (!compiledIn)
+            return;
+        origin = std::chrono::steady_clock::now();
+        tracing.store(trace);
+        on.store(true);
+    }
+
+    // Akceptacje/odrzucenia SA - zliczane lokalnie w łańcuchu i dodawane po odcinku
+    void addAnnealingMoves(long long accepted, long long rejected)
+    {
+        if (!enabled())
+            return;
+        saAccepted.fetch_add(accepted, std::memory_order_relaxed);
+        saRejected.fetch_add(rejected, std::memory_order_relaxed);
+    }
+
+    void record(Phase phase, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end,
+                long long evaluations, long long allocations)
+    {
+        long long nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+        Stats &s = stats[(int)phase];
+        s.calls.fetch_add(1, std::memory_order_relaxed);
+        s.nanos.fetch_add(nanos, std::memory_order_relaxed);
+        s.evaluations.fetch_add(evaluations, std::memory_order_relaxed);
+        s.allocations.fetch_add(allocations, std::memory_order_relaxed);
+
+        if (!tracing.load(std::memory_order_relaxed) || !traced(phase))
+            return;
+        long long start = std::chrono::duration_cast<std::chrono::microseconds>(begin - origin).count();
+        std::lock_guard<std::mutex> lock(traceMtx);
+        if (events.size() >= MaxTraceEvents)
+        {
+            ++droppedEvents;
+            return;
+        }
+        events.push_back({phase, threadId(), start, std::max(1LL, nanos / 1000), evaluations});
+    }
+
+    // Tabela faz: czas, wywołania, oceny/s, alokacje; potem współczynnik akceptacji SA
+    void report(std::ostream &out)
+    {
+        if (!enabled())
+            return;
+        bool allocs = allocationsHooked().load();
+        char line[160];
+        out << "\n=== Profile ===\n";
+        std::snprintf(line, sizeof(line), "%-16s %12s %12s %12s %14s %14s %12s\n", "phase", "calls", "total ms", "avg us",
+                      "evaluations", "evals/s", "allocs");
+        out << line;
+        for (int p = 0; p < (int)Phase::Count; ++p)
+        {
+            const Stats &s = stats[p];
+            long long calls = s.calls.load(), nanos = s.nanos.load(), evals = s.evaluations.load();
+            if (calls == 0)
+                continue;
+            double seconds = (double)nanos * 1e-9;
+            // Fazy bez zliczanych ocen (np. iterated_greedy) - kreska zamiast zera
+            std::string evalText = evals > 0 ? std::to_string(evals) : "-";
+            std::string rateText = evals > 0 && seconds > 0 ? std::to_string((long long)((double)evals / seconds)) : "-";
+            std::string allocText = allocs ? std::to_string(s.allocations.load()) : "-";
+            std::snprintf(line, sizeof(line), "%-16s %12lld %12.1f %12.2f %14s %14s %12s\n", name((Phase)p), calls,
+                          seconds * 1e3, (double)nanos / 1e3 / (double)calls, evalText.c_str(), rateText.c_str(), allocText.c_str());
+            out << line;
+        }
+        long long accepted = saAccepted.load(), rejected = saRejected.load();
+        if (accepted + rejected > 0)
+            out << "SA moves: " << accepted << " accepted, " << rejected << " rejected (acceptance "
+                << 100.0 * (double)accepted / (double)(accepted + rejected) << "%)\n";
+        out << "Times are inclusive (nested phases and parallel threads are summed)\n";
+        out.flush();
+    }
+
+    // Plik JSON Chrome trace: zdarzenia "X" na wątek i liczniki końcowe w metadanych
+    bool writeTrace(const std::string &path)
+    {
+        std::FILE *f = std::fopen(path.c_str(), "w");
+        if (!f)
+            return false;
+        std::lock_guard<std::mutex> lock(traceMtx);
+        std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f);
+        for (std::size_t i = 0; i < events.size(); ++i)
+        {
+            const TraceEvent &e = events[i];
+            std::fprintf(f, "%s{\"name\":\"%s\",\"cat\":\"pfsp\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%lld,\"dur\":%lld,"
+                            "\"args\":{\"evaluations\":%lld}}",
+                         i ? ",\n" : "", name(e.phase), e.thread, e.startMicros, e.durationMicros, e.evaluations);
+        }
+        std::fprintf(f, "\n],\"otherData\":{\"droppedEvents\":%lld,\"saAccepted\":%lld,\"saRejected\":%lld}}\n", droppedEvents,
+                     saAccepted.load(), saRejected.load());
+        bool ok = !std::ferror(f);
+        return (std::fclose(f) == 0) && ok;
+    }
+
+    static const char *name(Phase phase)
+    {
+        static const char *names[] = {"load", "lower_bound", "neh", "neh.insertion", "iterated_greedy", "annealing",
+                                      "local_search", "branch_and_bound", "makespan", "slots"};
+        return names[(int)phase];
+    }
+
+private:
+    Profiler() = default;
+
+    static bool traced(Phase phase) { return phase != Phase::Makespan && phase != Phase::NehInsertion; }
+
+    int threadId()
+    {
+        static thread_local int id = -1;
+        if (id < 0)
+            id = nextThread.fetch_add(1);
+        return id;
+    }
+};
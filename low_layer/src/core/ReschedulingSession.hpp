@@ -0,0 +1,279 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Instance.hpp"
+#include "Schedule.hpp"
+#include "BatchMakespan.hpp"
+#include "NEHWithProgress.hpp"
+#include "IteratedGreedy.hpp"
+#include "SolveBudget.hpp"
+
+// Sesja przeplanowania: instancja, do której dochodzą i z której znikają zadania, oraz bieżący plan.
+// Dane główne trzymane są z zapasem (stride = pojemność), więc dodanie / usunięcie zadania zmienia
+// tylko jego wiersz czasów i wiersze/kolumny przezbrojeń - O(m * n), bez wczytywania pliku.
+// Zwarta Instance dla solverów odbudowywana jest z tych wierszy (kopia O(m * n^2), bez parsowania).
+// Po zmianie plan jest naprawiany (nowe zadanie na najlepszą pozycję, usunięte wycinane)
+// i krótko poprawiany Iterated Greedy od poprzedniego rozwiązania zamiast liczenia od zera.
+// Zadania mają stałe identyfikatory zewnętrzne; sloty wewnętrzne zmieniają się przy usuwaniu.
+// Obiekt nie jest bezpieczny wątkowo.
+class ReschedulingSession
+{
+public:
+    struct Settings
+    {
+        int iterations = 50;      // iteracje Iterated Greedy po każdej zmianie (0 = tylko naprawa)
+        int destroy = 4;          // zadania usuwane i wstawiane ponownie w iteracji
+        double temperature = 0.4; // współczynnik temperatury IG (Tp)
+        double timeLimit = 0.0;   // > 0 = poprawianie przez tyle sekund zamiast liczby iteracji
+        int seed = 1;
+    };
+
+    // Metryki jednej zmiany; czasy w ms
+    struct Update
+    {
+        std::string kind; // open / add / remove / reoptimize
+        int job = -1;     // identyfikator dodanego / usuniętego zadania
+        int jobs = 0;     // liczba zadań po zmianie
+        long long repairedMakespan = 0;
+        long long makespan = 0;
+        int iterations = 0;
+        double rebuildMs = 0.0;
+        double repairMs = 0.0;
+        double optimizeMs = 0.0;
+        double totalMs = 0.0;
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    int machines;
+    int jobs = 0;
+    int capacity = 0;
+    std::vector<int> ids;   // slot -> identyfikator
+    std::vector<int> proc;  // [slot][machine]
+    std::vector<int> setup; // [machine][prev][curr], stride capacity
+    Instance instance;
+    std::vector<int> sequence; // plan w slotach
+    Settings settings;
+    int nextId = 0;
+    long long updates = 0;
+    Update last;
+
+public:
+    // Start od wczytanej instancji (identyfikatory 0..n-1) i planu NEH + poprawianie
+    explicit ReschedulingSession(const Instance &source) : ReschedulingSession(source, Settings()) {}
+    ReschedulingSession(const Instance &source, const Settings &sessionSettings)
+        : machines(source.getMachines()), instance("session"), settings(sessionSettings)
+    {
+        int n = source.getJobs();
+        if (n < 1 || machines < 1)
+            throw std::invalid_argument("session needs a loaded instance");
+        instance.setStorageOptions(SetupLayout::PrevJobMajor, SetupEncoding::Narrowest);
+        reserve(n);
+        for (int j = 0; j < n; ++j)
+        {
+            ids.push_back(j);
+            for (int mach = 0; mach < machines; ++mach)
+                proc[(std::size_t)j * machines + mach] = source.getProcTime(j, mach);
+        }
+        for (int mach = 0; mach < machines; ++mach)
+            for (int prev = 0; prev < n; ++prev)
+                for (int curr = 0; curr < n; ++curr)
+                    setupAt(mach, prev, curr) = source.getSetupTime(mach, prev, curr);
+        jobs = n;
+        nextId = n;
+
+        auto start = Clock::now();
+        Update update = begin("open", -1);
+        rebuild(update, start);
+        NEHWithProgress neh(instance);
+        neh.setVerbose(false);
+        sequence = neh.solve().getJobSequence();
+        finishRepair(update, start);
+        optimize(update, start);
+    }
+
+    // Nowe zadanie: procRow - m czasów; setupIn[machine * n + k] = s(k -> nowe),
+    // setupOut[machine * n + k] = s(nowe -> k), k w kolejności getJobIds(). Zwraca identyfikator
+    int addJob(const std::vector<int> &procRow, const std::vector<int> &setupIn, const std::vector<int> &setupOut)
+    {
+        std::size_t cells = (std::size_t)machines * jobs;
+        if ((int)procRow.size() != machines || setupIn.size() != cells || setupOut.size() != cells)
+            throw std::invalid_argument("new job needs " + std::to_string(machines) + " processing times and " +
+                                        std::to_string(cells) + " setup times in each direction");
+        for (int v : procRow)
+            if (v < 0)
+                throw std::invalid_argument("processing times must be >= 0");
+        for (std::size_t i = 0; i < cells; ++i)
+            if (setupIn[i] < 0 || setupOut[i] < 0)
+                throw std::invalid_argument("setup times must be >= 0");
+
+        auto start = Clock::now();
+        int id = nextId++;
+        if (jobs == capacity)
+            reserve(std::max(2 * capacity, 16));
+        int slot = jobs++;
+        ids.push_back(id);
+        std::copy(procRow.begin(), procRow.end(), proc.begin() + (std::size_t)slot * machines);
+        for (int mach = 0; mach < machines; ++mach)
+        {
+            for (int k = 0; k < slot; ++k)
+            {
+                setupAt(mach, k, slot) = setupIn[(std::size_t)mach * slot + k];
+                setupAt(mach, slot, k) = setupOut[(std::size_t)mach * slot + k];
+            }
+            setupAt(mach, slot, slot) = 0;
+        }
+
+        Update update = begin("add", id);
+        rebuild(update, start);
+        // Naprawa: nowe zadanie na najlepszej pozycji bieżącego planu
+        long long cmax = 0;
+        int pos = BatchMakespan(instance).bestInsertion(sequence, slot, cmax);
+        sequence.insert(sequence.begin() + pos, slot);
+        finishRepair(update, start);
+        optimize(update, start);
+        return id;
+    }
+
+    // Usunięcie zadania (ostatni slot przenoszony na jego miejsce); false = nieznany identyfikator
+    bool removeJob(int id)
+    {
+        auto it = std::find(ids.begin(), ids.end(), id);
+        if (it == ids.end())
+            return false;
+        if (jobs == 1)
+            throw std::invalid_argument("cannot remove the last job");
+
+        auto start = Clock::now();
+        int slot = (int)(it - ids.begin());
+        int moved = jobs - 1;
+        if (slot != moved)
+        {
+            ids[slot] = ids[moved];
+            std::copy_n(proc.begin() + (std::size_t)moved * machines, machines, proc.begin() + (std::size_t)slot * machines);
+            // Najpierw wiersz, potem kolumna - s(moved, moved) trafia na przekątną
+            for (int mach = 0; mach < machines; ++mach)
+            {
+                std::copy_n(&setupAt(mach, moved, 0), jobs, &setupAt(mach, slot, 0));
+                for (int prev = 0; prev < jobs; ++prev)
+                    setupAt(mach, prev, slot) = setupAt(mach, prev, moved);
+            }
+        }
+        ids.pop_back();
+        --jobs;
+
+        Update update = begin("remove", id);
+        rebuild(update, start);
+        sequence.erase(std::find(sequence.begin(), sequence.end(), slot));
+        for (int &s : sequence)
+            if (s == moved)
+                s = slot;
+        finishRepair(update, start);
+        optimize(update, start);
+        return true;
+    }
+
+    // Dodatkowe poprawianie bieżącego planu (np. w czasie bezczynności)
+    const Update &reoptimize()
+    {
+        auto start = Clock::now();
+        Update update = begin("reoptimize", -1);
+        update.repairedMakespan = instance.makespanOf(sequence);
+        optimize(update, start);
+        return last;
+    }
+
+    void setSettings(const Settings &sessionSettings) { settings = sessionSettings; }
+    const Settings &getSettings() const { return settings; }
+
+    const Update &lastUpdate() const { return last; }
+    int getJobs() const { return jobs; }
+    int getMachines() const { return machines; }
+    long long getMakespan() const { return last.makespan; }
+    const Instance &getInstance() const { return instance; }
+
+    // Identyfikatory w kolejności slotów (kolejność danych przezbrojeń w addJob)
+    const std::vector<int> &getJobIds() const { return ids; }
+
+    // Plan jako identyfikatory zadań
+    std::vector<int> getSequence() const
+    {
+        std::vector<int> out(sequence.size());
+        for (std::size_t i = 0; i < sequence.size(); ++i)
+            out[i] = ids[sequence[i]];
+        return out;
+    }
+
+private:
+    int &setupAt(int machine, int prev, int curr)
+    {
+        return setup[((std::size_t)machine * capacity + prev) * capacity + curr];
+    }
+
+    // Większa pojemność: przepisanie danych głównych (amortyzowane przez podwajanie)
+    void reserve(int newCapacity)
+    {
+        std::vector<int> grown((std::size_t)machines * newCapacity * newCapacity, 0);
+        for (int mach = 0; mach < machines; ++mach)
+            for (int prev = 0; prev < jobs; ++prev)
+                std::copy_n(&setupAt(mach, prev, 0), jobs, grown.begin() + ((std::size_t)mach * newCapacity + prev) * newCapacity);
+        setup.swap(grown);
+        proc.resize((std::size_t)newCapacity * machines);
+        capacity = newCapacity;
+    }
+
+    Update begin(const char *kind, int job)
+    {
+        Update update;
+        update.kind = kind;
+        update.job = job;
+        return update;
+    }
+
+    static double msSince(Clock::time_point since) { return std::chrono::duration<double, std::milli>(Clock::now() - since).count(); }
+
+    void rebuild(Update &update, Clock::time_point start)
+    {
+        int stride = capacity;
+        instance.loadFromRows(jobs, machines, [&](int job) { return proc.data() + (std::size_t)job * machines; },
+                              [&](int machine, int prev) { return setup.data() + ((std::size_t)machine * stride + prev) * stride; });
+        update.rebuildMs = msSince(start);
+    }
+
+    void finishRepair(Update &update, Clock::time_point start)
+    {
+        update.repairedMakespan = instance.makespanOf(sequence);
+        update.repairMs = msSince(start) - update.rebuildMs;
+    }
+
+    // IG od naprawionego planu; zwraca najlepszy odwiedzony, więc nie pogarsza planu
+    void optimize(Update &update, Clock::time_point start)
+    {
+        auto optimizeStart = Clock::now();
+        update.makespan = update.repairedMakespan;
+        if (settings.iterations > 0 && jobs > 1)
+        {
+            IteratedGreedy greedy(instance, settings.seed + (int)(updates % 1000003));
+            greedy.setParameters(settings.iterations, settings.destroy, settings.temperature);
+            greedy.setLocalSearch(false); // przegląd całego sąsiedztwa O(n^2) - poza budżetem milisekund
+            greedy.setVerbose(false);
+            SolveBudget budget;
+            budget.timeLimit = settings.timeLimit;
+            budget.start();
+            greedy.setBudget(budget);
+            sequence = greedy.solve(Schedule(sequence)).getJobSequence();
+            update.makespan = instance.makespanOf(sequence);
+            update.iterations = greedy.getIteration();
+        }
+        update.optimizeMs = msSince(optimizeStart);
+        update.totalMs = msSince(start);
+        update.jobs = jobs;
+        ++updates;
+        last = update;
+    }
+};
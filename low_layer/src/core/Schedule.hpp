@@ -1,7 +1,9 @@
 #pragma once
 #include <vector>
+#include <string>
 #include <iostream>
 #include <algorithm>
+#include "Telemetry.hpp"
 class Instance;
 
 class Schedule
@@ -23,10 +25,22 @@ public:
 
     void print() const
     {
+        std::cout << toString() << std::endl;
+    }
+
+    // Sekwencja jako "j1 j2 ... " (format print())
+    std::string toString() const
+    {
+        std::string text;
         for (int j : jobSequence)
-            std::cout << j << " ";
-        std::cout << std::endl;
+            text += std::to_string(j) + " ";
+        return text;
     }
 
-    void emitFinalSlots(const class Instance &instance) const;
+    // Operacje harmonogramu w kolejności maszyna, pozycja
+    std::vector<SlotRecord> computeSlots(const class Instance &instance) const;
+
+    // Ramka dla GUI; final = false oznacza ramkę pośrednią (może zostać połączona z kolejną)
+    void emitSlots(const class Instance &instance, bool final) const;
+    void emitFinalSlots(const class Instance &instance) const { emitSlots(instance, true); }
 };
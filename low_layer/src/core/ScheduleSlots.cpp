@@ -1,58 +1,45 @@
 #include "Schedule.hpp"
 #include "Instance.hpp"
+#include "Profiler.hpp"
 #include <algorithm>
-#include <iostream>
 
-void Schedule::emitFinalSlots(const Instance &instance) const
+std::vector<SlotRecord> Schedule::computeSlots(const Instance &instance) const
 {
     const std::vector<int> &sequence = jobSequence;
+    std::vector<SlotRecord> slots;
     if (sequence.empty())
-        return;
+        return slots;
 
     int m = instance.getMachines();
     int n = (int)sequence.size();
+    slots.resize((size_t)n * m);
+
+    const ProcMatrix &proc = instance.getProcMatrix();
+    std::vector<long long> row(m, 0);
+
+    // Wspólne jądro makespanu; z wiersza zakończeń odtwarzamy start (koniec - czas operacji) i przezbrojenie
+    instance.visitKernel([&](const auto &setup, auto M) {
+        makespan_kernel::scheduleRows<decltype(M)::value>(setup, proc, sequence.data(), n, m, row.data(),
+                                                          [&](int idx, const long long *end) {
+            int job = sequence[idx];
+            const std::int32_t *p = proc.row(job);
+            for (int mach = 0; mach < m; ++mach) {
+                int setupTime = (idx == 0) ? 0 : setup(mach, sequence[idx - 1], job);
+                slots[(size_t)mach * n + idx] = {mach, job, end[mach] - p[mach], end[mach], setupTime};
+            }
+        });
+    });
+
+    return slots;
+}
+
+void Schedule::emitSlots(const Instance &instance, bool final) const
+{
+    if (jobSequence.empty())
+        return;
+    Profiler::Scope profile(Profiler::Phase::Slots);
 
-    struct OpRec {
-        int job;
-        long long start;
-        long long end;
-        int setup_used;
-    };
-
-    std::vector<std::vector<OpRec>> schedule(m);
-    std::vector<long long> machineTime(m, 0);
-
-    // Obliczanie harmonogramu (identyczne z Twoją logiką)
-    for (int idx = 0; idx < n; ++idx) {
-        int job = sequence[idx];
-        for (int mach = 0; mach < m; ++mach) {
-            long long readyByMachine = (mach == 0) ? 0 : machineTime[mach - 1];
-            long long readyBySequence = machineTime[mach];
-
-            int prevJob = (idx == 0) ? -1 : sequence[idx - 1];
-            int setupTime = (idx == 0 || prevJob == -1) ? 0 : instance.getSetupTime(mach, prevJob, job);
-
-            long long startTime = std::max(readyByMachine, readyBySequence + (long long)setupTime);
-            long long endTime = startTime + instance.getProcTime(job, mach);
-
-            machineTime[mach] = endTime;
-            schedule[mach].push_back({job, startTime, endTime, setupTime});
-        }
-    }
-
-    // Wypisywanie danych w formacie zrozumiałym dla GUI
-    // Używamy iter=0 dla wyniku końcowego
-    for (int mIdx = 0; mIdx < (int)schedule.size(); ++mIdx) {
-        for (const auto &op : schedule[mIdx]) {
-            std::cout << "SLOT;iter=0;machine=" << mIdx
-                      << ";job=" << op.job
-                      << ";start=" << op.start
-                      << ";end=" << op.end
-                      << ";setup=" << op.setup_used << std::endl;
-        }
-    }
-    
-    // Kluczowy sygnał zakończenia ramki danych
-    std::cout << "FRAME_END;iter=0" << std::endl;
-    std::cout.flush(); // Wymuszenie wysłania danych do Pythona
-}
\ No newline at end of file
+    // Wypisywanie danych w formacie zrozumiałym dla GUI (iter=0, zakończone FRAME_END)
+    // przez wątek telemetrii - bez flush po każdej linii
+    Telemetry::get().frame(computeSlots(instance), final);
+}
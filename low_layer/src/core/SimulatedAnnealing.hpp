@@ -3,23 +3,81 @@
 #include <random>
 #include <cmath>
 #include <algorithm>
+#include <array>
 #include <iostream>
+#include <chrono>
+#include <climits>
+#include <limits>
+#include <string>
 #include "Instance.hpp"
 #include "Schedule.hpp"
+#include "IncrementalMakespan.hpp"
+#include "BatchMakespan.hpp"
+#include "SolutionCache.hpp"
+#include "Telemetry.hpp"
+#include "SolveBudget.hpp"
+#include "Profiler.hpp"
+#include "FastRandom.hpp"
+#include "AnnealingSchedule.hpp"
 
 class SimulatedAnnealing
 {
 private:
     const Instance &instance;
-    std::mt19937 rng;
+    Xoshiro256 rng;
+    IncrementalMakespan evaluator;
+
+    // Ruch "najlepszy z K": K losowych zamian ocenianych razem (BatchMakespan), kryterium
+    // Metropolisa dla najlepszej z nich; K = 1 to zwykły pojedynczy ruch
+    int moveBatch = 1;
+    BatchMakespan batch;
+    std::vector<std::pair<int, int>> moves;
+    std::vector<int> candidates;
+    std::vector<long long> candidateCmax;
+
+    // Odwiedzone rozwiązania (tylko ruch pojedynczy); hash bieżącej sekwencji aktualizowany przy każdej zamianie
+    SolutionCache *cache = nullptr;
+    std::uint64_t seqHash = 0;
+    SolutionCache::Counters cacheCounters;
 
     int maxIterations;
     double initialTemperature;
     double coolingFactor;
+    AnnealingSchedule schedule;
+    bool verbose = true;
+
+    // Stan łańcucha - pozwala prowadzić obliczenia odcinkami (wyspy w ParallelAnnealing)
+    int iteration = 0;
+    double invTemperature = 0.0; // 1/T - test akceptacji i Lundy-Mees bez dzielenia
+    // Zmienne wykładnicze E = -log(u): ruch pod górę przyjęty, gdy delta/T < E (p = exp(-delta/T)).
+    // Zużyte odnawiane co 256 iteracji razem z kontrolą budżetu - w pętli nie ma exp ani log
+    std::array<double, 256> exponentials{};
+    int exponentialsUsed = 256;
+    double currentCmax = 0.0;
+    double bestCmax = 0.0;
+    std::vector<int> bestSeq;
+    std::vector<SlotRecord> frameSlots; // bufor ramek pośrednich (bieżąca = najlepsza sekwencja)
+
+    // Temperatura spada odcinkami od segmentTemperature do endTemperature (pierwszy odcinek od T0,
+    // kolejne od podgrzania). Bez limitu czasu odcinek kończy się z ostatnią iteracją, a krok
+    // (mnożnik albo beta) liczony jest raz; przy limicie czasu liczba iteracji nie jest ograniczeniem,
+    // a temperatura jest funkcją czasu do końca budżetu (przeliczana co 256 iteracji)
+    SolveBudget budget;
+    bool timeSchedule = false;
+    std::chrono::steady_clock::time_point segmentTime;
+    double startTemperature = 0.0;
+    double endTemperature = 0.0;
+    double segmentTemperature = 0.0;
+    double coolingStep = 1.0; // Geometric: mnożnik 1/T; LundyMees: przyrost 1/T
+    int lastImprovement = 0;
+    int lastReheat = 0;
+    int reheats = 0;
+    bool stopped = false;
+    std::string stopReason;
 
 public:
     SimulatedAnnealing(const Instance &inst, int seed = 0)
-        : instance(inst), rng(seed)
+        : instance(inst), rng((std::uint64_t)seed), evaluator(inst), batch(inst)
     {
         // Wartości domyślne
         maxIterations = 50000;
@@ -35,13 +93,155 @@ public:
         coolingFactor = cooling;
     }
 
+    // Domyślnie ruchy oceniane przyrostowo; false = pełny computeMakespan (do porównań)
+    void setIncremental(bool incremental)
+    {
+        evaluator.setFullRecompute(!incremental);
+    }
+
+    // Kształt chłodzenia, kalibracja temperatur i podgrzewanie
+    void setSchedule(const AnnealingSchedule &annealingSchedule) { schedule = annealingSchedule; }
+
+    // Liczba kandydatów ocenianych na iterację (>= 1)
+    void setMoveBatch(int k) { moveBatch = std::max(1, k); }
+
+    // Makespany odwiedzonych sekwencji sprawdzane przed oceną ruchu; nullptr = wyłączone.
+    // Cache może być współdzielony przez łańcuchy działające równolegle
+    void setSolutionCache(SolutionCache *solutionCache) { cache = solutionCache; }
+    const SolutionCache::Counters &getCacheCounters() const { return cacheCounters; }
+
+    // false = brak linii RESULT/SLOT (łańcuchy uruchamiane równolegle)
+    void setVerbose(bool enabled) { verbose = enabled; }
+
+    // Limit czasu / docelowy makespan / stagnacja; sprawdzane co 256 iteracji (cel - przy każdej poprawie)
+    void setBudget(const SolveBudget &solveBudget) { budget = solveBudget; }
+
+    // Powód wcześniejszego zakończenia ("" = wykonano wszystkie iteracje)
+    const std::string &getStopReason() const { return stopReason; }
+
     Schedule solve(const Schedule &initialSolution = Schedule())
     {
         auto currentSeq = makeStartSequence(initialSolution);
         // Przekazanie zmiennych do głównej pętli algorytmu
-        return runSAFromSeq(currentSeq, maxIterations, initialTemperature, coolingFactor, "SIMULATED_ANNEALING");
+        return runSAFromSeq(currentSeq, "SIMULATED_ANNEALING");
+    }
+
+    // Sterowanie odcinkami: begin() raz, potem advance() aż do finished()
+    void begin(const Schedule &initialSolution = Schedule())
+    {
+        start(makeStartSequence(initialSolution));
+    }
+
+    // Wykonuje co najwyżej steps iteracji; zwraca true, gdy łańcuch się zakończył
+    bool advance(int steps)
+    {
+        std::uint32_t n = (std::uint32_t)instance.getJobs();
+        int limit = timeSchedule ? INT_MAX : maxIterations;
+        int stop = (int)std::min<long long>((long long)iteration + steps, limit);
+        Profiler::Scope profile(Profiler::Phase::Annealing);
+        long long accepted = 0, evaluated = 0; // liczniki profilu odcinka (lokalne - bez atomików w pętli)
+        int first = iteration;
+
+        for (; iteration < stop; iteration++)
+        {
+            if (stopped)
+                break;
+            if ((iteration & 255) == 0) {
+                if (shouldStop())
+                    break;
+                refillExponentials();
+            }
+            int pos1, pos2;
+            double newCmax;
+            bool cached = false; // makespan z cache - ruch nie był wykonany w ewaluatorze
+            std::uint64_t newHash = 0;
+            if (moveBatch > 1) {
+                newCmax = sampleBestMove(pos1, pos2);
+                evaluated += moveBatch;
+            } else {
+                pos1 = (int)rng.below(n);
+                pos2 = (int)rng.below(n);
+                long long known = 0;
+                if (cache) {
+                    newHash = SolutionCache::swapped(seqHash, evaluator.getSequence(), pos1, pos2);
+                    ++cacheCounters.lookups;
+                    cached = cache->lookup(newHash, known);
+                    cacheCounters.hits += cached ? 1 : 0;
+                }
+                if (cached) {
+                    newCmax = (double)known;
+                } else {
+                    // Przeliczane są tylko pozycje między pos1 i pos2
+                    newCmax = (double)evaluator.trySwap(pos1, pos2);
+                    ++evaluated;
+                    if (cache)
+                        cache->store(newHash, (long long)newCmax);
+                }
+            }
+            bool accept = acceptMove(newCmax - currentCmax);
+
+            if (accept) {
+                ++accepted;
+                if (moveBatch > 1 || cached)
+                    evaluator.applySwap(pos1, pos2, (long long)newCmax);
+                else
+                    evaluator.accept();
+                if (cache && moveBatch == 1)
+                    seqHash = newHash;
+                // Wartość z cache (możliwa kolizja hashy) weryfikowana przed zapisaniem nowego najlepszego
+                if (cached && newCmax < bestCmax)
+                    newCmax = verifiedMakespan((long long)newCmax);
+                currentCmax = newCmax;
+                if (newCmax < bestCmax) {
+                    bestCmax = newCmax;
+                    bestSeq = evaluator.getSequence();
+                    lastImprovement = iteration;
+                    if (budget.targetReached(bestCmax))
+                        stopWith(budget.targetReason(bestCmax));
+                    // Informacja dla GUI o poprawie wyniku
+                    if (verbose) {
+                        Telemetry::get().result(iteration, bestCmax, bestSeq);
+                        // Ramka pośrednia tylko, gdy telemetria jej nie odrzuci
+                        if (iteration % 500 == 0 && Telemetry::get().wantsFrame()) {
+                            evaluator.buildSlots(frameSlots);
+                            Telemetry::get().frame(frameSlots, false);
+                        }
+                    }
+                }
+            } else if (moveBatch == 1 && !cached) {
+                evaluator.undo();
+            }
+            if (!timeSchedule)
+                invTemperature = (schedule.cooling == CoolingSchedule::Geometric) ? invTemperature * coolingStep
+                                                                                  : invTemperature + coolingStep;
+        }
+        profile.addEvaluations(evaluated);
+        Profiler::get().addAnnealingMoves(accepted, iteration - first - accepted);
+        return finished();
+    }
+
+    // Migracja: bieżące rozwiązanie zastępowane przybyszem, temperatura bez zmian
+    void adoptSolution(const std::vector<int> &seq)
+    {
+        evaluator.reset(seq);
+        seqHash = cache ? SolutionCache::hashOf(seq) : 0;
+        currentCmax = (double)evaluator.getMakespan();
+        if (currentCmax < bestCmax) {
+            bestCmax = currentCmax;
+            bestSeq = seq;
+        }
     }
 
+    bool finished() const { return stopped || (!timeSchedule && iteration >= maxIterations); }
+    int getIteration() const { return iteration; }
+    double getTemperature() const { return 1.0 / invTemperature; }
+    double getStartTemperature() const { return startTemperature; }
+    double getEndTemperature() const { return endTemperature; }
+    int getReheats() const { return reheats; }
+    double getCurrentMakespan() const { return currentCmax; }
+    double getBestMakespan() const { return bestCmax; }
+    const std::vector<int> &getBestSequence() const { return bestSeq; }
+
 private:
     std::vector<int> makeStartSequence(const Schedule &initialSolution)
     {
@@ -55,47 +255,212 @@ private:
         return initialSolution.getJobSequence();
     }
 
-    Schedule runSAFromSeq(std::vector<int> startSeq, int iterations, double initTemp, double cooling, const std::string &prefix)
+    // Najlepsza z moveBatch losowych zamian bieżącej sekwencji (pierwsza przy remisie)
+    double sampleBestMove(int &pos1, int &pos2)
     {
-        int n = instance.getJobs();
-        double currentCmax = instance.computeMakespan(startSeq);
-        std::vector<int> bestSeq = startSeq;
-        double bestCmax = currentCmax;
+        const std::vector<int> &seq = evaluator.getSequence();
+        int n = (int)seq.size();
+        moves.resize(moveBatch);
+        candidates.resize((size_t)moveBatch * n);
+        candidateCmax.resize(moveBatch);
+        for (int c = 0; c < moveBatch; ++c) {
+            int a = (int)rng.below((std::uint32_t)n);
+            int b = (int)rng.below((std::uint32_t)n);
+            moves[c] = {a, b};
+            int *candidate = candidates.data() + (size_t)c * n;
+            std::copy(seq.begin(), seq.end(), candidate);
+            std::swap(candidate[a], candidate[b]);
+        }
+        batch.evaluate(candidates.data(), moveBatch, n, candidateCmax.data());
+        int best = (int)(std::min_element(candidateCmax.begin(), candidateCmax.end()) - candidateCmax.begin());
+        pos1 = moves[best].first;
+        pos2 = moves[best].second;
+        return (double)candidateCmax[best];
+    }
+
+    void start(const std::vector<int> &startSeq)
+    {
+        evaluator.reset(startSeq);
+        seqHash = cache ? SolutionCache::hashOf(startSeq) : 0;
+        cacheCounters = SolutionCache::Counters();
+        currentCmax = (double)evaluator.getMakespan();
+        bestSeq = startSeq;
+        bestCmax = currentCmax;
+        iteration = 0;
 
-        double temperature = initTemp;
-        std::uniform_int_distribution<int> jobDist(0, n - 1);
-        std::uniform_real_distribution<double> probDist(0.0, 1.0);
+        lastImprovement = 0;
+        lastReheat = 0;
+        reheats = 0;
+        stopped = false;
+        stopReason.clear();
+        timeSchedule = budget.hasTimeLimit();
+        startTemperature = initialTemperature;
+        endTemperature = std::max(initialTemperature * std::pow(coolingFactor, (double)maxIterations), 1e-300);
+        exponentialsUsed = (int)exponentials.size();
+        if (schedule.calibrate)
+            calibrate();
+        else
+            limitCooling();
+        beginSegment(startTemperature);
+        if (budget.targetReached(bestCmax))
+            stopWith(budget.targetReason(bestCmax));
+    }
 
-        std::cout << prefix << " started. Initial makespan: " << currentCmax << std::endl;
+    // Metropolis na 1/T: delta <= 0 zawsze, pod górę porównanie z gotową zmienną wykładniczą.
+    // Najwyżej jedna na iterację; maska chroni bufor, gdy advance() zaczyna się poza granicą 256 iteracji
+    bool acceptMove(double delta)
+    {
+        if (delta <= 0)
+            return true;
+        return delta * invTemperature < exponentials[exponentialsUsed++ & 255];
+    }
 
-        for (int iteration = 0; iteration < iterations; iteration++)
+    void refillExponentials()
+    {
+        int used = std::min(exponentialsUsed, (int)exponentials.size());
+        for (int i = 0; i < used; ++i)
+            exponentials[i] = -std::log1p(-rng.unit()); // 1 - u z (0, 1] - bez log(0)
+        exponentialsUsed = 0;
+    }
+
+    // Próbka losowych zamian bieżącej sekwencji: liczba ruchów pod górę, ich suma i najmniejszy
+    int sampleUphill(double &sum, double &smallest)
+    {
+        std::uint32_t n = (std::uint32_t)instance.getJobs();
+        long long current = evaluator.getMakespan();
+        sum = 0.0;
+        smallest = 0.0;
+        int uphill = 0;
+        for (int sample = 0; sample < 256 && n > 1; ++sample)
         {
-            int pos1 = jobDist(rng);
-            int pos2 = jobDist(rng);
-            std::swap(startSeq[pos1], startSeq[pos2]);
+            long long delta = evaluator.trySwap((int)rng.below(n), (int)rng.below(n)) - current;
+            evaluator.undo();
+            if (delta <= 0)
+                continue;
+            sum += (double)delta;
+            smallest = uphill ? std::min(smallest, (double)delta) : (double)delta;
+            ++uphill;
+        }
+        return uphill;
+    }
 
-            double newCmax = instance.computeMakespan(startSeq);
-            double delta = newCmax - currentCmax;
+    // Temperatury z próbki: T0 przyjmuje średni ruch pod górę z p = 0.5, temperatura końcowa najmniejszy z p = 0.01
+    void calibrate()
+    {
+        double sum, smallest;
+        int uphill = sampleUphill(sum, smallest);
+        if (!uphill)
+            return; // płaski krajobraz - zostają parametry podane
+        startTemperature = (sum / uphill) / std::log(2.0);
+        endTemperature = std::min(smallest / std::log(100.0), startTemperature * 0.01);
+    }
 
-            bool accept = (delta < 0) || (probDist(rng) < std::exp(-delta / temperature));
+    // Podane T0 i alfa przycięte do zakresu, w którym łańcuch coś robi: powyżej temperatury
+    // kalibracji (średni ruch pod górę z p = 0.5) to błądzenie losowe, poniżej tej, w której najmniejszy
+    // ma p = 0.01 - zamrożenie. beginSegment rozkłada chłodzenie między nimi na cały budżet
+    void limitCooling()
+    {
+        double sum, smallest;
+        int uphill = (startTemperature > 0.0) ? sampleUphill(sum, smallest) : 0;
+        if (!uphill)
+            return;
+        startTemperature = std::min(startTemperature, (sum / uphill) / std::log(2.0));
+        endTemperature = std::min(startTemperature, std::max(endTemperature, smallest / std::log(100.0)));
+    }
 
-            if (accept) {
-                currentCmax = newCmax;
-                if (newCmax < bestCmax) {
-                    bestCmax = newCmax;
-                    bestSeq = startSeq;
-                    // Informacja dla GUI o poprawie wyniku
-                    std::cout << "RESULT;iter=" << iteration << ";cmax=" << bestCmax << std::endl;
-                    if (iteration % 500 == 0) Schedule(bestSeq).emitFinalSlots(instance);
-                }
-            } else {
-                std::swap(startSeq[pos1], startSeq[pos2]);
+    // Nowy odcinek chłodzenia od temperatury t do endTemperature (w pozostałych iteracjach albo czasie)
+    void beginSegment(double t)
+    {
+        segmentTemperature = t;
+        segmentTime = std::chrono::steady_clock::now();
+        if (!(t > 0.0))
+        {
+            // T0 = 0: czysty spadek (akceptowane tylko ruchy nie pogarszające)
+            invTemperature = std::numeric_limits<double>::infinity();
+            coolingStep = (schedule.cooling == CoolingSchedule::Geometric) ? 1.0 : 0.0;
+            return;
+        }
+        invTemperature = 1.0 / t;
+        double steps = (double)std::max(1, maxIterations - iteration);
+        if (schedule.cooling == CoolingSchedule::Geometric)
+            coolingStep = std::pow(t / endTemperature, 1.0 / steps);
+        else
+            coolingStep = (1.0 / endTemperature - 1.0 / t) / steps;
+    }
+
+    // Podgrzanie do średniej geometrycznej bieżącej temperatury i T0 (geometrycznie: połowa drogi wstecz)
+    void reheat()
+    {
+        lastReheat = iteration;
+        ++reheats;
+        beginSegment(std::sqrt(getTemperature() * startTemperature));
+    }
+
+    // Pełne przeliczenie bieżącej sekwencji; przy niezgodności ewaluator budowany od nowa
+    double verifiedMakespan(long long claimed)
+    {
+        long long actual = instance.makespanOf(evaluator.getSequence());
+        if (actual != claimed)
+            evaluator.reset(std::vector<int>(evaluator.getSequence()));
+        return (double)actual;
+    }
+
+    bool stopWith(const char *reason)
+    {
+        stopped = true;
+        stopReason = reason;
+        return true;
+    }
+
+    bool shouldStop()
+    {
+        if (Cancellation::requested())
+            return stopWith("cancelled");
+        if (budget.stagnationLimit > 0 && iteration - lastImprovement >= budget.stagnationLimit)
+            return stopWith("stagnation limit");
+        if (schedule.reheatInterval > 0 && iteration - std::max(lastImprovement, lastReheat) >= schedule.reheatInterval)
+            reheat();
+        if (budget.hasTimeLimit())
+        {
+            auto now = std::chrono::steady_clock::now();
+            if (budget.timeUp(now))
+                return stopWith("time limit");
+            if (timeSchedule && segmentTemperature > 0.0)
+            {
+                double span = std::chrono::duration<double>(budget.deadline() - segmentTime).count();
+                double progress = std::min(1.0, std::chrono::duration<double>(now - segmentTime).count() / std::max(span, 1e-9));
+                if (schedule.cooling == CoolingSchedule::Geometric)
+                    invTemperature = 1.0 / (segmentTemperature * std::pow(endTemperature / segmentTemperature, progress));
+                else
+                    invTemperature = 1.0 / segmentTemperature + (1.0 / endTemperature - 1.0 / segmentTemperature) * progress;
             }
-            temperature *= cooling;
         }
+        return false;
+    }
 
-        std::cout << prefix << " finished. Final best makespan: " << bestCmax << std::endl;
-        Schedule(bestSeq).emitFinalSlots(instance); // Końcowe odświeżenie wykresu
+    Schedule runSAFromSeq(const std::vector<int> &startSeq, const std::string &prefix)
+    {
+        start(startSeq);
+
+        if (verbose) {
+            LogLine() << prefix << " started. Initial makespan: " << currentCmax;
+            LogLine() << prefix << (schedule.calibrate ? " calibrated" : "") << " temperature: start " << startTemperature
+                      << ", end " << endTemperature;
+        }
+
+        advance(timeSchedule ? INT_MAX : maxIterations);
+
+        if (verbose) {
+            if (stopped)
+                LogLine() << prefix << " stopped (" << stopReason << ") after " << iteration << " iterations";
+            if (schedule.reheatInterval > 0)
+                LogLine() << prefix << " reheats: " << reheats;
+            if (cache)
+                LogLine() << prefix << " cache: " << cacheCounters.lookups << " lookups, " << cacheCounters.hits
+                          << " hits (" << cacheCounters.hitRate() << "%)";
+            LogLine() << prefix << " finished. Final best makespan: " << bestCmax;
+            Schedule(bestSeq).emitFinalSlots(instance); // Końcowe odświeżenie wykresu
+        }
         
         return Schedule(bestSeq);
     }
@@ -0,0 +1,95 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Pamięć odwiedzonych rozwiązań SA: sekwencja -> makespan, adresowana haszem Zobrista.
+// Hash sekwencji to XOR kluczy (pozycja, zadanie), więc zamiana dwóch pozycji zmienia go
+// w O(1) (cztery klucze). Klucze wyliczane są funkcją mieszającą (splitmix64) zamiast tablicy n x n.
+// Tablica o stałym rozmiarze 2^k, bez kubełków: nowy wpis nadpisuje stary. Bez blokad - słowo
+// kontrolne to hash XOR wartość, więc rozerwany zapis z innego wątku wygląda jak chybienie
+// (łańcuchy ParallelAnnealing mogą współdzielić jeden cache).
+class SolutionCache
+{
+public:
+    struct Counters
+    {
+        long long lookups = 0;
+        long long hits = 0;
+
+        double hitRate() const { return lookups > 0 ? 100.0 * (double)hits / (double)lookups : 0.0; }
+        Counters &operator+=(const Counters &other)
+        {
+            lookups += other.lookups;
+            hits += other.hits;
+            return *this;
+        }
+    };
+
+private:
+    struct Slot
+    {
+        std::atomic<std::uint64_t> check{0}; // hash ^ value; 0 = pusty
+        std::atomic<std::uint64_t> value{0};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::uint64_t mask = 0;
+
+public:
+    // Pojemność zaokrąglana w górę do potęgi dwójki (16 B na wpis)
+    explicit SolutionCache(std::size_t entries)
+    {
+        std::size_t size = 1;
+        while (size < entries)
+            size <<= 1;
+        slots = std::make_unique<Slot[]>(size);
+        mask = size - 1;
+    }
+
+    std::size_t capacity() const { return (std::size_t)mask + 1; }
+
+    // Klucz Zobrista zadania job na pozycji pos
+    static std::uint64_t key(int pos, int job)
+    {
+        std::uint64_t x = ((std::uint64_t)(std::uint32_t)pos << 32 | (std::uint32_t)job) + 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    static std::uint64_t hashOf(const std::vector<int> &seq)
+    {
+        std::uint64_t h = 0;
+        for (int i = 0; i < (int)seq.size(); ++i)
+            h ^= key(i, seq[i]);
+        return h;
+    }
+
+    // Hash sekwencji po zamianie pozycji pos1 i pos2 (seq - przed zamianą)
+    static std::uint64_t swapped(std::uint64_t h, const std::vector<int> &seq, int pos1, int pos2)
+    {
+        if (pos1 == pos2)
+            return h;
+        return h ^ key(pos1, seq[pos1]) ^ key(pos2, seq[pos2]) ^ key(pos1, seq[pos2]) ^ key(pos2, seq[pos1]);
+    }
+
+    bool lookup(std::uint64_t hash, long long &makespan) const
+    {
+        const Slot &slot = slots[hash & mask];
+        std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+        std::uint64_t value = slot.value.load(std::memory_order_relaxed);
+        if (check == 0 || (check ^ value) != hash)
+            return false;
+        makespan = (long long)value;
+        return true;
+    }
+
+    void store(std::uint64_t hash, long long makespan)
+    {
+        Slot &slot = slots[hash & mask];
+        slot.value.store((std::uint64_t)makespan, std::memory_order_relaxed);
+        slot.check.store(hash ^ (std::uint64_t)makespan, std::memory_order_relaxed);
+    }
+};
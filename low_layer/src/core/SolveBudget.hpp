@@ -0,0 +1,124 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+// Przerwanie obliczeń na żądanie: SIGINT/SIGTERM albo komenda "stop" na stdin (cały proces)
+// oraz flaga zlecenia przypięta do wątku przez CancellationScope (jedno zlecenie serwera).
+// Solvery tylko odczytują flagę i kończą pracę z dotychczas najlepszym rozwiązaniem.
+class Cancellation
+{
+private:
+    static std::atomic<bool> &flag()
+    {
+        static std::atomic<bool> requested{false};
+        return requested;
+    }
+
+    static void onSignal(int sig)
+    {
+        flag().store(true, std::memory_order_relaxed);
+        // Drugi sygnał kończy proces od razu
+        std::signal(sig, SIG_DFL);
+    }
+
+public:
+    // Flaga zlecenia ustawiona dla bieżącego wątku (tryb serwera: przerwanie jednego zlecenia)
+    static const std::atomic<bool> *&scoped()
+    {
+        static thread_local const std::atomic<bool> *token = nullptr;
+        return token;
+    }
+
+    static void request() { flag().store(true, std::memory_order_relaxed); }
+    static bool requested()
+    {
+        const std::atomic<bool> *token = scoped();
+        return flag().load(std::memory_order_relaxed) || (token && token->load(std::memory_order_relaxed));
+    }
+    static void reset() { flag().store(false, std::memory_order_relaxed); }
+
+    static void installSignalHandlers()
+    {
+        static_assert(std::atomic<bool>::is_always_lock_free, "flag must be usable from a signal handler");
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+    }
+
+    // Wątek czytający stdin: linia "stop" (albo "cancel"/"quit") przerywa obliczenia
+    static void listenOnStdin()
+    {
+        std::thread([]
+                    {
+                        std::string line;
+                        char c;
+                        while (::read(STDIN_FILENO, &c, 1) == 1)
+                        {
+                            if (c != '\n')
+                            {
+                                line += c;
+                                continue;
+                            }
+                            if (!line.empty() && line.back() == '\r')
+                                line.pop_back();
+                            if (line == "stop" || line == "cancel" || line == "quit")
+                            {
+                                request();
+                                return;
+                            }
+                            line.clear();
+                        } })
+            .detach();
+    }
+};
+
+// Przypina flagę przerwania zlecenia do bieżącego wątku na czas życia obiektu
+class CancellationScope
+{
+private:
+    const std::atomic<bool> *saved;
+
+public:
+    explicit CancellationScope(const std::atomic<bool> &token) : saved(Cancellation::scoped()) { Cancellation::scoped() = &token; }
+    CancellationScope(const CancellationScope &) = delete;
+    ~CancellationScope() { Cancellation::scoped() = saved; }
+};
+
+// Budżet przebiegu solvera: limit czasu (od start()), docelowy makespan i limit stagnacji
+// (iteracje SA bez poprawy najlepszego wyniku). Wartości 0 oznaczają brak limitu.
+// Makespan równy dolnemu ograniczeniu (LowerBound) jest optymalny - też kończy obliczenia.
+// Przerwanie przez Cancellation jest sprawdzane zawsze.
+struct SolveBudget
+{
+    using Clock = std::chrono::steady_clock;
+
+    double timeLimit = 0.0;        // [s]
+    long long targetMakespan = 0;  // zatrzymanie po osiągnięciu Cmax <= target
+    long long stagnationLimit = 0; // [iteracje]
+    long long lowerBound = 0;      // dolne ograniczenie instancji (0 = nieznane)
+    Clock::time_point startTime = Clock::now();
+
+    void start() { startTime = Clock::now(); }
+
+    bool hasTimeLimit() const { return timeLimit > 0.0; }
+    bool active() const { return hasTimeLimit() || targetMakespan > 0 || stagnationLimit > 0; }
+
+    Clock::time_point deadline() const
+    {
+        return startTime + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(timeLimit));
+    }
+
+    bool timeUp(Clock::time_point now = Clock::now()) const { return hasTimeLimit() && now >= deadline(); }
+    bool targetReached(double makespan) const { return targetMakespanReached(makespan) || lowerBoundReached(makespan); }
+    bool lowerBoundReached(double makespan) const { return lowerBound > 0 && makespan <= (double)lowerBound; }
+    bool targetMakespanReached(double makespan) const { return targetMakespan > 0 && makespan <= (double)targetMakespan; }
+
+    // Powód zatrzymania po targetReached()
+    const char *targetReason(double makespan) const
+    {
+        return lowerBoundReached(makespan) ? "lower bound reached - optimal" : "target makespan reached";
+    }
+};
@@ -0,0 +1,85 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include "Instance.hpp"
+
+// Akceleracja Taillarda dla wstawiania zadania, rozszerzona o przezbrojenia zależne od kolejności.
+// head[i][k] - zakończenie i-tego zadania na maszynie k (od początku harmonogramu),
+// tail[i][k] - najdłuższa ścieżka od startu i-tego zadania na maszynie k do końca.
+// Dla wstawienia zadania j między a = seq[pos-1] i b = seq[pos]:
+//   f[k]  = p[j][k] + max(f[k-1], head[pos-1][k] + s_k(a, j))
+//   Cmax  = max_k (f[k] + s_k(j, b) + tail[pos][k])
+// Wszystkie L+1 pozycji oceniamy w jednym przebiegu O(L*m) zamiast O(L^2*m).
+// Ścieżka skalarna BatchMakespan::bestInsertion (bez SIMD albo gdy makespan nie mieści się w int32)
+// i wersja odniesienia dla torów wektorowych; NEH woła ją przez BatchMakespan.
+class TaillardInsertion
+{
+private:
+    const Instance &instance;
+    std::vector<long long> head;
+    std::vector<long long> tail;
+    std::vector<long long> front;
+
+public:
+    explicit TaillardInsertion(const Instance &inst) : instance(inst) {}
+
+    // Zwraca pierwszą pozycję o minimalnym makespanie - to samo rozstrzyganie remisów
+    // co przy pełnym przeliczaniu każdej kopii sekwencji
+    int bestPosition(const std::vector<int> &seq, int job, long long &bestMakespan)
+    {
+        return instance.visitKernel([&](const auto &setup, auto M)
+                                    { return bestPositionWith<decltype(M)::value>(setup, seq, job, bestMakespan); });
+    }
+
+private:
+    template <int M, typename SetupAccess>
+    int bestPositionWith(const SetupAccess &setup, const std::vector<int> &seq, int job, long long &bestMakespan)
+    {
+        using namespace makespan_kernel;
+        const ProcMatrix &proc = instance.getProcMatrix();
+        int m = instance.getMachines();
+        int L = (int)seq.size();
+
+        head.resize((std::size_t)L * m);
+        tail.resize((std::size_t)L * m);
+        front.resize(m);
+
+        // Głowy: zwykła rekurencja w przód
+        for (int i = 0; i < L; ++i)
+        {
+            long long *row = head.data() + (std::size_t)i * m;
+            forwardRow<M>(setup, proc.row(seq[i]), m, (i > 0) ? seq[i - 1] : -1, seq[i], (i > 0) ? row - m : nullptr, row);
+        }
+
+        // Ogony: ta sama rekurencja od końca (przezbrojenie do następnika)
+        for (int i = L - 1; i >= 0; --i)
+        {
+            long long *row = tail.data() + (std::size_t)i * m;
+            bool last = (i == L - 1);
+            backwardRow<M>(setup, proc.row(seq[i]), m, seq[i], last ? -1 : seq[i + 1], last ? nullptr : row + m, row);
+        }
+
+        const std::int32_t *pj = proc.row(job);
+        int bestPos = 0;
+        bestMakespan = -1;
+
+        for (int pos = 0; pos <= L; ++pos)
+        {
+            const long long *prevHead = (pos > 0) ? head.data() + (std::size_t)(pos - 1) * m : nullptr;
+            forwardRow<M>(setup, pj, m, (pos > 0) ? seq[pos - 1] : -1, job, prevHead, front.data());
+
+            long long makespan = front[m - 1];
+            if (pos < L)
+                makespan = std::max(makespan, joinTail<M>(setup, m, job, seq[pos], front.data(),
+                                                          tail.data() + (std::size_t)pos * m));
+
+            if (bestMakespan < 0 || makespan < bestMakespan)
+            {
+                bestMakespan = makespan;
+                bestPos = pos;
+            }
+        }
+        return bestPos;
+    }
+};
@@ -0,0 +1,452 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FrameEncoder.hpp"
+
+// Odbiorca zdarzeń jednego zlecenia (tryb serwera). Zdarzenia z wątku, do którego przypięto
+// odbiorcę (TelemetryRoute), omijają wspólną kolejkę i stdout: trafiają od razu do write(),
+// zawsze jako JSON (jedna linia na zdarzenie). Ramki mają własny stan różnicowy i limit częstości.
+class TelemetrySink
+{
+private:
+    using Clock = std::chrono::steady_clock;
+
+    bool framesEnabled = true;
+    std::chrono::milliseconds frameInterval{0};
+    Clock::time_point lastFrame{};
+    FrameEncoder frames;
+
+public:
+    virtual ~TelemetrySink() = default;
+
+    // Linia JSON zakończona '\n'; wywoływana z wątku solvera
+    virtual void write(const std::string &line) = 0;
+
+    // Poprawa wyniku (zdarzenie RESULT) przed zakodowaniem - np. wspólne rozwiązanie portfolio.
+    // sequence - najlepsza sekwencja solvera (ważna tylko w trakcie wywołania) albo nullptr
+    virtual void improved(long long iter, double cmax, const std::vector<int> *sequence) {}
+
+    void configureFrames(bool enabled, int frameIntervalMs, int keyframeInterval)
+    {
+        framesEnabled = enabled;
+        frameInterval = std::chrono::milliseconds(frameIntervalMs > 0 ? frameIntervalMs : 0);
+        frames.setKeyframeInterval(keyframeInterval);
+    }
+
+    bool frameDue() const { return framesEnabled && Clock::now() - lastFrame >= frameInterval; }
+
+    // Ramki końcowe przechodzą zawsze (o ile ramki są włączone), pośrednie - po frameInterval
+    bool acceptFrame(bool final)
+    {
+        if (!framesEnabled || (!final && !frameDue()))
+            return false;
+        lastFrame = Clock::now();
+        return true;
+    }
+
+    FrameEncoder &encoder() { return frames; }
+};
+
+// Strumień zdarzeń solvera (postęp, wyniki, ramki harmonogramu, zwykłe linie tekstu).
+// Po start() zdarzenia trafiają do kolejki, a formatowaniem i zapisem na stdout zajmuje się
+// osobny wątek - solver tylko na chwilę bierze mutex i nigdy nie czeka na potok.
+// Pośrednie ramki są łączone: zostaje tylko najnowsza, wysyłana co najwyżej raz na frameInterval.
+// Bez start() (np. bench, tryb wsadowy) zdarzenia są wypisywane od razu w wątku wołającym.
+// Wątek z przypiętym TelemetrySink wysyła swoje zdarzenia wyłącznie do niego.
+class Telemetry
+{
+    friend class TelemetryRoute;
+
+public:
+    enum class Format
+    {
+        Text, // dotychczasowe linie NEH_PROGRESS;/RESULT;/SLOT;/FRAME_END;
+        Json  // jeden obiekt JSON na linię
+    };
+
+private:
+    struct Event
+    {
+        enum class Kind
+        {
+            Log,
+            Progress,
+            Result,
+            Frame
+        } kind;
+        std::string text;
+        long long iter = 0;
+        double cmax = 0.0;
+        int chain = -1;
+        bool final = true;
+        std::vector<SlotRecord> slots;
+        const std::vector<int> *sequence = nullptr; // tylko dla odbiorcy wątku (wywołanie synchroniczne)
+    };
+
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::size_t MaxQueued = 1 << 16;
+
+    Format format = Format::Text;
+    std::chrono::milliseconds frameInterval{0};
+    FrameEncoder frames; // stan ramek różnicowych - używany tylko przez wątek zapisu
+
+    std::mutex mtx;
+    std::condition_variable wake;
+    std::condition_variable drained;
+    std::deque<Event> queue;
+    bool hasPending = false;
+    Event pendingFrame;
+    Clock::time_point lastFrame;
+    bool running = false;
+    bool stopping = false;
+    bool writing = false;
+    long long dropped = 0;
+    std::thread writer;
+
+public:
+    static Telemetry &get()
+    {
+        static Telemetry telemetry;
+        return telemetry;
+    }
+
+    ~Telemetry() { stop(); }
+
+    // keyframeInterval > 0 włącza ramki różnicowe (pełna ramka co tyle ramek)
+    void configure(Format fmt, int frameIntervalMs, int keyframeInterval = 0)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        format = fmt;
+        frameInterval = std::chrono::milliseconds(frameIntervalMs > 0 ? frameIntervalMs : 0);
+        frames.setKeyframeInterval(keyframeInterval);
+    }
+
+    Format getFormat() const { return format; }
+
+    void start()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (running)
+            return;
+        running = true;
+        stopping = false;
+        lastFrame = Clock::now() - frameInterval;
+        frames.reset();
+        writer = std::thread([this]
+                             { writerLoop(); });
+    }
+
+    // Opróżnia kolejkę (łącznie z oczekującą ramką) i kończy wątek zapisu
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!running)
+                return;
+            stopping = true;
+        }
+        wake.notify_one();
+        writer.join();
+        std::lock_guard<std::mutex> lock(mtx);
+        running = false;
+        if (dropped > 0)
+            std::cerr << "Warning: telemetry dropped " << dropped << " progress events" << std::endl;
+        dropped = 0;
+    }
+
+    // Czeka, aż wszystko zgłoszone do tej pory zostanie zapisane
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (!running)
+            return;
+        wake.notify_one();
+        drained.wait(lock, [this]
+                     { return queue.empty() && !writing; });
+    }
+
+    void log(const std::string &line)
+    {
+        Event e{Event::Kind::Log};
+        e.text = line;
+        push(std::move(e));
+    }
+
+    void progress(long long iter, double cmax)
+    {
+        Event e{Event::Kind::Progress};
+        e.iter = iter;
+        e.cmax = cmax;
+        push(std::move(e));
+    }
+
+    void result(long long iter, double cmax, int chain = -1)
+    {
+        Event e{Event::Kind::Result};
+        e.iter = iter;
+        e.cmax = cmax;
+        e.chain = chain;
+        push(std::move(e));
+    }
+
+    // Poprawa razem z sekwencją: odbiorca wątku (portfolio, worker) może od razu ją udostępnić innym
+    void result(long long iter, double cmax, const std::vector<int> &sequence, int chain = -1)
+    {
+        Event e{Event::Kind::Result};
+        e.iter = iter;
+        e.cmax = cmax;
+        e.chain = chain;
+        e.sequence = &sequence;
+        push(std::move(e));
+    }
+
+    // Czy warto budować pośrednią ramkę (minął frameInterval od ostatniej wysłanej)
+    bool wantsFrame()
+    {
+        if (TelemetrySink *sink = routed())
+            return sink->frameDue();
+        std::lock_guard<std::mutex> lock(mtx);
+        return !running || frameInterval.count() == 0 || Clock::now() - lastFrame >= frameInterval;
+    }
+
+    // final = ramka końcowa fazy (nigdy nie jest pomijana); pozostałe mogą zostać połączone
+    void frame(std::vector<SlotRecord> slots, bool final)
+    {
+        Event e{Event::Kind::Frame};
+        e.slots = std::move(slots);
+        e.final = final;
+        push(std::move(e));
+    }
+
+private:
+    Telemetry() = default;
+
+    static TelemetrySink *&routed()
+    {
+        static thread_local TelemetrySink *sink = nullptr;
+        return sink;
+    }
+
+    void push(Event &&e)
+    {
+        if (TelemetrySink *sink = routed())
+        {
+            if (e.kind == Event::Kind::Frame && !sink->acceptFrame(e.final))
+                return;
+            if (e.kind == Event::Kind::Result)
+                sink->improved(e.iter, e.cmax, e.sequence);
+            std::string out;
+            encode(e, Format::Json, sink->encoder(), out);
+            sink->write(out);
+            return;
+        }
+
+        e.sequence = nullptr; // kolejka przeżywa wywołanie solvera
+        std::unique_lock<std::mutex> lock(mtx);
+        if (!running)
+        {
+            std::string out;
+            encode(e, format, frames, out);
+            std::cout << out;
+            if (e.kind == Event::Kind::Frame)
+                std::cout.flush();
+            return;
+        }
+
+        if (e.kind == Event::Kind::Frame)
+        {
+            if (!e.final && frameInterval.count() > 0)
+            {
+                pendingFrame = std::move(e);
+                hasPending = true;
+                lock.unlock();
+                wake.notify_one();
+                return;
+            }
+            // Ramka końcowa jest nowsza od oczekującej pośredniej
+            if (e.final)
+                hasPending = false;
+        }
+        else if (e.kind != Event::Kind::Log && queue.size() >= MaxQueued)
+        {
+            ++dropped;
+            return;
+        }
+
+        queue.push_back(std::move(e));
+        lock.unlock();
+        wake.notify_one();
+    }
+
+    void writerLoop()
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        for (;;)
+        {
+            auto frameDue = lastFrame + frameInterval;
+            if (hasPending && !stopping && queue.empty())
+                wake.wait_until(lock, frameDue);
+            else if (!hasPending && !stopping && queue.empty())
+                wake.wait(lock);
+
+            std::deque<Event> batch;
+            batch.swap(queue);
+            bool emitPending = hasPending && (stopping || Clock::now() >= lastFrame + frameInterval);
+            Event pending;
+            if (emitPending)
+            {
+                pending = std::move(pendingFrame);
+                hasPending = false;
+            }
+            bool finishing = stopping && queue.empty() && !hasPending;
+            if (batch.empty() && !emitPending)
+            {
+                drained.notify_all();
+                if (finishing)
+                    return;
+                continue;
+            }
+
+            writing = true;
+            lock.unlock();
+
+            std::string out;
+            bool sentFrame = false;
+            for (const auto &e : batch)
+            {
+                encode(e, format, frames, out);
+                sentFrame = sentFrame || e.kind == Event::Kind::Frame;
+            }
+            if (emitPending)
+                encode(pending, format, frames, out);
+            std::cout.write(out.data(), (std::streamsize)out.size());
+            std::cout.flush();
+
+            lock.lock();
+            writing = false;
+            if (sentFrame || emitPending)
+                lastFrame = Clock::now();
+            drained.notify_all();
+        }
+    }
+
+    static void encode(const Event &e, Format fmt, FrameEncoder &frames, std::string &out)
+    {
+        std::ostringstream ss;
+        if (fmt == Format::Text)
+        {
+            switch (e.kind)
+            {
+            case Event::Kind::Log:
+                ss << e.text << "\n";
+                break;
+            case Event::Kind::Progress:
+                ss << "NEH_PROGRESS;iter=" << e.iter << ";cmax=" << e.cmax << "\n";
+                break;
+            case Event::Kind::Result:
+                ss << "RESULT;iter=" << e.iter << ";cmax=" << e.cmax;
+                if (e.chain >= 0)
+                    ss << ";chain=" << e.chain;
+                ss << "\n";
+                break;
+            case Event::Kind::Frame:
+                frames.encode(e.slots, e.final, false, ss);
+                break;
+            }
+        }
+        else
+        {
+            switch (e.kind)
+            {
+            case Event::Kind::Log:
+                ss << "{\"type\":\"log\",\"text\":\"" << escape(e.text) << "\"}\n";
+                break;
+            case Event::Kind::Progress:
+                ss << "{\"type\":\"neh_progress\",\"iter\":" << e.iter << ",\"cmax\":" << e.cmax << "}\n";
+                break;
+            case Event::Kind::Result:
+                ss << "{\"type\":\"result\",\"iter\":" << e.iter << ",\"cmax\":" << e.cmax;
+                if (e.chain >= 0)
+                    ss << ",\"chain\":" << e.chain;
+                ss << "}\n";
+                break;
+            case Event::Kind::Frame:
+                frames.encode(e.slots, e.final, true, ss);
+                break;
+            }
+        }
+        out += ss.str();
+    }
+
+public:
+    // Zawartość łańcucha JSON (bez cudzysłowów)
+    static std::string escape(const std::string &text)
+    {
+        std::string out;
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+                out += '\\', out += c;
+            else if (c == '\n')
+                out += "\\n";
+            else if ((unsigned char)c < 0x20)
+                out += ' ';
+            else
+                out += c;
+        }
+        return out;
+    }
+};
+
+// Wątek zapisu działający przez czas życia obiektu (start/stop w stylu RAII)
+class TelemetryScope
+{
+public:
+    TelemetryScope(Telemetry::Format format, int frameIntervalMs, int keyframeInterval = 0)
+    {
+        Telemetry::get().configure(format, frameIntervalMs, keyframeInterval);
+        Telemetry::get().start();
+    }
+    TelemetryScope(const TelemetryScope &) = delete;
+    ~TelemetryScope() { Telemetry::get().stop(); }
+};
+
+// Przypina odbiorcę zdarzeń do bieżącego wątku na czas życia obiektu
+class TelemetryRoute
+{
+private:
+    TelemetrySink *saved;
+
+public:
+    explicit TelemetryRoute(TelemetrySink &sink) : saved(Telemetry::routed()) { Telemetry::routed() = &sink; }
+    TelemetryRoute(const TelemetryRoute &) = delete;
+    ~TelemetryRoute() { Telemetry::routed() = saved; }
+};
+
+// Linia tekstu składana jak strumień i wysyłana przez Telemetry w destruktorze:
+//   LogLine() << "Parameters: " << iters;
+class LogLine
+{
+private:
+    std::ostringstream ss;
+
+public:
+    LogLine() = default;
+    LogLine(const LogLine &) = delete;
+    ~LogLine() { Telemetry::get().log(ss.str()); }
+
+    template <typename T>
+    LogLine &operator<<(const T &value)
+    {
+        ss << value;
+        return *this;
+    }
+};
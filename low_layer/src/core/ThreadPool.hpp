@@ -0,0 +1,108 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Prosta pula wątków o stałym rozmiarze ze wspólną kolejką zadań
+class ThreadPool
+{
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mtx;
+    std::condition_variable hasWork;
+    std::condition_variable allDone;
+    int active = 0;
+    bool stopping = false;
+    std::exception_ptr firstError;
+
+public:
+    explicit ThreadPool(int threads)
+    {
+        if (threads < 1)
+            threads = 1;
+        for (int i = 0; i < threads; ++i)
+            workers.emplace_back([this]
+                                 { workerLoop(); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        hasWork.notify_all();
+        for (auto &w : workers)
+            w.join();
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int size() const { return (int)workers.size(); }
+
+    void submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            tasks.push_back(std::move(task));
+        }
+        hasWork.notify_one();
+    }
+
+    // Czeka na wykonanie wszystkich zleconych zadań; pierwszy wyjątek z zadania jest przekazywany dalej
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        allDone.wait(lock, [this]
+                     { return tasks.empty() && active == 0; });
+        if (firstError)
+        {
+            std::exception_ptr err = firstError;
+            firstError = nullptr;
+            std::rethrow_exception(err);
+        }
+    }
+
+private:
+    void workerLoop()
+    {
+        for (;;)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                hasWork.wait(lock, [this]
+                             { return stopping || !tasks.empty(); });
+                if (tasks.empty())
+                    return;
+                task = std::move(tasks.front());
+                tasks.pop_front();
+                ++active;
+            }
+
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (!firstError)
+                    firstError = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                --active;
+                if (tasks.empty() && active == 0)
+                    allDone.notify_all();
+            }
+        }
+    }
+};
@@ -0,0 +1,177 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pula wątków z kradzieżą pracy: każdy wątek ma własną kolejkę. Zadania zlecane z wnętrza
+// zadania trafiają na koniec kolejki bieżącego wątku i są z niej zdejmowane od końca (LIFO -
+// przeszukiwanie w głąb, ciepły cache); bezczynny wątek kradnie z początku cudzej kolejki
+// (najstarsze, czyli zwykle największe poddrzewa). Zadania spoza puli rozdzielane są po kolei.
+class WorkStealingPool
+{
+private:
+    struct Queue
+    {
+        std::mutex mtx;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex mtx;
+    std::condition_variable hasWork;
+    std::condition_variable allDone;
+    std::atomic<long long> queued{0}; // zadania w kolejkach (jeszcze nie pobrane)
+    long long unfinished = 0;         // zlecone i nieukończone (pod mtx)
+    bool stopping = false;
+    std::exception_ptr firstError;
+    std::atomic<unsigned> nextQueue{0};
+
+    // Wątek bieżący: pula i indeks jego kolejki
+    static const WorkStealingPool *&currentPool()
+    {
+        static thread_local const WorkStealingPool *pool = nullptr;
+        return pool;
+    }
+    static int &currentIndex()
+    {
+        static thread_local int index = -1;
+        return index;
+    }
+
+public:
+    explicit WorkStealingPool(int threads)
+    {
+        if (threads < 1)
+            threads = 1;
+        for (int i = 0; i < threads; ++i)
+            queues.push_back(std::make_unique<Queue>());
+        for (int i = 0; i < threads; ++i)
+            workers.emplace_back([this, i]
+                                 { workerLoop(i); });
+    }
+
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        hasWork.notify_all();
+        for (auto &w : workers)
+            w.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    int size() const { return (int)workers.size(); }
+
+    // Indeks wątku puli wykonującego bieżące zadanie; -1 poza pulą
+    int workerIndex() const { return (currentPool() == this) ? currentIndex() : -1; }
+
+    void submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            ++unfinished;
+        }
+        int self = workerIndex();
+        int target = (self >= 0) ? self : (int)(nextQueue.fetch_add(1) % queues.size());
+        {
+            std::lock_guard<std::mutex> lock(queues[target]->mtx);
+            queues[target]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            queued.fetch_add(1);
+        }
+        hasWork.notify_one();
+    }
+
+    // Czeka na wszystkie zadania (także zlecone przez inne zadania); pierwszy wyjątek jest przekazywany dalej
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        allDone.wait(lock, [this]
+                     { return unfinished == 0; });
+        if (firstError)
+        {
+            std::exception_ptr err = firstError;
+            firstError = nullptr;
+            std::rethrow_exception(err);
+        }
+    }
+
+private:
+    bool take(int self, std::function<void()> &task)
+    {
+        {
+            Queue &own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mtx);
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                queued.fetch_sub(1);
+                return true;
+            }
+        }
+        int count = (int)queues.size();
+        for (int step = 1; step < count; ++step)
+        {
+            Queue &victim = *queues[(self + step) % count];
+            std::lock_guard<std::mutex> lock(victim.mtx);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queued.fetch_sub(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(int self)
+    {
+        currentPool() = this;
+        currentIndex() = self;
+        for (;;)
+        {
+            std::function<void()> task;
+            if (!take(self, task))
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                hasWork.wait(lock, [this]
+                             { return stopping || queued.load() > 0; });
+                if (stopping && queued.load() == 0)
+                    return;
+                continue;
+            }
+
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (!firstError)
+                    firstError = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (--unfinished == 0)
+                    allDone.notify_all();
+            }
+        }
+    }
+};
@@ -0,0 +1,240 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../core/BinaryFormat.hpp"
+
+// Rodzina macierzy przezbrojeń
+enum class SetupFamily
+{
+    Uniform,   // niezależne U[lo, hi] (jak data/generator.py)
+    Taillard,  // benchmark SDST (Ruiz i in.): proc U[1, 99], przezbrojenia U[1, k] dla SDST10/50/100/125
+    Geometric, // odległość między punktami zadań (na maszynę) - spełnia nierówność trójkąta
+    Grouped    // rodziny zadań: krótkie przezbrojenia w rodzinie, długie między rodzinami
+};
+
+struct GeneratorConfig
+{
+    int jobs = 100;
+    int machines = 2;
+    SetupFamily family = SetupFamily::Uniform;
+    int procLo = 5, procHi = 15;
+    int setupLo = 5, setupHi = 10;
+    int groups = 5; // Grouped
+};
+
+// Generator instancji z licznikowym RNG: każda wartość to funkcja (ziarno, strumień, indeks),
+// więc wynik zależy tylko od ziarna i parametrów - nie od kolejności zapisu, formatu ani podziału
+// na wątki. Zapis strumieniowy wiersz po wierszu: pamięć O(n * m) (czasy wykonania i jeden wiersz),
+// a nie O(m * n^2). Format tekstowy jak w data/, binarny jak --convert (układ machine-major,
+// najwęższy typ mieszczący górną granicę przezbrojeń).
+class InstanceGenerator
+{
+private:
+    GeneratorConfig config;
+    std::uint64_t seed;
+
+public:
+    InstanceGenerator(const GeneratorConfig &cfg, std::uint64_t instanceSeed) : config(cfg), seed(instanceSeed)
+    {
+        if (config.jobs < 1 || config.machines < 1)
+            throw std::invalid_argument("jobs and machines must be >= 1");
+        if (config.procLo < 0 || config.procLo > config.procHi || config.setupLo < 0 || config.setupLo > config.setupHi)
+            throw std::invalid_argument("value ranges must satisfy 0 <= lo <= hi");
+        if (config.family == SetupFamily::Grouped && config.groups < 1)
+            throw std::invalid_argument("groups must be >= 1");
+    }
+
+    int procTime(int job, int machine) const
+    {
+        return uniform(0, (std::uint64_t)job * config.machines + machine, config.procLo, config.procHi);
+    }
+
+    // Wiersz przezbrojeń [machine][prev][*] (zero na przekątnej)
+    void setupRow(int machine, int prev, int *row) const
+    {
+        int n = config.jobs;
+        std::uint64_t stream = 1 + (std::uint64_t)machine;
+        switch (config.family)
+        {
+        case SetupFamily::Geometric:
+        {
+            // Punkty w kwadracie 1000 x 1000; najdłuższa przekątna odpowiada setupHi
+            double scale = (double)(config.setupHi - config.setupLo) / (1000.0 * std::sqrt(2.0));
+            double px = coordinate(machine, prev, 0), py = coordinate(machine, prev, 1);
+            for (int curr = 0; curr < n; ++curr)
+            {
+                double dx = px - coordinate(machine, curr, 0), dy = py - coordinate(machine, curr, 1);
+                row[curr] = config.setupLo + (int)std::lround(std::sqrt(dx * dx + dy * dy) * scale);
+            }
+            break;
+        }
+        case SetupFamily::Grouped:
+        {
+            // Dolna ćwiartka zakresu w rodzinie, górna połowa między rodzinami
+            int span = config.setupHi - config.setupLo;
+            int inLo = config.setupLo, inHi = config.setupLo + span / 4;
+            int outLo = config.setupLo + (span + 1) / 2, outHi = config.setupHi;
+            int group = groupOf(prev);
+            for (int curr = 0; curr < n; ++curr)
+            {
+                std::uint64_t index = (std::uint64_t)prev * n + curr;
+                row[curr] = (groupOf(curr) == group) ? uniform(stream, index, inLo, inHi) : uniform(stream, index, outLo, outHi);
+            }
+            break;
+        }
+        default:
+            for (int curr = 0; curr < n; ++curr)
+                row[curr] = uniform(stream, (std::uint64_t)prev * n + curr, config.setupLo, config.setupHi);
+        }
+        row[prev] = 0;
+    }
+
+    // Format tekstowy (jobs = / machines = / proc_time = / setup_time = z sekcjami # machine k)
+    void writeText(std::FILE *out) const
+    {
+        int n = config.jobs, m = config.machines;
+        std::vector<int> row(std::max(n, m));
+        std::string line;
+        line.reserve((std::size_t)std::max(n, m) * 13 + 1);
+
+        std::fprintf(out, "jobs = %d\nmachines = %d\n\nproc_time =\n", n, m);
+        for (int j = 0; j < n; ++j)
+        {
+            for (int mach = 0; mach < m; ++mach)
+                row[mach] = procTime(j, mach);
+            writeLine(out, row.data(), m, line);
+        }
+        std::fputs("\nsetup_time =\n", out);
+        for (int mach = 0; mach < m; ++mach)
+        {
+            std::fprintf(out, "# machine %d\n", mach + 1);
+            for (int prev = 0; prev < n; ++prev)
+            {
+                setupRow(mach, prev, row.data());
+                writeLine(out, row.data(), n, line);
+            }
+            std::fputs("\n", out);
+        }
+    }
+
+    // Format binarny (BinaryFormat.hpp); szerokość elementu z górnej granicy przezbrojeń
+    void writeBinary(std::FILE *out) const
+    {
+        if (!binary_format::hostIsLittleEndian())
+            throw std::runtime_error("binary instance format requires a little-endian host");
+        int n = config.jobs, m = config.machines;
+        std::uint32_t width = (config.setupHi <= 0xFF) ? 1 : (config.setupHi <= 0xFFFF) ? 2 : 4;
+
+        BinaryInstanceHeader header{};
+        std::memcpy(header.magic, binary_format::Magic, sizeof(header.magic));
+        header.version = binary_format::Version;
+        header.jobs = (std::uint32_t)n;
+        header.machines = (std::uint32_t)m;
+        header.setupWidth = width;
+        header.setupLayout = 0; // machine-major: wiersze w kolejności generowania
+        header.procOffset = sizeof(BinaryInstanceHeader);
+        std::uint64_t procBytes = (std::uint64_t)n * m * sizeof(std::int32_t);
+        header.setupOffset = binary_format::alignUp(header.procOffset + procBytes);
+        header.setupBytes = (std::uint64_t)m * n * n * width;
+        std::fwrite(&header, sizeof(header), 1, out);
+
+        std::vector<std::int32_t> proc((std::size_t)n * m);
+        for (int j = 0; j < n; ++j)
+            for (int mach = 0; mach < m; ++mach)
+                proc[(std::size_t)j * m + mach] = procTime(j, mach);
+        std::fwrite(proc.data(), sizeof(std::int32_t), proc.size(), out);
+        std::vector<char> padding(header.setupOffset - header.procOffset - procBytes, 0);
+        std::fwrite(padding.data(), 1, padding.size(), out);
+
+        std::vector<int> row(n);
+        std::vector<unsigned char> packed((std::size_t)n * width);
+        for (int mach = 0; mach < m; ++mach)
+            for (int prev = 0; prev < n; ++prev)
+            {
+                setupRow(mach, prev, row.data());
+                for (int curr = 0; curr < n; ++curr)
+                {
+                    if (width == 1)
+                        packed[curr] = (std::uint8_t)row[curr];
+                    else if (width == 2)
+                    {
+                        std::uint16_t v = (std::uint16_t)row[curr];
+                        std::memcpy(packed.data() + (std::size_t)curr * 2, &v, 2);
+                    }
+                    else
+                    {
+                        std::int32_t v = row[curr];
+                        std::memcpy(packed.data() + (std::size_t)curr * 4, &v, 4);
+                    }
+                }
+                std::fwrite(packed.data(), 1, packed.size(), out);
+            }
+    }
+
+    // Parametry rodziny Taillard SDST: proc U[1, 99], przezbrojenia U[1, ratio% z 99] (SDST10 -> U[1, 9])
+    static void applyTaillard(GeneratorConfig &cfg, int ratio)
+    {
+        if (ratio != 10 && ratio != 50 && ratio != 100 && ratio != 125)
+            throw std::invalid_argument("--sdst must be 10, 50, 100 or 125");
+        cfg.procLo = 1;
+        cfg.procHi = 99;
+        cfg.setupLo = 1;
+        cfg.setupHi = (ratio == 125) ? 124 : ratio - 1;
+    }
+
+private:
+    // splitmix64 z (ziarno, strumień, indeks)
+    std::uint64_t mix(std::uint64_t stream, std::uint64_t index) const
+    {
+        std::uint64_t x = seed * 0x9E3779B97F4A7C15ULL ^ (stream + 1) * 0xD1B54A32D192ED03ULL ^ index * 0xABC98388FB8FAC03ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    // U[lo, hi] przez mnożenie (Lemire) - bez dzielenia
+    int uniform(std::uint64_t stream, std::uint64_t index, int lo, int hi) const
+    {
+        std::uint64_t span = (std::uint64_t)(hi - lo) + 1;
+        return lo + (int)(((mix(stream, index) >> 32) * span) >> 32);
+    }
+
+    // Strumienie pomocnicze za strumieniami wierszy maszyn
+    double coordinate(int machine, int job, int axis) const
+    {
+        std::uint64_t stream = 1 + (std::uint64_t)config.machines + 2 * (std::uint64_t)machine + axis;
+        return (double)(mix(stream, (std::uint64_t)job) >> 11) * (1000.0 / 9007199254740992.0);
+    }
+
+    int groupOf(int job) const
+    {
+        std::uint64_t stream = 1 + 3 * (std::uint64_t)config.machines;
+        return (int)(((mix(stream, (std::uint64_t)job) >> 32) * (std::uint64_t)config.groups) >> 32);
+    }
+
+    // Wartości oddzielone dwiema spacjami (jak w data/), formatowane to_chars do jednego bufora
+    static void writeLine(std::FILE *out, const int *values, int count, std::string &line)
+    {
+        line.resize((std::size_t)count * 13 + 1);
+        char *pos = line.data();
+        char *end = pos + line.size();
+        for (int i = 0; i < count; ++i)
+        {
+            if (i)
+            {
+                *pos++ = ' ';
+                *pos++ = ' ';
+            }
+            pos = std::to_chars(pos, end, values[i]).ptr;
+        }
+        *pos++ = '\n';
+        std::fwrite(line.data(), 1, (std::size_t)(pos - line.data()), out);
+    }
+};
@@ -0,0 +1,190 @@
+#include "InstanceGenerator.hpp"
+#include "../core/ThreadPool.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace
+{
+    bool parseOption(const std::string &arg, const std::string &key, std::string &value)
+    {
+        std::string prefix = "--" + key + "=";
+        if (arg.rfind(prefix, 0) != 0)
+            return false;
+        value = arg.substr(prefix.size());
+        return true;
+    }
+
+    // "LO-HI" albo pojedyncza wartość
+    void parseRange(const std::string &text, int &lo, int &hi)
+    {
+        std::size_t dash = text.find('-', 1);
+        lo = std::stoi(text.substr(0, dash));
+        hi = (dash == std::string::npos) ? lo : std::stoi(text.substr(dash + 1));
+    }
+
+    const char *familyName(SetupFamily family)
+    {
+        switch (family)
+        {
+        case SetupFamily::Taillard:
+            return "taillard";
+        case SetupFamily::Geometric:
+            return "geometric";
+        case SetupFamily::Grouped:
+            return "grouped";
+        default:
+            return "uniform";
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    GeneratorConfig config;
+    std::uint64_t seed = 1;
+    int count = 1;
+    int threads = 1;
+    int sdst = 50;
+    bool binary = false;
+    bool procGiven = false, setupGiven = false;
+    std::string outDir = ".";
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i], value;
+            if (parseOption(arg, "jobs", value))
+                config.jobs = std::stoi(value);
+            else if (parseOption(arg, "machines", value))
+                config.machines = std::stoi(value);
+            else if (parseOption(arg, "seed", value))
+                seed = std::stoull(value);
+            else if (parseOption(arg, "count", value))
+                count = std::stoi(value);
+            else if (parseOption(arg, "threads", value))
+                threads = std::max(1, std::stoi(value));
+            else if (parseOption(arg, "family", value))
+            {
+                if (value == "uniform")
+                    config.family = SetupFamily::Uniform;
+                else if (value == "taillard")
+                    config.family = SetupFamily::Taillard;
+                else if (value == "geometric")
+                    config.family = SetupFamily::Geometric;
+                else if (value == "grouped")
+                    config.family = SetupFamily::Grouped;
+                else
+                    throw std::invalid_argument("--family must be uniform, taillard, geometric or grouped");
+            }
+            else if (parseOption(arg, "proc", value))
+            {
+                parseRange(value, config.procLo, config.procHi);
+                procGiven = true;
+            }
+            else if (parseOption(arg, "setup", value))
+            {
+                parseRange(value, config.setupLo, config.setupHi);
+                setupGiven = true;
+            }
+            else if (parseOption(arg, "sdst", value))
+                sdst = std::stoi(value);
+            else if (parseOption(arg, "groups", value))
+                config.groups = std::stoi(value);
+            else if (parseOption(arg, "format", value))
+            {
+                if (value != "text" && value != "binary")
+                    throw std::invalid_argument("--format must be text or binary");
+                binary = (value == "binary");
+            }
+            else if (parseOption(arg, "out", value))
+                outDir = value;
+            else
+                throw std::invalid_argument("unknown option " + arg);
+        }
+
+        // Taillard ustala oba zakresy; jawne --proc/--setup mają pierwszeństwo
+        if (config.family == SetupFamily::Taillard)
+        {
+            GeneratorConfig taillard = config;
+            InstanceGenerator::applyTaillard(taillard, sdst);
+            if (!procGiven)
+                config.procLo = taillard.procLo, config.procHi = taillard.procHi;
+            if (!setupGiven)
+                config.setupLo = taillard.setupLo, config.setupHi = taillard.setupHi;
+        }
+        if (count < 1)
+            throw std::invalid_argument("--count must be >= 1");
+        InstanceGenerator check(config, seed); // walidacja parametrów przed startem wątków
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << "\n"
+                  << "Usage: " << argv[0] << " --jobs=N --machines=M [--seed=S] [--count=K] [--threads=T]"
+                  << " [--family=uniform|taillard|geometric|grouped] [--proc=LO-HI] [--setup=LO-HI] [--sdst=10|50|100|125]"
+                  << " [--groups=G] [--format=text|binary] [--out=DIR]" << std::endl;
+        return 1;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(outDir, ec);
+    if (ec)
+    {
+        std::cerr << "Error: cannot create directory " << outDir << std::endl;
+        return 1;
+    }
+
+    // Ziarna seed .. seed+count-1 dzielone na wątki; każda instancja zależy tylko od swojego ziarna
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<int> failed{0};
+    std::atomic<unsigned long long> bytes{0};
+    std::mutex logMtx;
+    {
+        ThreadPool pool(std::min(threads, count));
+        for (int k = 0; k < count; ++k)
+            pool.submit([&, k]
+                        {
+                            std::uint64_t instanceSeed = seed + (std::uint64_t)k;
+                            std::string name = std::to_string(config.jobs) + "_" + std::to_string(config.machines) + "_" +
+                                               familyName(config.family) + "_" + std::to_string(instanceSeed) + (binary ? ".bin" : ".txt");
+                            std::string path = (std::filesystem::path(outDir) / name).string();
+
+                            std::FILE *out = std::fopen(path.c_str(), "wb");
+                            bool ok = out != nullptr;
+                            if (ok)
+                            {
+                                // Duży bufor zapisu - wiersze składane są w pamięci, plik rośnie dużymi blokami
+                                std::unique_ptr<char[]> buffer(new char[1 << 20]);
+                                std::setvbuf(out, buffer.get(), _IOFBF, 1 << 20);
+                                InstanceGenerator generator(config, instanceSeed);
+                                if (binary)
+                                    generator.writeBinary(out);
+                                else
+                                    generator.writeText(out);
+                                ok = !std::ferror(out);
+                                bytes += (unsigned long long)std::ftell(out);
+                                ok = (std::fclose(out) == 0) && ok;
+                            }
+                            std::lock_guard<std::mutex> lock(logMtx);
+                            if (!ok)
+                            {
+                                ++failed;
+                                std::cerr << "Error: cannot write file " << path << std::endl;
+                            }
+                            else
+                                std::cout << path << std::endl; });
+        pool.wait();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "Generated " << count - failed.load() << " instance(s), " << bytes.load() / (1024 * 1024) << " MiB in "
+              << (long long)(seconds * 1000) << " ms (threads=" << std::min(threads, count) << ")" << std::endl;
+    return failed.load() ? 1 : 0;
+}
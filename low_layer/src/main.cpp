@@ -5,15 +5,33 @@
 
 int main(int argc, char **argv) {
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <data_file> [algorithms...]" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <data_file> [algorithms...] [--threads=N] [--migrate=K] [--seed=S] [--sa-batch=K] [--sa-cache=N] [--telemetry=text|json] [--frame-interval=MS] [--keyframe=N]" << std::endl;
+        std::cerr << "           [--sa-schedule=geometric|lundy-mees] [--sa-calibrate] [--sa-reheat=ITERS]" << std::endl;
+        std::cerr << "           [--time-limit=SEC] [--target=CMAX] [--stagnation=ITERS] [--stdin-control]" << std::endl;
+        std::cerr << "           [--setup-storage=narrow|wide|packed] [--huge-pages] [--profile] [--profile-trace=FILE]" << std::endl;
+        std::cerr << "       " << argv[0] << " <data_file> --portfolio [pipelines...] [--time-limit=SEC] [--stagnation=ITERS] [--target=CMAX]" << std::endl;
+        std::cerr << "       " << argv[0] << " <data_file> --convert=<binary_file>" << std::endl;
+        std::cerr << "       " << argv[0] << " --batch=<dir|mask> [pipelines...] [--seeds=N] [--out=results.csv|.json] [--threads=N]" << std::endl;
+        std::cerr << "       " << argv[0] << " --serve[=<socket_path>] [--threads=N] [--cache=N]" << std::endl;
+        std::cerr << "       " << argv[0] << " --batch=... | <data_file> --portfolio ... [--coordinator=<socket_path|HOST:PORT>] [--spawn-workers=N] [--broadcast=MS]" << std::endl;
+        std::cerr << "       " << argv[0] << " --worker=<socket_path|HOST:PORT> [--threads=N]" << std::endl;
         return 1;
     }
 
-    std::string dataFile = argv[1];
+    // W trybie wsadowym (--batch=...), serwera (--serve) i workera (--worker=...) pierwszy argument nie jest plikiem z danymi
+    bool batch = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        batch = batch || arg.rfind("--batch=", 0) == 0 || arg == "--serve" || arg.rfind("--serve=", 0) == 0 ||
+                arg.rfind("--worker=", 0) == 0;
+    }
+
+    std::string dataFile = batch ? "" : argv[1];
     std::vector<std::string> algArgs;
     
     // Zbieramy wszystkie argumenty po nazwie pliku (np. neh, simulated_annealing)
-    for (int i = 2; i < argc; ++i) {
+    for (int i = batch ? 1 : 2; i < argc; ++i) {
         algArgs.push_back(argv[i]);
     }
 
@@ -0,0 +1,686 @@
+// Moduł Pythona "pfsp" (C API, bez zależności): wczytywanie instancji, walidacja i makespan
+// sekwencji, harmonogram oraz potoki solverów w procesie, bez uruchamiania pfsp_sdst.
+// Macierze instancji i wyniki zwracane są jako memoryview na danych C++ (bez kopiowania):
+// numpy.asarray(view) daje tablicę współdzielącą pamięć. Obliczenia zwalniają GIL.
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../core/Instance.hpp"
+#include "../core/BatchMakespan.hpp"
+#include "../core/LowerBound.hpp"
+#include "../core/Schedule.hpp"
+#include "../core/Telemetry.hpp"
+#include "../app/Pipeline.hpp"
+
+namespace
+{
+    // ---------------------------------------------------------------------------------------
+    // Widok tablicy tylko do odczytu (protokół bufora); keep utrzymuje dane przy życiu
+
+    struct ArrayObject
+    {
+        PyObject_HEAD
+        std::shared_ptr<const void> keep;
+        const void *data;
+        const char *format;
+        Py_ssize_t itemsize;
+        int ndim;
+        Py_ssize_t shape[3];
+        Py_ssize_t strides[3];
+    };
+
+    bool isCContiguous(const ArrayObject *a)
+    {
+        Py_ssize_t expected = a->itemsize;
+        for (int d = a->ndim - 1; d >= 0; --d)
+        {
+            if (a->shape[d] > 1 && a->strides[d] != expected)
+                return false;
+            expected *= a->shape[d];
+        }
+        return true;
+    }
+
+    int arrayGetBuffer(PyObject *self, Py_buffer *view, int flags)
+    {
+        auto *a = (ArrayObject *)self;
+        view->obj = nullptr;
+        if (flags & PyBUF_WRITABLE)
+        {
+            PyErr_SetString(PyExc_BufferError, "pfsp arrays are read-only");
+            return -1;
+        }
+        bool contiguous = isCContiguous(a);
+        if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES && !contiguous)
+        {
+            PyErr_SetString(PyExc_BufferError, "array is strided - request a strided buffer");
+            return -1;
+        }
+        bool wantsContiguous = (flags & PyBUF_C_CONTIGUOUS) == PyBUF_C_CONTIGUOUS ||
+                               (flags & PyBUF_F_CONTIGUOUS) == PyBUF_F_CONTIGUOUS ||
+                               (flags & PyBUF_ANY_CONTIGUOUS) == PyBUF_ANY_CONTIGUOUS;
+        if (wantsContiguous && !contiguous)
+        {
+            PyErr_SetString(PyExc_BufferError, "array is not contiguous");
+            return -1;
+        }
+
+        Py_ssize_t count = 1;
+        for (int d = 0; d < a->ndim; ++d)
+            count *= a->shape[d];
+        view->buf = const_cast<void *>(a->data);
+        view->obj = self;
+        Py_INCREF(self);
+        view->len = count * a->itemsize;
+        view->readonly = 1;
+        view->itemsize = a->itemsize;
+        view->format = (flags & PyBUF_FORMAT) ? const_cast<char *>(a->format) : nullptr;
+        view->ndim = a->ndim;
+        view->shape = (flags & PyBUF_ND) ? a->shape : nullptr;
+        view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? a->strides : nullptr;
+        view->suboffsets = nullptr;
+        view->internal = nullptr;
+        return 0;
+    }
+
+    void arrayDealloc(PyObject *self)
+    {
+        ((ArrayObject *)self)->keep.~shared_ptr();
+        Py_TYPE(self)->tp_free(self);
+    }
+
+    PyBufferProcs arrayBufferProcs = {arrayGetBuffer, nullptr};
+
+    PyTypeObject ArrayType = {PyVarObject_HEAD_INIT(nullptr, 0)};
+
+    // memoryview na danych data (kształt shape, kroki w bajtach strides; puste = C-ciągłe)
+    PyObject *makeView(std::shared_ptr<const void> keep, const void *data, const char *format, Py_ssize_t itemsize,
+                       std::vector<Py_ssize_t> shape, std::vector<Py_ssize_t> strides = {})
+    {
+        auto *a = PyObject_New(ArrayObject, &ArrayType);
+        if (!a)
+            return nullptr;
+        new (&a->keep) std::shared_ptr<const void>(std::move(keep));
+        a->data = data;
+        a->format = format;
+        a->itemsize = itemsize;
+        a->ndim = (int)shape.size();
+        Py_ssize_t step = itemsize;
+        for (int d = a->ndim - 1; d >= 0; --d)
+        {
+            a->shape[d] = shape[d];
+            a->strides[d] = strides.empty() ? step : strides[d];
+            step *= shape[d];
+        }
+        PyObject *view = PyMemoryView_FromObject((PyObject *)a);
+        Py_DECREF(a);
+        return view;
+    }
+
+    // Wektor przeniesiony na stertę i wystawiony jako jednowymiarowy widok
+    template <typename T>
+    PyObject *ownedView(std::vector<T> values, const char *format)
+    {
+        auto owned = std::make_shared<std::vector<T>>(std::move(values));
+        const T *data = owned->data();
+        Py_ssize_t size = (Py_ssize_t)owned->size();
+        return makeView(owned, data, format, sizeof(T), {size});
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // Odczyt sekwencji z Pythona: bufor liczb całkowitych (np. numpy int32/int64) albo sekwencja int
+
+    // Typ elementu bufora: 4 albo 8 bajtów ze znakiem/bez; 0 = nieobsługiwany
+    int integerWidth(const Py_buffer &view)
+    {
+        const char *f = view.format ? view.format : "B";
+        if (*f == '@' || *f == '=' || *f == '<')
+            ++f;
+        if (std::strlen(f) != 1 || !std::strchr("iIlLqQnN", *f))
+            return 0;
+        return (view.itemsize == 4 || view.itemsize == 8) ? (int)view.itemsize : 0;
+    }
+
+    bool readIntegers(PyObject *obj, std::vector<long long> &out, std::vector<Py_ssize_t> *shape = nullptr)
+    {
+        out.clear();
+        if (PyObject_CheckBuffer(obj))
+        {
+            Py_buffer view;
+            if (PyObject_GetBuffer(obj, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0)
+                return false;
+            int width = integerWidth(view);
+            if (!width)
+            {
+                PyBuffer_Release(&view);
+                PyErr_SetString(PyExc_TypeError, "expected a buffer of 32- or 64-bit integers");
+                return false;
+            }
+            Py_ssize_t count = view.len / view.itemsize;
+            out.resize((std::size_t)count);
+            for (Py_ssize_t i = 0; i < count; ++i)
+                out[i] = (width == 4) ? ((const std::int32_t *)view.buf)[i] : ((const std::int64_t *)view.buf)[i];
+            if (shape)
+                shape->assign(view.shape, view.shape + view.ndim);
+            PyBuffer_Release(&view);
+            return true;
+        }
+
+        PyObject *fast = PySequence_Fast(obj, "expected a sequence of integers");
+        if (!fast)
+            return false;
+        Py_ssize_t count = PySequence_Fast_GET_SIZE(fast);
+        out.resize((std::size_t)count);
+        for (Py_ssize_t i = 0; i < count; ++i)
+        {
+            out[i] = PyLong_AsLongLong(PySequence_Fast_GET_ITEM(fast, i));
+            if (out[i] == -1 && PyErr_Occurred())
+            {
+                Py_DECREF(fast);
+                return false;
+            }
+        }
+        Py_DECREF(fast);
+        if (shape)
+            shape->assign(1, count);
+        return true;
+    }
+
+    // Lista sekwencji (np. lista list) jako tablica wierszy; shape = {wiersze, długość pierwszego}
+    bool readRows(PyObject *obj, std::vector<long long> &out, std::vector<Py_ssize_t> &shape)
+    {
+        PyObject *rows = PySequence_Fast(obj, "expected a 2-D array or a sequence of sequences");
+        if (!rows)
+            return false;
+        Py_ssize_t count = PySequence_Fast_GET_SIZE(rows);
+        shape.assign({count, 0});
+        out.clear();
+        std::vector<long long> row;
+        for (Py_ssize_t r = 0; r < count; ++r)
+        {
+            if (!readIntegers(PySequence_Fast_GET_ITEM(rows, r), row))
+            {
+                Py_DECREF(rows);
+                return false;
+            }
+            if (r == 0)
+                shape[1] = (Py_ssize_t)row.size();
+            else if ((Py_ssize_t)row.size() != shape[1])
+            {
+                Py_DECREF(rows);
+                PyErr_SetString(PyExc_ValueError, "all sequences must have the same length");
+                return false;
+            }
+            out.insert(out.end(), row.begin(), row.end());
+        }
+        Py_DECREF(rows);
+        return true;
+    }
+
+    // Pusty tekst = poprawna permutacja 0..n-1
+    std::string checkPermutation(const long long *values, std::size_t size, int n)
+    {
+        if ((long long)size != n)
+            return "sequence has " + std::to_string(size) + " jobs, instance has " + std::to_string(n);
+        std::vector<char> seen(n, 0);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            if (values[i] < 0 || values[i] >= n)
+                return "job " + std::to_string(values[i]) + " at position " + std::to_string(i) + " is out of range";
+            if (seen[values[i]]++)
+                return "job " + std::to_string(values[i]) + " appears more than once";
+        }
+        return "";
+    }
+
+    // Sekwencja z argumentu; zła zgłasza ValueError
+    bool readSequence(PyObject *obj, int n, std::vector<int> &seq)
+    {
+        std::vector<long long> values;
+        if (!readIntegers(obj, values))
+            return false;
+        std::string error = checkPermutation(values.data(), values.size(), n);
+        if (!error.empty())
+        {
+            PyErr_SetString(PyExc_ValueError, ("invalid sequence: " + error).c_str());
+            return false;
+        }
+        seq.assign(values.begin(), values.end());
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // pfsp.Instance
+
+    struct InstanceObject
+    {
+        PyObject_HEAD
+        std::shared_ptr<const Instance> *instance;
+    };
+
+    const Instance &instanceOf(PyObject *self) { return **((InstanceObject *)self)->instance; }
+
+    int instanceInit(PyObject *self, PyObject *args, PyObject *kwargs)
+    {
+        static const char *keywords[] = {"path", "setup_storage", nullptr};
+        const char *path = nullptr;
+        const char *storage = "narrow";
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|s", const_cast<char **>(keywords), &path, &storage))
+            return -1;
+
+        SetupEncoding encoding = SetupEncoding::Narrowest;
+        if (std::strcmp(storage, "wide") == 0)
+            encoding = SetupEncoding::Wide;
+        else if (std::strcmp(storage, "packed") == 0)
+            encoding = SetupEncoding::Packed;
+        else if (std::strcmp(storage, "narrow") != 0)
+        {
+            PyErr_SetString(PyExc_ValueError, "setup_storage must be narrow, wide or packed");
+            return -1;
+        }
+
+        auto instance = std::make_shared<Instance>(path);
+        instance->setStorageOptions(SetupLayout::PrevJobMajor, encoding);
+        bool ok = false;
+        Py_BEGIN_ALLOW_THREADS
+        ok = instance->loadFromFile(false);
+        Py_END_ALLOW_THREADS
+        if (!ok)
+        {
+            PyErr_Format(PyExc_ValueError, "cannot load instance %s", path);
+            return -1;
+        }
+        auto *obj = (InstanceObject *)self;
+        delete obj->instance;
+        obj->instance = new std::shared_ptr<const Instance>(instance);
+        return 0;
+    }
+
+    void instanceDealloc(PyObject *self)
+    {
+        delete ((InstanceObject *)self)->instance;
+        Py_TYPE(self)->tp_free(self);
+    }
+
+    // Metody wymagają wczytanej instancji (__init__ mógł się nie udać lub nie zostać wywołany)
+    bool ready(PyObject *self)
+    {
+        if (((InstanceObject *)self)->instance)
+            return true;
+        PyErr_SetString(PyExc_RuntimeError, "instance is not loaded");
+        return false;
+    }
+
+    PyObject *instanceJobs(PyObject *self, void *)
+    {
+        return ready(self) ? PyLong_FromLong(instanceOf(self).getJobs()) : nullptr;
+    }
+
+    PyObject *instanceMachines(PyObject *self, void *)
+    {
+        return ready(self) ? PyLong_FromLong(instanceOf(self).getMachines()) : nullptr;
+    }
+
+    PyObject *instancePath(PyObject *self, void *)
+    {
+        return ready(self) ? PyUnicode_FromString(instanceOf(self).getFilePath().c_str()) : nullptr;
+    }
+
+    PyObject *instanceSetupStorage(PyObject *self, void *)
+    {
+        if (!ready(self))
+            return nullptr;
+        return PyUnicode_FromString(SetupMatrix::widthName(instanceOf(self).getSetupMatrix().getWidth()));
+    }
+
+    // Czasy wykonania [job][machine] (int32)
+    PyObject *instanceProcessingTimes(PyObject *self, void *)
+    {
+        if (!ready(self))
+            return nullptr;
+        const auto &holder = *((InstanceObject *)self)->instance;
+        const ProcMatrix &proc = holder->getProcMatrix();
+        return makeView(holder, proc.row(0), "i", sizeof(std::int32_t), {holder->getJobs(), holder->getMachines()});
+    }
+
+    // Przezbrojenia [machine][prev][curr] w typie przechowywania (uint8/uint16/int32); kroki
+    // odpowiadają układowi w pamięci, więc widok nie kopiuje danych niezależnie od układu
+    PyObject *instanceSetupTimes(PyObject *self, void *)
+    {
+        if (!ready(self))
+            return nullptr;
+        const auto &holder = *((InstanceObject *)self)->instance;
+        const SetupMatrix &setup = holder->getSetupMatrix();
+        Py_ssize_t e = (Py_ssize_t)setup.elementBytes();
+        if (e == 0)
+        {
+            PyErr_SetString(PyExc_ValueError, "packed setup storage has no array view - load with setup_storage='narrow' or 'wide'");
+            return nullptr;
+        }
+        const char *format = (e == 1) ? "B" : (e == 2) ? "H" : "i";
+        Py_ssize_t n = holder->getJobs(), m = holder->getMachines();
+        std::vector<Py_ssize_t> strides = (setup.getLayout() == SetupLayout::MachineMajor)
+                                              ? std::vector<Py_ssize_t>{n * n * e, n * e, e}
+                                              : std::vector<Py_ssize_t>{e, n * m * e, m * e};
+        return makeView(holder, setup.rawData(), format, e, {m, n, n}, strides);
+    }
+
+    PyObject *instanceMakespan(PyObject *self, PyObject *arg)
+    {
+        std::vector<int> seq;
+        if (!ready(self) || !readSequence(arg, instanceOf(self).getJobs(), seq))
+            return nullptr;
+        return PyLong_FromLongLong(instanceOf(self).makespanOf(seq));
+    }
+
+    // Makespany wielu sekwencji naraz: tablica k x n (wiersz = sekwencja) -> int64[k].
+    // Ciągły bufor int32 (np. numpy int32) czytany jest bez kopiowania
+    PyObject *instanceMakespans(PyObject *self, PyObject *arg)
+    {
+        if (!ready(self))
+            return nullptr;
+        const auto &holder = *((InstanceObject *)self)->instance;
+        int n = holder->getJobs();
+
+        Py_buffer view;
+        bool borrowed = false;
+        std::vector<int> copied;
+        std::size_t count = 0;
+        if (PyObject_CheckBuffer(arg) && PyObject_GetBuffer(arg, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == 0)
+        {
+            if (integerWidth(view) == 4 && view.ndim == 2 && view.shape[1] == n)
+            {
+                borrowed = true;
+                count = (std::size_t)view.shape[0];
+            }
+            else
+                PyBuffer_Release(&view);
+        }
+        else
+            PyErr_Clear();
+        if (!borrowed)
+        {
+            std::vector<long long> values;
+            std::vector<Py_ssize_t> shape;
+            if (!(PyObject_CheckBuffer(arg) ? readIntegers(arg, values, &shape) : readRows(arg, values, shape)))
+                return nullptr;
+            if (shape.size() != 2 || shape[1] != n)
+            {
+                PyErr_Format(PyExc_ValueError, "expected a 2-D array with %d columns (one sequence per row)", n);
+                return nullptr;
+            }
+            count = (std::size_t)shape[0];
+            copied.assign(values.begin(), values.end());
+        }
+        const int *seqs = borrowed ? (const int *)view.buf : copied.data();
+
+        // Zła sekwencja (zadanie spoza zakresu) czytałaby poza macierzami
+        std::string error;
+        std::size_t badRow = 0;
+        Py_BEGIN_ALLOW_THREADS
+        std::vector<long long> row(n);
+        for (std::size_t c = 0; c < count && error.empty(); ++c)
+        {
+            std::copy(seqs + c * n, seqs + (c + 1) * n, row.begin());
+            error = checkPermutation(row.data(), (std::size_t)n, n);
+            badRow = c;
+        }
+        Py_END_ALLOW_THREADS
+        if (!error.empty())
+        {
+            if (borrowed)
+                PyBuffer_Release(&view);
+            PyErr_SetString(PyExc_ValueError, ("invalid sequence in row " + std::to_string(badRow) + ": " + error).c_str());
+            return nullptr;
+        }
+
+        std::vector<long long> out(count);
+        Py_BEGIN_ALLOW_THREADS
+        // Porcje po 64k sekwencji - indeksy wektorowej ścieżki BatchMakespan są 32-bitowe
+        BatchMakespan batch(*holder);
+        const std::size_t chunk = 1 << 16;
+        for (std::size_t first = 0; first < count; first += chunk)
+            batch.evaluate(seqs + first * n, (int)std::min(chunk, count - first), n, out.data() + first);
+        Py_END_ALLOW_THREADS
+        if (borrowed)
+            PyBuffer_Release(&view);
+        return ownedView(std::move(out), "q");
+    }
+
+    // (True, "") albo (False, opis błędu) - bez wyjątku dla złej sekwencji
+    PyObject *instanceValidate(PyObject *self, PyObject *arg)
+    {
+        if (!ready(self))
+            return nullptr;
+        std::vector<long long> values;
+        if (!readIntegers(arg, values))
+            return nullptr;
+        std::string error = checkPermutation(values.data(), values.size(), instanceOf(self).getJobs());
+        return Py_BuildValue("(Os)", error.empty() ? Py_True : Py_False, error.c_str());
+    }
+
+    // Harmonogram sekwencji: rekordy (machine, job, start, end, setup) jak w liniach SLOT;
+    PyObject *instanceSlots(PyObject *self, PyObject *arg)
+    {
+        std::vector<int> seq;
+        if (!ready(self) || !readSequence(arg, instanceOf(self).getJobs(), seq))
+            return nullptr;
+        auto slots = std::make_shared<std::vector<SlotRecord>>(Schedule(seq).computeSlots(instanceOf(self)));
+        static_assert(sizeof(SlotRecord) == 32, "slot format below assumes 32-byte records");
+        const SlotRecord *data = slots->data();
+        return makeView(slots, data, "T{i:machine:i:job:q:start:q:end:i:setup:4x}", sizeof(SlotRecord),
+                        {(Py_ssize_t)slots->size()});
+    }
+
+    PyGetSetDef instanceGetSet[] = {
+        {"jobs", instanceJobs, nullptr, "number of jobs", nullptr},
+        {"machines", instanceMachines, nullptr, "number of machines", nullptr},
+        {"path", instancePath, nullptr, "instance file path", nullptr},
+        {"setup_storage", instanceSetupStorage, nullptr, "setup element type: uint8, uint16, int32 or packed", nullptr},
+        {"processing_times", instanceProcessingTimes, nullptr, "read-only view [job][machine] (int32)", nullptr},
+        {"setup_times", instanceSetupTimes, nullptr, "read-only view [machine][prev][curr]", nullptr},
+        {nullptr, nullptr, nullptr, nullptr, nullptr}};
+
+    PyMethodDef instanceMethods[] = {
+        {"makespan", instanceMakespan, METH_O, "makespan(sequence) -> int"},
+        {"makespans", instanceMakespans, METH_O, "makespans(sequences[k][n]) -> int64 view of k makespans (GIL released)"},
+        {"validate", instanceValidate, METH_O, "validate(sequence) -> (ok, message)"},
+        {"slots", instanceSlots, METH_O, "slots(sequence) -> view of (machine, job, start, end, setup) records"},
+        {nullptr, nullptr, 0, nullptr}};
+
+    PyTypeObject InstanceType = {PyVarObject_HEAD_INIT(nullptr, 0)};
+
+    // ---------------------------------------------------------------------------------------
+    // pfsp.solve: potok jak w trybie wsadowym, postęp przez callback(iteration, makespan)
+
+    // Poprawy wyniku z wątku solvera do callbacku (z GIL); wyjątek w callbacku przerywa obliczenia
+    class CallbackSink : public TelemetrySink
+    {
+    private:
+        PyObject *callback;
+        std::atomic<bool> &cancel;
+        PyObject *errorType = nullptr;
+        PyObject *errorValue = nullptr;
+        PyObject *errorTrace = nullptr;
+
+    public:
+        CallbackSink(PyObject *cb, std::atomic<bool> &cancelFlag) : callback(cb), cancel(cancelFlag)
+        {
+            configureFrames(false, 0, 0);
+        }
+
+        void write(const std::string &) override {}
+
+        void improved(long long iter, double cmax, const std::vector<int> *) override
+        {
+            if (errorType)
+                return;
+            PyGILState_STATE gil = PyGILState_Ensure();
+            PyObject *result = PyObject_CallFunction(callback, "LL", iter, (long long)cmax);
+            Py_XDECREF(result);
+            if (!result || PyErr_CheckSignals() < 0)
+            {
+                PyErr_Fetch(&errorType, &errorValue, &errorTrace);
+                cancel.store(true);
+            }
+            PyGILState_Release(gil);
+        }
+
+        // Z GIL: przywraca wyjątek callbacku; false = nie było błędu
+        bool restoreError()
+        {
+            if (!errorType)
+                return false;
+            PyErr_Restore(errorType, errorValue, errorTrace);
+            errorType = errorValue = errorTrace = nullptr;
+            return true;
+        }
+    };
+
+    PyObject *solve(PyObject *, PyObject *args, PyObject *kwargs)
+    {
+        static const char *keywords[] = {"instance", "pipeline", "seed", "time_limit", "target", "stagnation", "callback",
+                                         "sa_batch", "sa_cache", "sa_schedule", "sa_calibrate", "sa_reheat", nullptr};
+        PyObject *instanceArg = nullptr;
+        const char *spec = "neh+simulated_annealing";
+        int seed = 1;
+        double timeLimit = 0.0;
+        long long target = 0, stagnation = 0;
+        PyObject *callback = Py_None;
+        PipelineOptions tuning;
+        const char *cooling = "geometric";
+        int calibrate = 0;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|sidLLOiispi", const_cast<char **>(keywords), &InstanceType, &instanceArg,
+                                         &spec, &seed, &timeLimit, &target, &stagnation, &callback, &tuning.moveBatch,
+                                         &tuning.solutionCache, &cooling, &calibrate, &tuning.annealing.reheatInterval))
+            return nullptr;
+        if (!ready(instanceArg))
+            return nullptr;
+        if (callback != Py_None && !PyCallable_Check(callback))
+        {
+            PyErr_SetString(PyExc_TypeError, "callback must be callable");
+            return nullptr;
+        }
+        if (timeLimit < 0 || target < 0 || stagnation < 0)
+        {
+            PyErr_SetString(PyExc_ValueError, "time_limit, target and stagnation must be >= 0");
+            return nullptr;
+        }
+        if (tuning.moveBatch < 1 || tuning.solutionCache < 0 || tuning.annealing.reheatInterval < 0)
+        {
+            PyErr_SetString(PyExc_ValueError, "sa_batch must be >= 1, sa_cache and sa_reheat >= 0");
+            return nullptr;
+        }
+        if (!AnnealingSchedule::parseCooling(cooling, tuning.annealing.cooling))
+        {
+            PyErr_SetString(PyExc_ValueError, "sa_schedule must be 'geometric' or 'lundy-mees'");
+            return nullptr;
+        }
+        tuning.annealing.calibrate = calibrate != 0;
+
+        Pipeline pipeline;
+        try
+        {
+            pipeline = parsePipeline(spec);
+        }
+        catch (const std::exception &e)
+        {
+            PyErr_SetString(PyExc_ValueError, e.what());
+            return nullptr;
+        }
+
+        std::shared_ptr<const Instance> holder = *((InstanceObject *)instanceArg)->instance;
+        std::atomic<bool> cancel{false};
+        CallbackSink sink(callback, cancel);
+        PipelineResult result;
+        long long lowerBound = 0;
+        std::string error;
+
+        Py_BEGIN_ALLOW_THREADS
+        try
+        {
+            SolveBudget budget;
+            budget.timeLimit = timeLimit;
+            budget.targetMakespan = target;
+            budget.stagnationLimit = stagnation;
+            budget.start();
+            lowerBound = LowerBound(*holder).compute();
+            budget.lowerBound = lowerBound;
+
+            // Zdarzenia solvera tylko do odbiorcy tego wątku (bez stdout); bez callbacku - bez zdarzeń
+            TelemetryRoute route(sink);
+            CancellationScope scope(cancel);
+            result = runPipeline(*holder, pipeline, seed, budget, callback != Py_None, Schedule(), tuning);
+        }
+        catch (const std::exception &e)
+        {
+            error = e.what();
+        }
+        Py_END_ALLOW_THREADS
+
+        if (sink.restoreError())
+            return nullptr;
+        if (!error.empty())
+        {
+            PyErr_SetString(PyExc_RuntimeError, error.c_str());
+            return nullptr;
+        }
+
+        PyObject *sequence = ownedView(std::move(result.sequence), "i");
+        if (!sequence)
+            return nullptr;
+        return Py_BuildValue("{s:N,s:L,s:L,s:L,s:d,s:s}", "sequence", sequence, "makespan", (long long)result.makespan,
+                             "lower_bound", lowerBound, "iterations", result.iterations, "seconds", result.seconds,
+                             "stop_reason", result.stopReason.c_str());
+    }
+
+    PyMethodDef moduleMethods[] = {
+        {"solve", (PyCFunction)(void (*)(void))solve, METH_VARARGS | METH_KEYWORDS,
+         "solve(instance, pipeline='neh+simulated_annealing', seed=1, time_limit=0, target=0, stagnation=0, callback=None,\n"
+         "      sa_batch=1, sa_cache=0, sa_schedule='geometric', sa_calibrate=False, sa_reheat=0)\n"
+         "-> dict(sequence, makespan, lower_bound, iterations, seconds, stop_reason).\n"
+         "callback(iteration, makespan) is called on every improvement; raising in it cancels the run."},
+        {nullptr, nullptr, 0, nullptr}};
+
+    PyModuleDef moduleDef = {PyModuleDef_HEAD_INIT, "pfsp", "PFSP-SDST solver core (in-process binding)", -1, moduleMethods};
+}
+
+PyMODINIT_FUNC PyInit_pfsp()
+{
+    ArrayType.tp_name = "pfsp._Array";
+    ArrayType.tp_basicsize = sizeof(ArrayObject);
+    ArrayType.tp_dealloc = arrayDealloc;
+    ArrayType.tp_as_buffer = &arrayBufferProcs;
+    ArrayType.tp_flags = Py_TPFLAGS_DEFAULT;
+    ArrayType.tp_doc = "read-only array exported through the buffer protocol";
+
+    InstanceType.tp_name = "pfsp.Instance";
+    InstanceType.tp_basicsize = sizeof(InstanceObject);
+    InstanceType.tp_dealloc = instanceDealloc;
+    InstanceType.tp_flags = Py_TPFLAGS_DEFAULT;
+    InstanceType.tp_doc = "Instance(path, setup_storage='narrow') - text or binary instance file";
+    InstanceType.tp_methods = instanceMethods;
+    InstanceType.tp_getset = instanceGetSet;
+    InstanceType.tp_init = instanceInit;
+    InstanceType.tp_new = PyType_GenericNew;
+
+    if (PyType_Ready(&ArrayType) < 0 || PyType_Ready(&InstanceType) < 0)
+        return nullptr;
+    PyObject *module = PyModule_Create(&moduleDef);
+    if (!module)
+        return nullptr;
+    Py_INCREF(&InstanceType);
+    if (PyModule_AddObject(module, "Instance", (PyObject *)&InstanceType) < 0)
+    {
+        Py_DECREF(&InstanceType);
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
+}